@@ -0,0 +1,519 @@
+#include "WorldGenerator.h"
+#include <algorithm>
+
+using namespace WorldFormat;
+
+namespace {
+
+    // SplitMix64; unlike the <random> distributions it gives the same
+    // sequence with every standard library
+    class Random {
+    public:
+        explicit Random(uint64_t seed) : state(seed) {}
+
+        uint64_t next() {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        // Uniform in [0, bound)
+        uint32_t below(uint32_t bound) {
+            return static_cast<uint32_t>(((next() >> 32) * bound) >> 32);
+        }
+
+        bool chance(double probability) {
+            return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0) < probability;
+        }
+
+    private:
+        uint64_t state;
+    };
+
+    template <size_t N>
+    uint32_t PickIndex(Random& random, const char* const (&)[N]) {
+        return random.below(static_cast<uint32_t>(N));
+    }
+
+    // ===== WORD LISTS =====
+    // Names must not clash with the ones the game reacts to (lantern, potion,
+    // forge, altar, the fragments and the stock NPCs)
+
+    const char* const ROOM_ADJECTIVES[] = {
+        "Dusty", "Flooded", "Silent", "Crumbling", "Echoing", "Mossy", "Frozen", "Gilded",
+        "Narrow", "Vaulted", "Smoky", "Forgotten", "Windswept", "Sunken", "Hollow", "Overgrown"
+    };
+
+    const char* const ROOM_NOUNS[] = {
+        "Hall", "Cellar", "Gallery", "Chapel", "Library", "Armory", "Crypt", "Garden",
+        "Courtyard", "Kitchen", "Barracks", "Cistern", "Observatory", "Storeroom", "Passage", "Well"
+    };
+
+    // Second sentence of a room description, by noun
+    const char* const ROOM_DETAILS[] = {
+        "Banners too faded to read hang from the rafters.",
+        "Barrels and broken shelves line the damp walls.",
+        "Empty frames stare down from every wall.",
+        "Rows of pews face a bare stone table.",
+        "Shelves of rotting books lean against each other.",
+        "Racks that once held weapons stand empty.",
+        "Stone coffins rest in niches along the walls.",
+        "Thorny hedges have grown over the old paths.",
+        "Weeds push up between the flagstones.",
+        "A cold hearth is heaped with ashes.",
+        "Bunks are stacked three high under a low ceiling.",
+        "Black water laps at a narrow ledge.",
+        "A great brass telescope points at a cracked dome.",
+        "Crates are piled up to the ceiling.",
+        "The walls are close enough to touch on both sides.",
+        "A rope disappears into the darkness below."
+    };
+
+    const char* const ITEM_ADJECTIVES[] = {
+        "old", "cracked", "dented", "tarnished", "faded", "chipped", "heavy", "tiny"
+    };
+
+    const char* const ITEM_NOUNS[] = {
+        "coin", "goblet", "candle", "book", "dagger", "bottle", "skull", "helmet",
+        "rope", "bowl", "mirror", "flute"
+    };
+
+    const char* const CONTAINER_NOUNS[] = { "chest", "crate", "sack", "basket" };
+
+    const char* const FIXED_NAMES[] = { "statue", "fountain", "tapestry", "pillar" };
+
+    const char* const FIXED_DESCRIPTIONS[] = {
+        "A weathered statue of a forgotten king.",
+        "A dry fountain choked with leaves.",
+        "A moth-eaten tapestry showing a battle.",
+        "A carved pillar holding up the ceiling."
+    };
+
+    const char* const KEY_MATERIALS[] = {
+        "iron", "brass", "copper", "silver", "bronze", "bone", "glass", "jade",
+        "obsidian", "ivory", "crystal", "pewter", "tin", "oak", "ebony", "coral"
+    };
+
+    const char* const KEY_FORMS[] = { "key", "sigil", "token" };
+
+    const char* const NPC_NAMES[] = {
+        "Wandering Merchant", "Old Miner", "Hooded Stranger", "Lost Pilgrim",
+        "Weary Guard", "Traveling Bard", "Scavenger", "Herbalist"
+    };
+
+    const char* const NPC_DESCRIPTIONS[] = {
+        "A stooped figure with a pack full of trinkets",
+        "A grizzled old man covered in dust",
+        "Someone whose face stays hidden in shadow",
+        "A tired traveler clutching a walking stick",
+        "A guard leaning heavily on a spear",
+        "A cheerful musician with a battered lute",
+        "A wiry figure picking through the rubble",
+        "A woman with bundles of dried plants at her belt"
+    };
+
+    const char* const NPC_LINES[] = {
+        "These halls go on forever. I stopped counting the doors long ago.",
+        "Keys turn up in the strangest places. Look everywhere.",
+        "The temple lies somewhere deep in here, past more locks than I can open.",
+        "Do not wander into the dark without light.",
+        "I heard the tower still stands. Few who climb it come back.",
+        "Have you seen a red gem? No? Neither have I.",
+        "Every door here was locked by someone with a reason.",
+        "The curse is strongest in the quiet rooms.",
+        "I trade in stories. Tell me one of yours sometime.",
+        "Mind your step, the floors are not what they were."
+    };
+
+    const char* const DIRECTION_PASSAGES[] = {
+        "north passage", "south passage", "east passage", "west passage", "stairs up", "stairs down"
+    };
+
+    // ===== LAYOUT =====
+
+    constexpr int DIRECTIONS = DIRECTION_COUNT;
+    constexpr uint8_t ALL_DIRECTIONS = (1u << DIRECTIONS) - 1;
+
+    // Directions come in pairs (north/south, east/west, up/down)
+    int Opposite(int direction) {
+        return direction ^ 1;
+    }
+
+    // The directions whose opposite is set in 'used'
+    uint8_t Mirrored(uint8_t used) {
+        return static_cast<uint8_t>(((used & 0x15) << 1) | ((used & 0x2A) >> 1));
+    }
+
+    // Rooms with their exits, items and NPCs must fit the game's 24-bit entity handles
+    constexpr uint32_t MAX_ROOMS = 1u << 21;
+
+    struct RoomPlan {
+        uint32_t parent = NONE;     // Room it was joined to
+        uint32_t depth = 0;         // Exits from the starting room along the tree
+        int32_t lock = -1;          // Lock on the exit from the parent
+        int32_t zone = -1;          // Last lock on the way from the starting room
+        uint8_t parentDirection = 0;
+        uint8_t usedDirections = 0;
+        bool hasChildren = false;
+        bool dark = false;
+        bool needed = false;        // Holds a key or a quest item
+    };
+
+    struct ExitPlan {
+        uint32_t source;
+        uint32_t destination;
+        uint8_t direction;
+        int32_t lock;
+    };
+
+    struct LockPlan {
+        uint32_t room;              // The locked exit leads from here to 'child'
+        uint32_t child;
+        uint32_t keyRoom;
+    };
+
+    std::string KeyName(uint32_t lock) {
+        const size_t materials = sizeof(KEY_MATERIALS) / sizeof(KEY_MATERIALS[0]);
+        return std::string(KEY_MATERIALS[lock % materials]) + " " + KEY_FORMS[lock / materials];
+    }
+
+    // Random direction set in 'free', which must not be empty
+    int PickDirection(Random& random, uint8_t free) {
+        int count = 0;
+        for (int d = 0; d < DIRECTIONS; d++) {
+            count += (free >> d) & 1;
+        }
+        uint32_t pick = random.below(static_cast<uint32_t>(count));
+        for (int d = 0; d < DIRECTIONS; d++) {
+            if (((free >> d) & 1) != 0 && pick-- == 0) {
+                return d;
+            }
+        }
+        return 0;
+    }
+}
+
+bool WorldGenerator::Check(const Options& options, std::string& error) {
+    if (options.rooms < 3) {
+        error = "a generated world needs at least 3 rooms";
+    }
+    else if (options.rooms > MAX_ROOMS) {
+        error = "too many rooms";
+    }
+    else if (options.exitsPerRoom < 0.0 || options.exitsPerRoom > DIRECTIONS) {
+        error = "exits per room must be between 0 and " + std::to_string(DIRECTIONS);
+    }
+    else if (options.locks > MAX_LOCKS || options.locks >= options.rooms) {
+        error = "at most " + std::to_string(MAX_LOCKS) + " locks, and fewer than there are rooms";
+    }
+    else if (options.darkShare < 0.0 || options.darkShare > 1.0 ||
+        options.containerShare < 0.0 || options.containerShare > 1.0 ||
+        options.wanderShare < 0.0 || options.wanderShare > 1.0) {
+        error = "shares must be between 0 and 1";
+    }
+    else if (options.itemsPerRoom < 0.0 || options.npcsPerRoom < 0.0) {
+        error = "items and NPCs per room cannot be negative";
+    }
+    else {
+        return true;
+    }
+    return false;
+}
+
+WorldGenerator::WorldGenerator(const Options& options) :
+    options(options),
+    lockCount(0),
+    darkRoomCount(0) {
+}
+
+void WorldGenerator::Generate(WorldImageWriter& writer) {
+    Random random(options.seed);
+    const uint32_t roomCount = options.rooms;
+    std::vector<RoomPlan> rooms(roomCount);
+    std::vector<ExitPlan> exits;
+    std::vector<LockPlan> locks;
+    exits.reserve(static_cast<size_t>(std::max(2.0, options.exitsPerRoom) * roomCount) + 2);
+
+    // ===== SPANNING TREE =====
+    // Each new room hangs off an earlier one. Locks are chosen as rooms are
+    // added and their keys go to rooms that already exist, which can all be
+    // reached with the keys of earlier locks.
+    uint32_t locksLeft = options.locks;
+    for (uint32_t room = 1; room < roomCount; room++) {
+        uint32_t parent = room - 1;     // Has no children yet, so has free directions
+        for (int attempt = 0; attempt < 8; attempt++) {
+            uint32_t candidate = random.below(room);
+            if (rooms[candidate].usedDirections != ALL_DIRECTIONS) {
+                parent = candidate;
+                break;
+            }
+        }
+
+        int direction = PickDirection(random, static_cast<uint8_t>(~rooms[parent].usedDirections & ALL_DIRECTIONS));
+        rooms[parent].usedDirections |= 1u << direction;
+        rooms[parent].hasChildren = true;
+
+        RoomPlan& plan = rooms[room];
+        plan.parent = parent;
+        plan.depth = rooms[parent].depth + 1;
+        plan.parentDirection = static_cast<uint8_t>(direction);
+        plan.usedDirections = static_cast<uint8_t>(1u << Opposite(direction));
+        plan.zone = rooms[parent].zone;
+
+        // Selection sampling: exactly 'locks' of the remaining rooms get one
+        if (locksLeft > 0 && random.chance(static_cast<double>(locksLeft) / (roomCount - room))) {
+            uint32_t keyRoom = random.below(room);
+            rooms[keyRoom].needed = true;
+            plan.lock = plan.zone = static_cast<int32_t>(locks.size());
+            locks.push_back(LockPlan{ parent, room, keyRoom });
+            locksLeft--;
+        }
+
+        exits.push_back(ExitPlan{ parent, room, static_cast<uint8_t>(direction), plan.lock });
+        exits.push_back(ExitPlan{ room, parent, static_cast<uint8_t>(Opposite(direction)), -1 });
+    }
+    lockCount = locks.size();
+
+    // ===== QUEST ROOMS =====
+    const uint32_t start = 0;
+    const uint32_t temple = 1 + random.below(roomCount - 1);
+    uint32_t tower = 1 + random.below(roomCount - 2);
+    if (tower >= temple) {
+        tower++;
+    }
+    uint32_t fragmentRooms[3];
+    for (uint32_t& room : fragmentRooms) {
+        room = random.below(roomCount);
+        rooms[room].needed = true;
+    }
+    rooms[start].needed = rooms[temple].needed = rooms[tower].needed = true;
+
+    // ===== EXTRA EXITS =====
+    // Between random rooms with matching free directions. An exit into
+    // another lock's zone needs that lock's key, so it is no shortcut.
+    size_t wanted = static_cast<size_t>(options.exitsPerRoom * roomCount);
+    size_t extraPairs = wanted > exits.size() ? (wanted - exits.size()) / 2 : 0;
+    for (size_t pair = 0; pair < extraPairs; pair++) {
+        for (int attempt = 0; attempt < 4; attempt++) {
+            uint32_t a = random.below(roomCount);
+            uint32_t b = random.below(roomCount);
+            uint8_t free = static_cast<uint8_t>(~rooms[a].usedDirections & ~Mirrored(rooms[b].usedDirections) & ALL_DIRECTIONS);
+            if (a == b || free == 0) {
+                continue;
+            }
+
+            int32_t lockAB = rooms[b].zone != rooms[a].zone ? rooms[b].zone : -1;
+            int32_t lockBA = rooms[a].zone != rooms[b].zone ? rooms[a].zone : -1;
+            // 'use' opens the first matching exit of a room, which must stay the tree exit
+            if ((lockAB >= 0 && locks[lockAB].room == a) || (lockBA >= 0 && locks[lockBA].room == b)) {
+                continue;
+            }
+
+            int direction = PickDirection(random, free);
+            rooms[a].usedDirections |= 1u << direction;
+            rooms[b].usedDirections |= 1u << Opposite(direction);
+            exits.push_back(ExitPlan{ a, b, static_cast<uint8_t>(direction), lockAB });
+            exits.push_back(ExitPlan{ b, a, static_cast<uint8_t>(Opposite(direction)), lockBA });
+            break;
+        }
+    }
+
+    // ===== DARK ROOMS =====
+    // Only dead ends of the tree holding nothing needed, so no walk through
+    // the world has to cross the dark
+    uint32_t eligible = 0;
+    for (const RoomPlan& room : rooms) {
+        eligible += !room.hasChildren && !room.needed ? 1 : 0;
+    }
+    uint32_t darkLeft = std::min(eligible, static_cast<uint32_t>(options.darkShare * roomCount));
+    for (RoomPlan& room : rooms) {
+        if (room.hasChildren || room.needed) {
+            continue;
+        }
+        if (darkLeft > 0 && random.chance(static_cast<double>(darkLeft) / eligible)) {
+            room.dark = true;
+            darkLeft--;
+            darkRoomCount++;
+        }
+        eligible--;
+    }
+
+    // ===== WRITE ROOMS AND EXITS =====
+    std::vector<std::string> roomNames;
+    std::vector<std::string> roomDescriptions;
+    const size_t nouns = sizeof(ROOM_NOUNS) / sizeof(ROOM_NOUNS[0]);
+    for (const char* adjective : ROOM_ADJECTIVES) {
+        for (size_t noun = 0; noun < nouns; noun++) {
+            std::string lowered = std::string(adjective) + " " + ROOM_NOUNS[noun];
+            for (char& c : lowered) {
+                c = static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+            }
+            roomNames.push_back(std::string(adjective) + " " + ROOM_NOUNS[noun]);
+            roomDescriptions.push_back("You stand in the " + lowered + ". " + ROOM_DETAILS[noun]);
+        }
+    }
+
+    for (uint32_t room = 0; room < roomCount; room++) {
+        if (room == start) {
+            writer.addRoom("Village of Eldoria",
+                "The village where your search begins. Paths lead away in every direction.", false);
+        }
+        else if (room == temple) {
+            writer.addRoom("Ruined Temple",
+                "Crumbling pillars surround an ancient forge carved with three gem-shaped depressions.", false);
+        }
+        else if (room == tower) {
+            writer.addRoom("Sorcerer's Tower",
+                "The air hums with dark energy around a cracked obsidian altar.", false);
+        }
+        else {
+            uint32_t name = random.below(static_cast<uint32_t>(roomNames.size()));
+            writer.addRoom(roomNames[name], roomDescriptions[name], rooms[room].dark);
+        }
+    }
+    writer.setStartRoom(start);
+
+    for (const ExitPlan& exit : exits) {
+        Direction direction = static_cast<Direction>(exit.direction);
+        if (exit.lock >= 0) {
+            std::string key = KeyName(static_cast<uint32_t>(exit.lock));
+            writer.addExit(exit.source, exit.destination, direction, "heavy door",
+                "A heavy door with a lock that needs the " + key, key);
+        }
+        else {
+            writer.addExit(exit.source, exit.destination, direction, DIRECTION_PASSAGES[exit.direction],
+                "A worn way leading " + directionToString(direction), "");
+        }
+    }
+
+    // ===== WRITE ITEMS =====
+    writer.addItem("backpack", "A sturdy leather pack with room for plenty of finds.",
+        start, NONE, ITEM_CONTAINER, 5);
+    writer.addItem("lantern", "A brass lantern with a little oil left.", start, NONE, 0, 0);
+    for (uint32_t lock = 0; lock < locks.size(); lock++) {
+        writer.addItem(KeyName(lock), "It must open a door somewhere.", locks[lock].keyRoom, NONE, 0, 0);
+    }
+    writer.addItem("amethyst", "A jagged purple shard humming with arcane energy.",
+        fragmentRooms[0], NONE, ITEM_FRAGMENT, 0);
+    writer.addItem("sapphire", "A smooth blue fragment encased in ice that never melts.",
+        fragmentRooms[1], NONE, ITEM_FRAGMENT, 0);
+    writer.addItem("ruby", "A blood-red sliver that burns like embers.",
+        fragmentRooms[2], NONE, ITEM_FRAGMENT, 0);
+    writer.addItem("forge", "An ancient stone forge with three depressions shaped like gems.",
+        temple, NONE, ITEM_FIXED, 0);
+    writer.addItem("altar", "The cursed altar, waiting for the restored amulet.",
+        tower, NONE, ITEM_FIXED, 0);
+
+    auto looseItemName = [&]() {
+        return std::string(ITEM_ADJECTIVES[PickIndex(random, ITEM_ADJECTIVES)]) + " "
+            + ITEM_NOUNS[PickIndex(random, ITEM_NOUNS)];
+    };
+
+    size_t looseItems = static_cast<size_t>(options.itemsPerRoom * roomCount);
+    for (size_t i = 0; i < looseItems; i++) {
+        uint32_t room = random.below(roomCount);
+        if (random.chance(options.containerShare)) {
+            int capacity = 3 + static_cast<int>(random.below(3));
+            std::string name = std::string(ITEM_ADJECTIVES[PickIndex(random, ITEM_ADJECTIVES)]) + " "
+                + CONTAINER_NOUNS[PickIndex(random, CONTAINER_NOUNS)];
+            uint32_t container = writer.addItem(name, "Something might be inside.",
+                room, NONE, ITEM_CONTAINER, capacity);
+            uint32_t contents = 1 + random.below(static_cast<uint32_t>(capacity));
+            for (uint32_t c = 0; c < contents; c++) {
+                writer.addItem(looseItemName(), "An ordinary thing, left behind long ago.", NONE, container, 0, 0);
+            }
+        }
+        else if (random.chance(0.1)) {
+            uint32_t fixed = PickIndex(random, FIXED_NAMES);
+            writer.addItem(FIXED_NAMES[fixed], FIXED_DESCRIPTIONS[fixed], room, NONE, ITEM_FIXED, 0);
+        }
+        else {
+            writer.addItem(looseItemName(), "An ordinary thing, left behind long ago.", room, NONE, 0, 0);
+        }
+    }
+
+    // ===== WRITE NPCs =====
+    size_t npcCount = static_cast<size_t>(options.npcsPerRoom * roomCount);
+    for (size_t i = 0; i < npcCount; i++) {
+        uint32_t kind = PickIndex(random, NPC_NAMES);
+        uint32_t flags = random.chance(0.2) ? NPC_ENEMY : 0;
+        uint32_t npc = writer.addNpc(NPC_NAMES[kind], NPC_DESCRIPTIONS[kind], random.below(roomCount), flags);
+
+        for (int line = 0; line < 3; line++) {
+            writer.addDialogue(npc, NPC_LINES[PickIndex(random, NPC_LINES)]);
+        }
+        writer.addResponse(npc, "help", "Thank you, friend. May your path stay lit.");
+        writer.addResponse(npc, "attack", "You will regret raising a hand against me!");
+        if (random.chance(0.15)) {
+            writer.setInteraction(npc, looseItemName(), "silver coin");
+        }
+        // No draws without wanderers, so older seeds give the same worlds
+        if (options.wanderShare > 0.0 && random.chance(options.wanderShare)) {
+            writer.setBehavior(npc, NpcBehavior::WANDER, 1 + random.below(3), std::string_view());
+        }
+    }
+
+    // ===== WALKTHROUGH =====
+    // The locks between the start and every quest room, then those between
+    // the start and the keys of those locks
+    std::vector<bool> neededLocks(locks.size(), false);
+    std::vector<uint32_t> targets = { temple, tower, fragmentRooms[0], fragmentRooms[1], fragmentRooms[2] };
+    while (!targets.empty()) {
+        uint32_t room = targets.back();
+        targets.pop_back();
+        for (; room != start; room = rooms[room].parent) {
+            int32_t lock = rooms[room].lock;
+            if (lock >= 0 && !neededLocks[lock]) {
+                neededLocks[lock] = true;
+                targets.push_back(locks[lock].keyRoom);
+            }
+        }
+    }
+
+    // Walks along the tree: up to the common ancestor, then down. Every lock
+    // on the way was opened before, since keys lie behind earlier locks only.
+    uint32_t current = start;
+    auto walkTo = [&](uint32_t target) {
+        std::vector<std::string> down;
+        uint32_t from = current;
+        uint32_t to = target;
+        while (from != to) {
+            if (rooms[from].depth >= rooms[to].depth) {
+                walkthrough.push_back("go " + directionToString(static_cast<Direction>(Opposite(rooms[from].parentDirection))));
+                from = rooms[from].parent;
+            }
+            else {
+                down.push_back("go " + directionToString(static_cast<Direction>(rooms[to].parentDirection)));
+                to = rooms[to].parent;
+            }
+        }
+        walkthrough.insert(walkthrough.end(), down.rbegin(), down.rend());
+        current = target;
+    };
+
+    walkthrough.clear();
+    walkthrough.push_back("take backpack");
+    for (uint32_t lock = 0; lock < locks.size(); lock++) {
+        if (!neededLocks[lock]) {
+            continue;
+        }
+        std::string key = KeyName(lock);
+        walkTo(locks[lock].keyRoom);
+        walkthrough.push_back("take " + key);
+        walkTo(locks[lock].room);
+        walkthrough.push_back("use " + key);
+        walkthrough.push_back("drop " + key);
+    }
+
+    const char* fragments[] = { "amethyst", "sapphire", "ruby" };
+    for (int i = 0; i < 3; i++) {
+        walkTo(fragmentRooms[i]);
+        walkthrough.push_back(std::string("take ") + fragments[i]);
+    }
+    walkTo(temple);
+    walkthrough.push_back("combine amulet");
+    walkTo(tower);
+    walkthrough.push_back("place amulet");
+    walkthrough.push_back("1");
+}
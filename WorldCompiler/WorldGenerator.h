@@ -0,0 +1,61 @@
+#pragma once
+#include "WorldImageWriter.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Seeded generator of large worlds for benchmarks and soak tests.
+ *
+ * Rooms are added one at a time, each joined to a random earlier room, so
+ * they form a tree rooted at the starting room; extra exits between random
+ * rooms are added afterwards up to the requested exit count. Some tree
+ * exits are locked, and each key is left in a room that existed before its
+ * lock, so every room can be reached with the keys found on the way.
+ * Dark rooms are dead ends holding nothing the quest needs. The temple
+ * (with its forge), the tower (with its altar) and the three fragments are
+ * in lit rooms, so every generated world can be won, and the generator
+ * writes out the commands that win it.
+ *
+ * Names come from small word lists, so a world of millions of entities
+ * still has only a few hundred distinct names and strings. The same seed
+ * and options give the same world on every platform.
+ */
+class WorldGenerator {
+public:
+    // Locks are limited by the number of distinct key names
+    static constexpr uint32_t MAX_LOCKS = 48;
+
+    struct Options {
+        uint64_t seed = 1;
+        uint32_t rooms = 100;
+        double exitsPerRoom = 3.0;      // Average exits leaving a room, 2 to 6
+        uint32_t locks = 8;             // Locked exits, each with its own key
+        double darkShare = 0.1;         // Share of rooms that are dark
+        double itemsPerRoom = 1.0;      // Loose items, not counting quest items and keys
+        double containerShare = 0.1;    // Share of those items that are containers
+        double npcsPerRoom = 0.1;
+        double wanderShare = 0.0;       // Share of NPCs that wander every 1 to 3 turns
+    };
+
+    // Rejects options that cannot give a winnable world
+    static bool Check(const Options& options, std::string& error);
+
+    explicit WorldGenerator(const Options& options);
+
+    // Adds the world to an image; the options must have passed Check()
+    void Generate(WorldImageWriter& writer);
+
+    // Commands that win the generated world, one per line
+    const std::vector<std::string>& getWalkthrough() const { return walkthrough; }
+
+    size_t getLockCount() const { return lockCount; }
+    size_t getDarkRoomCount() const { return darkRoomCount; }
+
+private:
+    Options options;
+    std::vector<std::string> walkthrough;
+    size_t lockCount;
+    size_t darkRoomCount;
+};
@@ -0,0 +1,922 @@
+#include "WorldSource.h"
+#include "DialogueGraph.h"
+#include "MappedFile.h"
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <set>
+#include <string_view>
+#include <unordered_set>
+
+namespace {
+
+    std::string Lower(const std::string& text) {
+        std::string lower(text);
+        for (char& c : lower) {
+            if (c >= 'A' && c <= 'Z') {
+                c = static_cast<char>(c + ('a' - 'A'));
+            }
+        }
+        return lower;
+    }
+
+    std::string Quoted(const std::string& text) {
+        return "'" + text + "'";
+    }
+
+    // DialogueCondition from its source word ("has", "trusted", ...), false if unknown
+    bool ParseCondition(const std::string& word, DialogueCondition& condition) {
+        for (int i = 0; i < DIALOGUE_CONDITION_COUNT; i++) {
+            if (dialogueConditionToString(static_cast<DialogueCondition>(i)) == word) {
+                condition = static_cast<DialogueCondition>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ParseBehavior(const std::string& word, NpcBehavior& behavior) {
+        for (int i = 0; i < NPC_BEHAVIOR_COUNT; i++) {
+            if (npcBehaviorToString(static_cast<NpcBehavior>(i)) == word) {
+                behavior = static_cast<NpcBehavior>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+bool ParseDirection(const std::string& name, Direction& direction) {
+    static const Direction directions[] = {
+        Direction::NORTH, Direction::SOUTH, Direction::EAST,
+        Direction::WEST, Direction::UP, Direction::DOWN
+    };
+    for (Direction candidate : directions) {
+        if (directionToString(candidate) == Lower(name)) {
+            direction = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ========== Parsing ==========
+
+/**
+ * Recursive-descent reader for the world source format.
+ * Tokens are words, strings (adjacent strings joined), '{' and '}'.
+ */
+class SourceParser {
+public:
+    SourceParser(std::string_view text, WorldSource& world) :
+        text(text), position(0), line(1), world(world) {
+    }
+
+    bool Parse(std::vector<WorldSource::Problem>& errors) {
+        problems = &errors;
+        if (!Advance()) {
+            return false;
+        }
+
+        while (current.type != TokenType::END) {
+            if (current.type != TokenType::WORD) {
+                return Fail("expected a declaration (start, room, exit, item or npc)");
+            }
+
+            std::string keyword = current.text;
+            int declarationLine = current.line;
+            if (!Advance()) {
+                return false;
+            }
+
+            bool parsed;
+            if (keyword == "start") {
+                world.startLine = declarationLine;
+                parsed = ReadString(world.start);
+            }
+            else if (keyword == "room") {
+                parsed = ParseRoom(declarationLine);
+            }
+            else if (keyword == "exit") {
+                parsed = ParseExit(declarationLine);
+            }
+            else if (keyword == "item") {
+                parsed = ParseItem(declarationLine);
+            }
+            else if (keyword == "npc") {
+                parsed = ParseNpc(declarationLine);
+            }
+            else {
+                return Fail("unknown declaration " + Quoted(keyword), declarationLine);
+            }
+
+            if (!parsed) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    enum class TokenType { WORD, STRING, OPEN, CLOSE, END };
+
+    struct Token {
+        TokenType type = TokenType::END;
+        std::string text;
+        int line = 0;
+    };
+
+    std::string_view text;
+    size_t position;
+    int line;
+    Token current;
+    WorldSource& world;
+    std::vector<WorldSource::Problem>* problems = nullptr;
+
+    bool Fail(const std::string& message, int atLine = 0) {
+        problems->push_back({ atLine != 0 ? atLine : current.line, message });
+        return false;
+    }
+
+    // ----- Lexer -----
+
+    void SkipSpaceAndComments() {
+        while (position < text.size()) {
+            char c = text[position];
+            if (c == '\n') {
+                line++;
+                position++;
+            }
+            else if (c == ' ' || c == '\t' || c == '\r') {
+                position++;
+            }
+            else if (c == '#') {
+                while (position < text.size() && text[position] != '\n') {
+                    position++;
+                }
+            }
+            else {
+                return;
+            }
+        }
+    }
+
+    bool ReadQuoted(std::string& out) {
+        int startLine = line;
+        position++; // Opening quote
+        while (position < text.size()) {
+            char c = text[position++];
+            if (c == '"') {
+                return true;
+            }
+            if (c == '\n') {
+                line++;
+            }
+            if (c == '\\' && position < text.size()) {
+                char escaped = text[position++];
+                switch (escaped) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                default:
+                    return Fail(std::string("unknown escape \\") + escaped, line);
+                }
+                continue;
+            }
+            out += c;
+        }
+        return Fail("unterminated string", startLine);
+    }
+
+    bool Advance() {
+        SkipSpaceAndComments();
+        current = Token();
+        current.line = line;
+
+        if (position >= text.size()) {
+            current.type = TokenType::END;
+            return true;
+        }
+
+        char c = text[position];
+        if (c == '{' || c == '}') {
+            current.type = c == '{' ? TokenType::OPEN : TokenType::CLOSE;
+            position++;
+            return true;
+        }
+
+        if (c == '"') {
+            // Adjacent strings form one, so long text can span lines
+            current.type = TokenType::STRING;
+            do {
+                if (!ReadQuoted(current.text)) {
+                    return false;
+                }
+                SkipSpaceAndComments();
+            } while (position < text.size() && text[position] == '"');
+            return true;
+        }
+
+        current.type = TokenType::WORD;
+        while (position < text.size()) {
+            c = text[position];
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '{' || c == '}' || c == '"' || c == '#') {
+                break;
+            }
+            current.text += c;
+            position++;
+        }
+        return true;
+    }
+
+    // ----- Grammar -----
+
+    bool ReadString(std::string& out) {
+        if (current.type != TokenType::STRING) {
+            return Fail("expected a quoted string");
+        }
+        out = current.text;
+        return Advance();
+    }
+
+    bool ReadWord(std::string& out) {
+        if (current.type != TokenType::WORD) {
+            return Fail("expected a word");
+        }
+        out = current.text;
+        return Advance();
+    }
+
+    bool ReadArrow(const std::string& after) {
+        if (current.type != TokenType::WORD || current.text != "->") {
+            return Fail("expected '->' after " + Quoted(after));
+        }
+        return Advance();
+    }
+
+    // "<first>" -> "<second>"; the arrow keeps the two strings from being joined
+    bool ReadPair(std::string& first, std::string& second) {
+        return ReadString(first) && ReadArrow(first) && ReadString(second);
+    }
+
+    bool ReadNumber(int& out) {
+        std::string word;
+        int numberLine = current.line;
+        if (!ReadWord(word)) {
+            return false;
+        }
+        char* end = nullptr;
+        long value = std::strtol(word.c_str(), &end, 10);
+        if (word.empty() || *end != '\0' || value < 0 || value > 1000000) {
+            return Fail("expected a number, got " + Quoted(word), numberLine);
+        }
+        out = static_cast<int>(value);
+        return true;
+    }
+
+    // A number that may be negative, with an optional sign
+    bool ReadSignedNumber(int& out) {
+        std::string word;
+        int numberLine = current.line;
+        if (!ReadWord(word)) {
+            return false;
+        }
+        char* end = nullptr;
+        long value = std::strtol(word.c_str(), &end, 10);
+        if (word.empty() || *end != '\0' || value < -1000000 || value > 1000000) {
+            return Fail("expected a number, got " + Quoted(word), numberLine);
+        }
+        out = static_cast<int>(value);
+        return true;
+    }
+
+    // Reads "<name> {" then hands each property to 'property' until "}";
+    // only the keys in 'repeatable' may be given more than once
+    bool ParseBlock(std::string& name, const std::set<std::string>& repeatable,
+        const std::function<bool(const std::string&, int)>& property) {
+        if (!ReadString(name)) {
+            return false;
+        }
+        if (current.type != TokenType::OPEN) {
+            return Fail("expected '{' after " + Quoted(name));
+        }
+        if (!Advance()) {
+            return false;
+        }
+
+        std::set<std::string> seen;
+        while (current.type != TokenType::CLOSE) {
+            if (current.type == TokenType::END) {
+                return Fail("missing '}' to close " + Quoted(name));
+            }
+            std::string key;
+            int keyLine = current.line;
+            if (!ReadWord(key)) {
+                return false;
+            }
+
+            if (repeatable.count(key) == 0 && !seen.insert(key).second) {
+                return Fail(Quoted(key) + " given twice for " + Quoted(name), keyLine);
+            }
+            if (!property(key, keyLine)) {
+                return false;
+            }
+        }
+        return Advance();
+    }
+
+    bool UnknownProperty(const std::string& key, int keyLine, const char* what) {
+        return Fail("unknown " + std::string(what) + " property " + Quoted(key), keyLine);
+    }
+
+    bool ParseRoom(int declarationLine) {
+        WorldSource::RoomDef room;
+        room.line = declarationLine;
+        bool parsed = ParseBlock(room.name, {}, [&](const std::string& key, int keyLine) {
+            if (key == "description") {
+                return ReadString(room.description);
+            }
+            if (key == "dark") {
+                room.dark = true;
+                return true;
+            }
+            return UnknownProperty(key, keyLine, "room");
+        });
+        world.rooms.push_back(std::move(room));
+        return parsed;
+    }
+
+    bool ParseExit(int declarationLine) {
+        WorldSource::ExitDef exit;
+        exit.line = declarationLine;
+        bool parsed = ParseBlock(exit.name, {}, [&](const std::string& key, int keyLine) {
+            if (key == "from") {
+                return ReadString(exit.from);
+            }
+            if (key == "to") {
+                return ReadString(exit.to);
+            }
+            if (key == "direction") {
+                return ReadWord(exit.directionName);
+            }
+            if (key == "description") {
+                return ReadString(exit.description);
+            }
+            if (key == "key") {
+                return ReadString(exit.key);
+            }
+            return UnknownProperty(key, keyLine, "exit");
+        });
+        world.exits.push_back(std::move(exit));
+        return parsed;
+    }
+
+    bool ParseItem(int declarationLine) {
+        WorldSource::ItemDef item;
+        item.line = declarationLine;
+        bool parsed = ParseBlock(item.name, {}, [&](const std::string& key, int keyLine) {
+            if (key == "in") {
+                return ReadString(item.room);
+            }
+            if (key == "inside") {
+                return ReadString(item.container);
+            }
+            if (key == "description") {
+                return ReadString(item.description);
+            }
+            if (key == "container") {
+                item.isContainer = true;
+                return ReadNumber(item.capacity);
+            }
+            if (key == "fragment") {
+                item.fragment = true;
+                return true;
+            }
+            if (key == "fixed") {
+                item.fixed = true;
+                return true;
+            }
+            return UnknownProperty(key, keyLine, "item");
+        });
+        world.items.push_back(std::move(item));
+        return parsed;
+    }
+
+    bool ParseNpc(int declarationLine) {
+        WorldSource::NpcDef npc;
+        npc.line = declarationLine;
+        bool parsed = ParseBlock(npc.name, { "dialogue", "response", "stop", "node" }, [&](const std::string& key, int keyLine) {
+            if (key == "in") {
+                return ReadString(npc.room);
+            }
+            if (key == "description") {
+                return ReadString(npc.description);
+            }
+            if (key == "dialogue") {
+                npc.dialogue.emplace_back();
+                return ReadString(npc.dialogue.back());
+            }
+            if (key == "response") {
+                npc.responses.emplace_back();
+                return ReadPair(npc.responses.back().first, npc.responses.back().second);
+            }
+            if (key == "interaction") {
+                return ReadPair(npc.requiredItem, npc.rewardItem);
+            }
+            if (key == "behavior") {
+                std::string behavior;
+                int behaviorLine = current.line;
+                if (!ReadWord(behavior)) {
+                    return false;
+                }
+                if (!ParseBehavior(behavior, npc.behavior)) {
+                    return Fail("unknown behavior " + Quoted(behavior), behaviorLine);
+                }
+                if (!ReadNumber(npc.period)) {
+                    return false;
+                }
+                return npc.period > 0 || Fail("a behavior needs a period of at least one turn", behaviorLine);
+            }
+            if (key == "stop") {
+                npc.patrolStops.emplace_back();
+                return ReadString(npc.patrolStops.back());
+            }
+            if (key == "announce") {
+                return ReadString(npc.announcement);
+            }
+            if (key == "reward-description") {
+                return ReadString(npc.rewardDescription);
+            }
+            if (key == "node") {
+                return ParseNode(npc, keyLine);
+            }
+            if (key == "enemy") {
+                npc.enemy = true;
+                return true;
+            }
+            if (key == "important-info") {
+                npc.importantInfo = true;
+                return true;
+            }
+            if (key == "no-reinteraction") {
+                npc.preventReinteraction = true;
+                return true;
+            }
+            return UnknownProperty(key, keyLine, "npc");
+        });
+        world.npcs.push_back(std::move(npc));
+        return parsed;
+    }
+
+    bool ParseNode(WorldSource::NpcDef& npc, int declarationLine) {
+        // Effects and edges run in the order given, so they may repeat
+        static const std::set<std::string> repeatable = {
+            "say", "give", "take", "alignment", "trust", "distrust", "reward-given", "end", "talk",
+            "on", "if", "goto"
+        };
+
+        WorldSource::DialogueNodeDef node;
+        node.line = declarationLine;
+        bool parsed = ParseBlock(node.name, repeatable, [&](const std::string& key, int keyLine) {
+            if (key == "ask") {
+                // The question is optional and printed without a line break
+                node.asks = true;
+                return current.type != TokenType::STRING || ReadString(node.question);
+            }
+
+            if (key == "on" || key == "if" || key == "goto") {
+                node.edges.emplace_back();
+                WorldSource::DialogueEdgeDef& edge = node.edges.back();
+                edge.line = keyLine;
+                if (key == "on") {
+                    return ReadPair(edge.answer, edge.target);
+                }
+                if (key == "goto") {
+                    return ReadString(edge.target);
+                }
+
+                std::string condition;
+                int conditionLine = current.line;
+                if (!ReadWord(condition)) {
+                    return false;
+                }
+                if (!ParseCondition(condition, edge.condition)) {
+                    return Fail("unknown condition " + Quoted(condition), conditionLine);
+                }
+                bool argumentRead = true;
+                if (edge.condition == DialogueCondition::HAS_ITEM || edge.condition == DialogueCondition::LACKS_ITEM) {
+                    argumentRead = ReadString(edge.subject);
+                }
+                else if (edge.condition == DialogueCondition::ALIGNMENT_AT_LEAST ||
+                    edge.condition == DialogueCondition::ALIGNMENT_BELOW) {
+                    argumentRead = ReadSignedNumber(edge.value);
+                }
+                return argumentRead && ReadArrow(condition) && ReadString(edge.target);
+            }
+
+            auto effect = [&](DialogueAction action) -> WorldSource::DialogueEffectDef& {
+                node.effects.emplace_back();
+                node.effects.back().action = action;
+                return node.effects.back();
+            };
+            if (key == "say") {
+                return ReadString(effect(DialogueAction::SAY).text);
+            }
+            if (key == "give") {
+                WorldSource::DialogueEffectDef& give = effect(DialogueAction::GIVE_ITEM);
+                return ReadPair(give.subject, give.text);
+            }
+            if (key == "take") {
+                return ReadString(effect(DialogueAction::TAKE_ITEM).subject);
+            }
+            if (key == "alignment") {
+                return ReadSignedNumber(effect(DialogueAction::ALIGNMENT).value);
+            }
+            if (key == "trust" || key == "distrust") {
+                effect(DialogueAction::TRUST).value = key == "trust" ? 1 : 0;
+                return true;
+            }
+            if (key == "reward-given") {
+                effect(DialogueAction::REWARD_GIVEN);
+                return true;
+            }
+            if (key == "end") {
+                effect(DialogueAction::END_INTERACTIONS);
+                return true;
+            }
+            if (key == "talk") {
+                effect(DialogueAction::TALK);
+                return true;
+            }
+            return UnknownProperty(key, keyLine, "node");
+        });
+        npc.nodes.push_back(std::move(node));
+        return parsed;
+    }
+};
+
+bool WorldSource::Load(const std::string& sourcePath, std::vector<Problem>& errors) {
+    path = sourcePath;
+
+    MappedFile file;
+    if (!file.Open(sourcePath)) {
+        errors.push_back({ 0, "cannot open " + sourcePath });
+        return false;
+    }
+
+    SourceParser parser(std::string_view(file.getData(), file.getSize()), *this);
+    return parser.Parse(errors);
+}
+
+// ========== Validation ==========
+
+WorldSource::NameMap WorldSource::RoomsByName() const {
+    NameMap byName;
+    for (size_t i = 0; i < rooms.size(); i++) {
+        byName[Lower(rooms[i].name)].push_back(static_cast<int>(i));
+    }
+    return byName;
+}
+
+WorldSource::NameMap WorldSource::ContainersByName() const {
+    NameMap byName;
+    for (size_t i = 0; i < items.size(); i++) {
+        if (items[i].isContainer) {
+            byName[Lower(items[i].name)].push_back(static_cast<int>(i));
+        }
+    }
+    return byName;
+}
+
+bool WorldSource::Validate(std::vector<Problem>& errors, std::vector<Problem>& warnings) const {
+    size_t errorsBefore = errors.size();
+    NameMap roomsByName = RoomsByName();
+    NameMap containersByName = ContainersByName();
+
+    auto findRoom = [&](const std::string& name) {
+        auto found = roomsByName.find(Lower(name));
+        return found != roomsByName.end() ? found->second.front() : -1;
+    };
+
+    // ----- Rooms -----
+    if (rooms.empty()) {
+        errors.push_back({ 0, "the world has no rooms" });
+        return false;
+    }
+    for (const RoomDef& room : rooms) {
+        if (room.name.empty()) {
+            errors.push_back({ room.line, "room without a name" });
+        }
+        const RoomDef& first = rooms[findRoom(room.name)];
+        if (&first != &room) {
+            errors.push_back({ room.line, "room " + Quoted(room.name) + " already declared on line " + std::to_string(first.line) });
+        }
+    }
+    if (start.empty()) {
+        warnings.push_back({ rooms.front().line, "no start room given, the game starts in " + Quoted(rooms.front().name) });
+    }
+    else if (findRoom(start) < 0) {
+        errors.push_back({ startLine, "start room " + Quoted(start) + " is not declared" });
+    }
+
+    // Names that can open a lock or be handed over: items and NPC rewards
+    std::unordered_set<std::string> obtainable;
+    for (const ItemDef& item : items) {
+        obtainable.insert(Lower(item.name));
+    }
+    for (const NpcDef& npc : npcs) {
+        if (!npc.rewardItem.empty()) {
+            obtainable.insert(Lower(npc.rewardItem));
+        }
+        for (const DialogueNodeDef& node : npc.nodes) {
+            for (const DialogueEffectDef& effect : node.effects) {
+                if (effect.action == DialogueAction::GIVE_ITEM) {
+                    obtainable.insert(Lower(effect.subject));
+                }
+            }
+        }
+    }
+
+    // ----- Exits -----
+    std::set<std::pair<int, int>> usedDirections;
+    for (const ExitDef& exit : exits) {
+        std::string label = "exit " + Quoted(exit.name);
+        int from = findRoom(exit.from);
+        int to = findRoom(exit.to);
+        if (exit.from.empty() || exit.to.empty() || exit.directionName.empty()) {
+            errors.push_back({ exit.line, label + " needs from, to and direction" });
+            continue;
+        }
+        if (from < 0) {
+            errors.push_back({ exit.line, label + " leaves from unknown room " + Quoted(exit.from) });
+        }
+        if (to < 0) {
+            errors.push_back({ exit.line, label + " leads to unknown room " + Quoted(exit.to) });
+        }
+
+        Direction direction;
+        if (!ParseDirection(exit.directionName, direction)) {
+            errors.push_back({ exit.line, label + " has unknown direction " + Quoted(exit.directionName) });
+        }
+        else if (from >= 0 && !usedDirections.insert({ from, static_cast<int>(direction) }).second) {
+            errors.push_back({ exit.line, Quoted(exit.from) + " already has an exit " + exit.directionName });
+        }
+
+        if (!exit.key.empty() && obtainable.count(Lower(exit.key)) == 0) {
+            errors.push_back({ exit.line, label + " needs key " + Quoted(exit.key)
+                + ", which is neither an item nor an NPC reward" });
+        }
+    }
+
+    // ----- Items -----
+    std::vector<int> parentOf(items.size(), -1);
+    for (size_t i = 0; i < items.size(); i++) {
+        const ItemDef& item = items[i];
+        std::string label = "item " + Quoted(item.name);
+        if (item.room.empty() == item.container.empty()) {
+            errors.push_back({ item.line, label + " needs exactly one of 'in' or 'inside'" });
+            continue;
+        }
+        if (!item.room.empty()) {
+            if (findRoom(item.room) < 0) {
+                errors.push_back({ item.line, label + " is in unknown room " + Quoted(item.room) });
+            }
+            continue;
+        }
+
+        auto containers = containersByName.find(Lower(item.container));
+        if (containers == containersByName.end()) {
+            errors.push_back({ item.line, label + " is inside " + Quoted(item.container) + ", which is not a container item" });
+        }
+        else if (containers->second.size() > 1) {
+            errors.push_back({ item.line, label + " is inside " + Quoted(item.container) + ", but several containers have that name" });
+        }
+        else if (containers->second.front() == static_cast<int>(i)) {
+            errors.push_back({ item.line, label + " is inside itself" });
+        }
+        else {
+            parentOf[i] = containers->second.front();
+        }
+    }
+
+    // Every chain of containers has to end in a room
+    for (size_t i = 0; i < items.size(); i++) {
+        int parent = parentOf[i];
+        size_t steps = 0;
+        while (parent >= 0 && steps <= items.size()) {
+            parent = parentOf[parent];
+            steps++;
+        }
+        if (steps > items.size()) {
+            errors.push_back({ items[i].line, "item " + Quoted(items[i].name) + " is part of a container loop" });
+        }
+    }
+
+    std::vector<int> contents(items.size(), 0);
+    for (int parent : parentOf) {
+        if (parent >= 0) {
+            contents[parent]++;
+        }
+    }
+    for (size_t i = 0; i < items.size(); i++) {
+        if (items[i].isContainer && items[i].capacity > 0 && contents[i] > items[i].capacity) {
+            warnings.push_back({ items[i].line, "container " + Quoted(items[i].name) + " starts with more items than its capacity" });
+        }
+    }
+
+    // ----- NPCs -----
+    for (const NpcDef& npc : npcs) {
+        std::string label = "npc " + Quoted(npc.name);
+        if (npc.room.empty() || findRoom(npc.room) < 0) {
+            errors.push_back({ npc.line, label + " is in unknown room " + Quoted(npc.room) });
+        }
+        if (!npc.requiredItem.empty() && obtainable.count(Lower(npc.requiredItem)) == 0) {
+            errors.push_back({ npc.line, label + " wants " + Quoted(npc.requiredItem)
+                + ", which is neither an item nor an NPC reward" });
+        }
+
+        if (npc.behavior == NpcBehavior::PATROL && npc.patrolStops.size() < 2) {
+            errors.push_back({ npc.line, label + " patrols with fewer than two stops" });
+        }
+        else if (npc.behavior != NpcBehavior::PATROL && !npc.patrolStops.empty()) {
+            errors.push_back({ npc.line, label + " has patrol stops but does not patrol" });
+        }
+        for (size_t i = 0; i < npc.patrolStops.size(); i++) {
+            const std::string& stop = npc.patrolStops[i];
+            const std::string& next = npc.patrolStops[(i + 1) % npc.patrolStops.size()];
+            if (findRoom(stop) < 0) {
+                errors.push_back({ npc.line, label + " patrols through unknown room " + Quoted(stop) });
+                continue;
+            }
+            bool joined = false;
+            for (const ExitDef& exit : exits) {
+                joined = joined || (Lower(exit.from) == Lower(stop) && Lower(exit.to) == Lower(next));
+            }
+            if (!joined && findRoom(next) >= 0) {
+                errors.push_back({ npc.line, label + " patrols from " + Quoted(stop) + " to "
+                    + Quoted(next) + ", but no exit joins them" });
+            }
+        }
+        if (!npc.patrolStops.empty() && Lower(npc.patrolStops.front()) != Lower(npc.room)) {
+            warnings.push_back({ npc.line, label + " starts away from its first patrol stop" });
+        }
+        if (!npc.announcement.empty() && npc.period == 0) {
+            warnings.push_back({ npc.line, label + " has an announcement but no behavior to say it" });
+        }
+
+        std::unordered_map<std::string, int> nodeLines;
+        for (const DialogueNodeDef& node : npc.nodes) {
+            if (node.name.empty()) {
+                errors.push_back({ node.line, label + " has a node without a name" });
+            }
+            else if (!nodeLines.emplace(Lower(node.name), node.line).second) {
+                errors.push_back({ node.line, label + " has node " + Quoted(node.name)
+                    + " already declared on line " + std::to_string(nodeLines[Lower(node.name)]) });
+            }
+        }
+        for (const DialogueNodeDef& node : npc.nodes) {
+            for (const DialogueEdgeDef& edge : node.edges) {
+                if (nodeLines.count(Lower(edge.target)) == 0) {
+                    errors.push_back({ edge.line, "node " + Quoted(node.name) + " leads to unknown node "
+                        + Quoted(edge.target) + " of " + label });
+                }
+                if (!edge.answer.empty() && !node.asks) {
+                    errors.push_back({ edge.line, "node " + Quoted(node.name)
+                        + " takes answers but does not ask" });
+                }
+            }
+        }
+    }
+
+    if (errors.size() != errorsBefore) {
+        return false;
+    }
+
+    // ----- Reachability (ignoring locks) -----
+    std::vector<std::vector<int>> neighbours(rooms.size());
+    for (const ExitDef& exit : exits) {
+        neighbours[findRoom(exit.from)].push_back(findRoom(exit.to));
+    }
+    std::vector<bool> reached(rooms.size(), false);
+    std::vector<int> pending{ start.empty() ? 0 : findRoom(start) };
+    reached[pending.front()] = true;
+    while (!pending.empty()) {
+        int room = pending.back();
+        pending.pop_back();
+        for (int next : neighbours[room]) {
+            if (!reached[next]) {
+                reached[next] = true;
+                pending.push_back(next);
+            }
+        }
+    }
+    for (size_t i = 0; i < rooms.size(); i++) {
+        if (!reached[i]) {
+            warnings.push_back({ rooms[i].line, "room " + Quoted(rooms[i].name) + " cannot be reached from the start" });
+        }
+    }
+
+    return true;
+}
+
+// ========== Output ==========
+
+void WorldSource::Emit(WorldImageWriter& writer) const {
+    using namespace WorldFormat;
+
+    NameMap roomsByName = RoomsByName();
+    NameMap containersByName = ContainersByName();
+    auto roomIndex = [&](const std::string& name) {
+        return static_cast<uint32_t>(roomsByName.at(Lower(name)).front());
+    };
+
+    for (const RoomDef& room : rooms) {
+        writer.addRoom(room.name, room.description, room.dark);
+    }
+    writer.setStartRoom(start.empty() ? 0 : roomIndex(start));
+
+    for (const ExitDef& exit : exits) {
+        Direction direction = Direction::NORTH;
+        ParseDirection(exit.directionName, direction);
+        writer.addExit(roomIndex(exit.from), roomIndex(exit.to), direction,
+            exit.name, exit.description, exit.key);
+    }
+
+    // Conversations go in after the exits through DialogueGraph::Save(), as
+    // World::SaveWorld() writes them, so the compiled stock world matches
+    // Zork --export-world byte for byte; each NPC's nodes are numbered
+    // consecutively from its first
+    DialogueGraph conversations;
+    std::deque<std::string> answers;    // Lowercase answers the graph borrows
+    std::vector<uint32_t> firstNodes(npcs.size(), DialogueGraph::NONE);
+    for (size_t n = 0; n < npcs.size(); n++) {
+        if (npcs[n].nodes.empty()) {
+            continue;
+        }
+        uint32_t first = static_cast<uint32_t>(conversations.getNodeCount());
+        std::unordered_map<std::string, uint32_t> nodeIndex;
+        for (size_t i = 0; i < npcs[n].nodes.size(); i++) {
+            nodeIndex.emplace(Lower(npcs[n].nodes[i].name), first + static_cast<uint32_t>(i));
+        }
+        for (const DialogueNodeDef& node : npcs[n].nodes) {
+            conversations.addNode(node.asks, node.question);
+            for (const DialogueEffectDef& effect : node.effects) {
+                conversations.addEffect(DialogueGraph::Effect{ effect.action, effect.value, effect.subject, effect.text });
+            }
+            for (const DialogueEdgeDef& edge : node.edges) {
+                answers.push_back(Lower(edge.answer));
+                conversations.addEdge(DialogueGraph::Edge{ answers.back(), edge.condition, edge.subject, edge.value,
+                    nodeIndex.at(Lower(edge.target)) });
+            }
+        }
+        firstNodes[n] = first;
+    }
+    conversations.Save(writer);
+
+    // Containers are written before their contents, contents in declaration order
+    std::vector<std::vector<int>> children(items.size());
+    std::vector<int> roots;
+    for (size_t i = 0; i < items.size(); i++) {
+        if (items[i].container.empty()) {
+            roots.push_back(static_cast<int>(i));
+        }
+        else {
+            children[containersByName.at(Lower(items[i].container)).front()].push_back(static_cast<int>(i));
+        }
+    }
+
+    std::function<void(int, uint32_t, uint32_t)> emitItem = [&](int index, uint32_t room, uint32_t container) {
+        const ItemDef& item = items[index];
+        uint32_t flags = (item.isContainer ? ITEM_CONTAINER : 0)
+            | (item.fragment ? ITEM_FRAGMENT : 0)
+            | (item.fixed ? ITEM_FIXED : 0);
+        uint32_t record = writer.addItem(item.name, item.description, room, container, flags, item.capacity);
+        for (int child : children[index]) {
+            emitItem(child, NONE, record);
+        }
+    };
+    for (int root : roots) {
+        emitItem(root, roomIndex(items[root].room), NONE);
+    }
+
+    for (size_t n = 0; n < npcs.size(); n++) {
+        const NpcDef& npc = npcs[n];
+        uint32_t flags = (npc.enemy ? NPC_ENEMY : 0)
+            | (npc.importantInfo ? NPC_IMPORTANT_INFO : 0)
+            | (npc.preventReinteraction ? NPC_PREVENT_REINTERACTION : 0);
+        uint32_t record = writer.addNpc(npc.name, npc.description, roomIndex(npc.room), flags);
+        writer.setInteraction(record, npc.requiredItem, npc.rewardItem, npc.rewardDescription);
+        for (const std::string& line : npc.dialogue) {
+            writer.addDialogue(record, line);
+        }
+        for (const auto& response : npc.responses) {
+            writer.addResponse(record, response.first, response.second);
+        }
+        writer.setBehavior(record, npc.behavior, static_cast<uint32_t>(npc.period), npc.announcement);
+        for (const std::string& stop : npc.patrolStops) {
+            writer.addPatrolStop(record, roomIndex(stop));
+        }
+        writer.setDialogueRoot(record, firstNodes[n]);
+    }
+}
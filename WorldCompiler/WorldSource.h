@@ -0,0 +1,192 @@
+#pragma once
+#include "GameEnums.h"
+#include "WorldImageWriter.h"
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * A world described in the editable text format read by the world compiler.
+ *
+ *     # Comments run to the end of the line
+ *     start "Village of Eldoria"
+ *
+ *     room "Village of Eldoria" {
+ *         description "Adjacent strings " "are joined."
+ *         dark
+ *     }
+ *     exit "mine entrance" {
+ *         from "Village of Eldoria"  to "Abandoned Mine"  direction down
+ *         description "A wooden hatch"
+ *         key "rusty key"             # Locked until this key is used
+ *     }
+ *     item "backpack" {
+ *         in "Village of Eldoria"     # Or: inside "<container item>"
+ *         description "A weathered leather pack"
+ *         container 5                 # Capacity; also: fragment, fixed
+ *     }
+ *     npc "Blacksmith" {
+ *         in "Village of Eldoria"
+ *         description "A burly man"
+ *         dialogue "Welcome to Eldoria, traveler."
+ *         interaction "bread" -> "rusty key"  # Wants bread, gives the rusty key
+ *         reward-description "An old iron key"
+ *         response "steal" -> "You try to steal the key..."
+ *         behavior patrol 3                   # Every 3 turns; also: wander, still
+ *         stop "Village of Eldoria"           # Patrol route, from the room it starts in
+ *         stop "Enchanted Forest"
+ *         announce "{npc} hammers at the anvil."
+ *         enemy  important-info  no-reinteraction
+ *         node "start" {                      # The first node starts the conversation
+ *             say "{npc} eyes the bread. (yes/no)"
+ *             ask                             # Waits; may be followed by a question
+ *             on "yes" -> "trade"
+ *             goto "keep"                     # Any other answer
+ *         }
+ *         node "trade" {
+ *             if has "bread" -> "deal"        # The first edge that holds is followed
+ *             goto "talk"
+ *         }
+ *         node "deal" {
+ *             take "bread"
+ *             give "rusty key" -> "An old iron key"
+ *             alignment 1
+ *             reward-given
+ *         }
+ *         ...
+ *     }
+ *
+ * Strings accept the escapes \" \\ \n and \t, and adjacent strings are
+ * joined. Rooms are referred to by name (in any case), containers by the
+ * name of an item declared as a container, dialogue nodes by name within
+ * their NPC.
+ *
+ * Dialogue nodes run their effects in order: say (a line, with {npc} and
+ * {player} replaced by the names), give, take, alignment <n> (negative for
+ * selfish choices), trust, distrust, reward-given, end (no more talking)
+ * and talk (the NPC's usual lines). A node that asks waits for an answer
+ * and follows the first "on" edge with that answer; otherwise it follows
+ * the first "if" edge whose condition holds (has "<item>", lacks "<item>",
+ * alignment-at-least <n>, alignment-below <n>, trusted, distrusted,
+ * reward-pending, reward-given) or a "goto". The conversation ends where
+ * no edge is followed. NPCs without nodes just talk.
+ *
+ * NPCs with a behavior act every so many turns while the player is in
+ * their room or one next to it: a wandering NPC leaves through an unlocked
+ * exit picked at random, a patrolling one walks on to its next stop (each
+ * stop must have an exit to the next, the last one back to the first), a
+ * still one stays. After acting, an NPC in the player's room says its
+ * announcement, if it has one.
+ */
+class WorldSource {
+public:
+    struct Problem {
+        int line;
+        std::string message;
+    };
+
+    // Parses a source file, stopping at the first syntax error
+    bool Load(const std::string& path, std::vector<Problem>& errors);
+
+    // Checks every reference; warnings do not stop compilation
+    bool Validate(std::vector<Problem>& errors, std::vector<Problem>& warnings) const;
+
+    // Adds the world to an image; only valid after Validate() succeeded
+    void Emit(WorldImageWriter& writer) const;
+
+    const std::string& getPath() const { return path; }
+
+private:
+    struct RoomDef {
+        int line = 0;
+        std::string name;
+        std::string description;
+        bool dark = false;
+    };
+
+    struct ExitDef {
+        int line = 0;
+        std::string name;
+        std::string description;
+        std::string from;
+        std::string to;
+        std::string directionName;
+        std::string key;
+    };
+
+    struct ItemDef {
+        int line = 0;
+        std::string name;
+        std::string description;
+        std::string room;           // Exactly one of room and container is set
+        std::string container;
+        bool isContainer = false;
+        int capacity = 0;
+        bool fragment = false;
+        bool fixed = false;
+    };
+
+    struct DialogueEffectDef {
+        DialogueAction action = DialogueAction::SAY;
+        int value = 0;
+        std::string subject;
+        std::string text;
+    };
+
+    struct DialogueEdgeDef {
+        int line = 0;
+        std::string answer;         // Set for "on" edges
+        DialogueCondition condition = DialogueCondition::ALWAYS;
+        std::string subject;
+        int value = 0;
+        std::string target;
+    };
+
+    struct DialogueNodeDef {
+        int line = 0;
+        std::string name;
+        bool asks = false;
+        std::string question;
+        std::vector<DialogueEffectDef> effects;
+        std::vector<DialogueEdgeDef> edges;
+    };
+
+    struct NpcDef {
+        int line = 0;
+        std::string name;
+        std::string description;
+        std::string room;
+        std::string requiredItem;
+        std::string rewardItem;
+        std::string rewardDescription;
+        std::vector<std::string> dialogue;
+        std::vector<std::pair<std::string, std::string>> responses;
+        NpcBehavior behavior = NpcBehavior::STILL;
+        int period = 0;                         // Turns between updates, 0 without a behavior
+        std::vector<std::string> patrolStops;
+        std::string announcement;
+        bool enemy = false;
+        bool importantInfo = false;
+        bool preventReinteraction = false;
+        std::vector<DialogueNodeDef> nodes;     // The first one starts the conversation
+    };
+
+    std::string path;
+    std::string start;
+    int startLine = 0;
+    std::vector<RoomDef> rooms;
+    std::vector<ExitDef> exits;
+    std::vector<ItemDef> items;
+    std::vector<NpcDef> npcs;
+
+    // Lowercase name -> indices of the rooms / container items with that name
+    using NameMap = std::unordered_map<std::string, std::vector<int>>;
+    NameMap RoomsByName() const;
+    NameMap ContainersByName() const;
+
+    friend class SourceParser;
+};
+
+// Direction from its source-file name ("north", "up", ...), false if unknown
+bool ParseDirection(const std::string& name, Direction& direction);
@@ -0,0 +1,168 @@
+#include "WorldGenerator.h"
+#include "WorldImage.h"
+#include "WorldImageWriter.h"
+#include "WorldSource.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+    void PrintProblems(const string& path, const char* kind, const vector<WorldSource::Problem>& problems) {
+        for (const auto& problem : problems) {
+            cerr << path;
+            if (problem.line > 0) {
+                cerr << ":" << problem.line;
+            }
+            cerr << ": " << kind << ": " << problem.message << "\n";
+        }
+    }
+
+    void PrintUsage(const char* program) {
+        cerr << "Usage: " << program << " <source.world> <image.zwld>\n"
+            << "       " << program << " --generate <rooms> <image.zwld> [--seed N] [--exits D]\n"
+            << "           [--locks K] [--dark P] [--items N] [--containers P] [--npcs N] [--wander P]\n"
+            << "           [--walkthrough <commands.txt>]\n";
+    }
+
+    bool ParseNumber(const char* text, double& value) {
+        char* end = nullptr;
+        value = strtod(text, &end);
+        return end != text && *end == '\0';
+    }
+
+    // WorldCompiler --generate <rooms> <image.zwld> [options]
+    int Generate(int argc, char* argv[]) {
+        if (argc < 4) {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+        WorldGenerator::Options options;
+        string imagePath = argv[3];
+        string walkthroughPath;
+
+        double value = 0.0;
+        if (!ParseNumber(argv[2], value) || value < 0.0) {
+            cerr << "error: bad room count '" << argv[2] << "'\n";
+            return 2;
+        }
+        options.rooms = static_cast<uint32_t>(value);
+
+        for (int i = 4; i < argc; i += 2) {
+            string flag = argv[i];
+            if (i + 1 >= argc) {
+                cerr << "error: " << flag << " needs a value\n";
+                return 2;
+            }
+            if (flag == "--walkthrough") {
+                walkthroughPath = argv[i + 1];
+                continue;
+            }
+            if (!ParseNumber(argv[i + 1], value) || value < 0.0) {
+                cerr << "error: bad value '" << argv[i + 1] << "' for " << flag << "\n";
+                return 2;
+            }
+            if (flag == "--seed") options.seed = static_cast<uint64_t>(value);
+            else if (flag == "--exits") options.exitsPerRoom = value;
+            else if (flag == "--locks") options.locks = static_cast<uint32_t>(value);
+            else if (flag == "--dark") options.darkShare = value;
+            else if (flag == "--items") options.itemsPerRoom = value;
+            else if (flag == "--containers") options.containerShare = value;
+            else if (flag == "--npcs") options.npcsPerRoom = value;
+            else if (flag == "--wander") options.wanderShare = value;
+            else {
+                PrintUsage(argv[0]);
+                return 2;
+            }
+        }
+
+        string error;
+        if (!WorldGenerator::Check(options, error)) {
+            cerr << "error: " << error << "\n";
+            return 2;
+        }
+
+        WorldGenerator generator(options);
+        WorldImageWriter writer;
+        generator.Generate(writer);
+        if (!writer.Write(imagePath, error)) {
+            cerr << imagePath << ": error: " << error << "\n";
+            return 1;
+        }
+
+        WorldImage image;
+        if (!image.Open(imagePath, error)) {
+            cerr << "error: the written image does not load: " << error << "\n";
+            return 1;
+        }
+
+        if (!walkthroughPath.empty()) {
+            ofstream file(walkthroughPath);
+            for (const string& command : generator.getWalkthrough()) {
+                file << command << "\n";
+            }
+            if (!file) {
+                cerr << walkthroughPath << ": error: cannot write the walkthrough\n";
+                return 1;
+            }
+        }
+
+        cout << "seed " << options.seed << " -> " << imagePath << ": "
+            << writer.getRoomCount() << " rooms (" << generator.getDarkRoomCount() << " dark), "
+            << writer.getExitCount() << " exits (" << generator.getLockCount() << " locks), "
+            << writer.getItemCount() << " items, " << writer.getNpcCount() << " NPCs, "
+            << writer.getStringBytes() << " bytes of text; won in "
+            << generator.getWalkthrough().size() << " commands\n";
+        return 0;
+    }
+}
+
+// WorldCompiler <source.world> <image.zwld>
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && string(argv[1]) == "--generate") {
+        return Generate(argc, argv);
+    }
+    if (argc != 3) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+    string sourcePath = argv[1];
+    string imagePath = argv[2];
+
+    WorldSource source;
+    vector<WorldSource::Problem> errors;
+    vector<WorldSource::Problem> warnings;
+    if (!source.Load(sourcePath, errors) || !source.Validate(errors, warnings)) {
+        PrintProblems(sourcePath, "warning", warnings);
+        PrintProblems(sourcePath, "error", errors);
+        return 1;
+    }
+    PrintProblems(sourcePath, "warning", warnings);
+
+    WorldImageWriter writer;
+    source.Emit(writer);
+
+    string error;
+    if (!writer.Write(imagePath, error)) {
+        cerr << imagePath << ": error: " << error << "\n";
+        return 1;
+    }
+
+    // Read the result back through the game's own checks
+    WorldImage image;
+    if (!image.Open(imagePath, error)) {
+        cerr << "error: the written image does not load: " << error << "\n";
+        return 1;
+    }
+
+    cout << sourcePath << " -> " << imagePath << ": "
+        << writer.getRoomCount() << " rooms, " << writer.getExitCount() << " exits, "
+        << writer.getItemCount() << " items, " << writer.getNpcCount() << " NPCs, "
+        << writer.getStringBytes() << " bytes of text (" << writer.getStringBytesAdded()
+        << " before deduplication)\n";
+    return 0;
+}
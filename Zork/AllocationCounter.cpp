@@ -0,0 +1,151 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<size_t> allocations{ 0 };
+
+    // Counts and makes one allocation, nullptr if there is no memory even
+    // after the new handler has run
+    void* Allocate(std::size_t size, std::size_t alignment) noexcept {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+
+        if (size == 0) {
+            size = 1;
+        }
+        for (;;) {
+            void* memory;
+            if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                memory = std::malloc(size);
+            }
+            else {
+#ifdef _WIN32
+                memory = _aligned_malloc(size, alignment);
+#else
+                // aligned_alloc() wants the size to be a multiple of the alignment
+                memory = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+            }
+            if (memory != nullptr) {
+                return memory;
+            }
+
+            std::new_handler handler = std::get_new_handler();
+            if (handler == nullptr) {
+                return nullptr;
+            }
+            handler();
+        }
+    }
+
+    void* AllocateOrThrow(std::size_t size, std::size_t alignment) {
+        void* memory = Allocate(size, alignment);
+        if (memory == nullptr) {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+
+    void Free(void* memory, std::size_t alignment) noexcept {
+#ifdef _WIN32
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            _aligned_free(memory);
+            return;
+        }
+#else
+        (void)alignment;
+#endif
+        std::free(memory);
+    }
+
+    constexpr std::size_t PLAIN = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+}
+
+size_t AllocationCounter::Count() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+// ========== Global Allocation Hooks ==========
+// Every form is replaced, so each allocation is counted and freed by the
+// operator that matches the one that made it
+
+void* operator new(std::size_t size) {
+    return AllocateOrThrow(size, PLAIN);
+}
+
+void* operator new[](std::size_t size) {
+    return AllocateOrThrow(size, PLAIN);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size, PLAIN);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size, PLAIN);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return AllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return AllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return Allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return Allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept {
+    Free(memory, PLAIN);
+}
+
+void operator delete[](void* memory) noexcept {
+    Free(memory, PLAIN);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    Free(memory, PLAIN);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    Free(memory, PLAIN);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    Free(memory, PLAIN);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+    Free(memory, PLAIN);
+}
+
+void operator delete(void* memory, std::align_val_t alignment) noexcept {
+    Free(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* memory, std::align_val_t alignment) noexcept {
+    Free(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept {
+    Free(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t alignment) noexcept {
+    Free(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    Free(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    Free(memory, static_cast<std::size_t>(alignment));
+}
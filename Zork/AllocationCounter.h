@@ -0,0 +1,10 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * Counts heap allocations made through operator new.
+ * Used by the benchmarks to check that steady-state turns stay off the heap.
+ */
+namespace AllocationCounter {
+    size_t Count();
+}
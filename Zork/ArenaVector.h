@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+class EntityArena;
+
+// Memory from an EntityArena that lives until the arena is cleared
+void* AllocateInArena(EntityArena& arena, size_t size, size_t alignment);
+
+/**
+ * Growable array for the lists an entity keeps (NPC lines, keywords, patrol
+ * stops, the inventory), with its elements in the entity's EntityArena.
+ * Elements are trivially copyable and nothing is ever freed: growing copies
+ * them into an array twice the size and leaves the old one in the arena
+ * until the world is cleared. That keeps the entity trivially destructible,
+ * so clearing a world never visits its entities.
+ */
+template <typename T>
+class ArenaVector {
+    static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+        "arena vectors copy elements bytewise and never destroy them");
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    void push_back(EntityArena& arena, const T& value) {
+        if (count == capacity) {
+            grow(arena);
+        }
+        elements[count++] = value;
+    }
+
+    // Inserts before 'position', moving the later elements up
+    T* insert(EntityArena& arena, const T* position, const T& value) {
+        size_t index = static_cast<size_t>(position - elements);
+        if (count == capacity) {
+            grow(arena);
+        }
+        std::memmove(elements + index + 1, elements + index, (count - index) * sizeof(T));
+        elements[index] = value;
+        count++;
+        return elements + index;
+    }
+
+    void erase(const T* position) {
+        size_t index = static_cast<size_t>(position - elements);
+        std::memmove(elements + index, elements + index + 1, (count - index - 1) * sizeof(T));
+        count--;
+    }
+
+    // Empties the vector, keeping its array for the next elements
+    void clear() { count = 0; }
+
+    T* begin() { return elements; }
+    T* end() { return elements + count; }
+    const T* begin() const { return elements; }
+    const T* end() const { return elements + count; }
+    T& operator[](size_t index) { return elements[index]; }
+    const T& operator[](size_t index) const { return elements[index]; }
+    T& back() { return elements[count - 1]; }
+    const T& back() const { return elements[count - 1]; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+private:
+    static constexpr uint32_t FIRST_CAPACITY = 4;
+
+    T* elements = nullptr;
+    uint32_t count = 0;
+    uint32_t capacity = 0;
+
+    void grow(EntityArena& arena) {
+        uint32_t larger = capacity == 0 ? FIRST_CAPACITY : capacity * 2;
+        T* moved = static_cast<T*>(AllocateInArena(arena, larger * sizeof(T), alignof(T)));
+        if (count > 0) {
+            std::memcpy(moved, elements, count * sizeof(T));
+        }
+        elements = moved;
+        capacity = larger;
+    }
+};
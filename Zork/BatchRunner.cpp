@@ -0,0 +1,186 @@
+#include "BatchRunner.h"
+#include "AllocationCounter.h"
+#include "GameIO.h"
+#include "MappedFile.h"
+#include "StatusBar.h"
+#include "Tokenizer.h"
+#include <chrono>
+#include <cstring>
+#include <string_view>
+
+namespace {
+
+    // Discards game text without formatting it into a buffer
+    class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override { return traits_type::not_eof(c); }
+        std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+    };
+
+    // Serves lines straight out of a mapped command file
+    class BatchIO : public GameIO {
+    private:
+        NullBuffer buffer;
+        std::ostream sink;
+        const char* position;
+        const char* end;
+
+    public:
+        BatchIO(const char* data, size_t size) :
+            sink(&buffer), position(data), end(data + size) {
+        }
+
+        std::ostream& out() override { return sink; }
+
+        bool readLine(std::string& line) override {
+            if (position == nullptr || position >= end) {
+                line.clear();
+                return false;
+            }
+
+            const char* lineEnd = static_cast<const char*>(memchr(position, '\n', end - position));
+            const char* next = lineEnd != nullptr ? lineEnd + 1 : end;
+            if (lineEnd == nullptr) {
+                lineEnd = end;
+            }
+            if (lineEnd > position && lineEnd[-1] == '\r') {
+                lineEnd--;
+            }
+
+            line.assign(position, lineEnd - position);
+            position = next;
+            return true;
+        }
+    };
+}
+
+bool BatchRunner::Run(const std::vector<std::string>& paths, std::ostream& report,
+    std::shared_ptr<const WorldTemplate> worldTemplate) {
+    bool allLoaded = true;
+    size_t totalCommands = 0;
+    double totalSeconds = 0.0;
+
+    for (const auto& path : paths) {
+        FileSummary summary = RunFile(path, worldTemplate);
+        PrintSummary(summary, report);
+
+        allLoaded = allLoaded && summary.loaded;
+        totalCommands += summary.commands;
+        totalSeconds += summary.seconds;
+    }
+
+    report << "total: " << paths.size() << " file" << (paths.size() == 1 ? "" : "s")
+        << ", " << totalCommands << " commands";
+    if (totalSeconds > 0.0) {
+        report << ", " << static_cast<long long>(totalCommands / totalSeconds) << " commands/s";
+    }
+    report << "\n";
+
+    return allLoaded;
+}
+
+BatchRunner::FileSummary BatchRunner::RunFile(const std::string& path, std::shared_ptr<const WorldTemplate> worldTemplate) {
+    FileSummary summary;
+    summary.path = path;
+
+    MappedFile file;
+    if (!file.Open(path)) {
+        return summary;
+    }
+    summary.loaded = true;
+
+    auto started = std::chrono::steady_clock::now();
+
+    BatchIO io(file.getData(), file.getSize());
+    GameSession session(io, GameClock::Mode::INSTANT, 1.0, std::move(worldTemplate));
+
+    std::string line;
+    TurnResult result = session.poll();
+    size_t allocationsBefore = AllocationCounter::Count();
+    while (!result.gameOver && io.readLine(line)) {
+        result = session.step(line);
+        summary.commands++;
+    }
+
+    summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    summary.allocations = AllocationCounter::Count() - allocationsBefore;
+    summary.result = result;
+    summary.maxHealth = session.getPlayer().getMaxHealth();
+
+    // What the session would cost while idle, with the world left to the template
+    if (session.park()) {
+        summary.parkedBytes = session.getParkedBytes();
+    }
+    return summary;
+}
+
+void BatchRunner::PrintSummary(const FileSummary& summary, std::ostream& report) {
+    report << summary.path << ": ";
+    if (!summary.loaded) {
+        report << "cannot open file\n";
+        return;
+    }
+
+    const TurnResult& result = summary.result;
+    report << "ending=" << endingToString(result.ending)
+        << " moves=" << result.moves
+        << " health=" << result.health << "/" << summary.maxHealth
+        << " alignment=" << result.alignment << " (" << StatusBar::GetAlignmentString(result.alignment) << ")"
+        << " commands=" << summary.commands
+        << " allocations=" << summary.allocations
+        << " parked=" << summary.parkedBytes << "B\n";
+}
+
+bool BatchRunner::BenchmarkTokenizer(const std::vector<std::string>& paths, std::ostream& report) {
+    const int PASSES = 20;
+    bool allLoaded = true;
+
+    for (const auto& path : paths) {
+        report << path << ": ";
+
+        MappedFile file;
+        if (!file.Open(path)) {
+            report << "cannot open file\n";
+            allLoaded = false;
+            continue;
+        }
+
+        std::vector<std::string_view> lines;
+        const char* position = file.getData();
+        const char* end = position + file.getSize();
+        while (position != nullptr && position < end) {
+            const char* lineEnd = static_cast<const char*>(memchr(position, '\n', end - position));
+            if (lineEnd == nullptr) {
+                lineEnd = end;
+            }
+            lines.emplace_back(position, lineEnd - position);
+            position = lineEnd + 1;
+        }
+
+        // The first pass sizes the buffers, the timed passes should not allocate
+        Tokenizer tokenizer;
+        size_t tokens = 0;
+        for (auto line : lines) {
+            tokens += tokenizer.tokenize(line).size();
+        }
+
+        size_t allocationsBefore = AllocationCounter::Count();
+        auto started = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < PASSES; pass++) {
+            for (auto line : lines) {
+                tokens += tokenizer.tokenize(line).size();
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        size_t allocations = AllocationCounter::Count() - allocationsBefore;
+
+        size_t tokenized = lines.size() * PASSES;
+        report << "lines=" << tokenized << " tokens=" << tokens / (PASSES + 1);
+        if (seconds > 0.0) {
+            report << " lines/s=" << static_cast<long long>(tokenized / seconds);
+        }
+        report << " allocations=" << allocations << "\n";
+    }
+
+    return allLoaded;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "GameSession.h"
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Non-interactive mode for regression and load jobs.
+ * Each command file is memory-mapped and streamed line by line through a
+ * fresh session on an INSTANT clock, without prompts, status bars or game
+ * text. Lines that answer in-game questions (yes/no, 1-4) are read from the
+ * same file, exactly as a console player would type them.
+ */
+class BatchRunner {
+public:
+    struct FileSummary {
+        std::string path;
+        bool loaded = false;
+        size_t commands = 0;
+        double seconds = 0.0;
+        TurnResult result;
+        int maxHealth = 0;
+        size_t allocations = 0;     // Heap allocations while replaying the commands
+        size_t parkedBytes = 0;     // Size of the session once parked at the end
+    };
+
+    // Runs every file and writes one summary line per file plus a total;
+    // sessions play 'worldTemplate' when given, the built-in world otherwise
+    static bool Run(const std::vector<std::string>& paths, std::ostream& report,
+        std::shared_ptr<const WorldTemplate> worldTemplate = nullptr);
+
+    static FileSummary RunFile(const std::string& path, std::shared_ptr<const WorldTemplate> worldTemplate = nullptr);
+
+    // Tokenizes every line of each file repeatedly and reports throughput and
+    // heap allocations once the tokenizer's buffers have warmed up
+    static bool BenchmarkTokenizer(const std::vector<std::string>& paths, std::ostream& report);
+
+private:
+    static void PrintSummary(const FileSummary& summary, std::ostream& report);
+};
@@ -0,0 +1,159 @@
+#pragma once
+#include "GameEnums.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Commands understood by the game (one handler each)
+enum class Command {
+    GO,
+    MOVE,        // Direction shortcuts (north/n, south/s, ...)
+    LOOK,
+    TAKE,
+    DROP,
+    INVENTORY,
+    EXAMINE,
+    USE,
+    COMBINE,
+    PLACE,
+    TALK,
+    FLEE,
+    SACRIFICE,
+    FORGIVE,
+    CORRUPT,
+    ALIGNMENT,
+    HELP,
+    QUIT,
+    ATTACK,
+    STEAL,
+    TRAVEL,
+    COUNT
+};
+
+// Words a command expects after its verb
+enum class Arity {
+    NONE,       // Extra words are ignored
+    OPTIONAL,   // The handler validates the argument itself
+    REQUIRED    // A missing argument prints the verb's prompt
+};
+
+struct VerbInfo {
+    std::string_view verb;
+    Command command;
+    Arity arity;
+    const char* prompt;      // Shown when a required argument is missing
+    Direction direction;     // Movement shortcuts only
+};
+
+/**
+ * Verb table with a compile-time perfect hash.
+ * The hash seed is searched at compile time so every verb and alias owns a
+ * distinct slot; a lookup is one hash, one slot read and one comparison no
+ * matter how many verbs are added.
+ */
+namespace CommandTable {
+
+    constexpr VerbInfo VERBS[] = {
+        { "go",        Command::GO,        Arity::REQUIRED, "Go where? (north, south, east, west, up, down)\n", Direction::NORTH },
+        { "north",     Command::MOVE,      Arity::NONE,     nullptr,                Direction::NORTH },
+        { "n",         Command::MOVE,      Arity::NONE,     nullptr,                Direction::NORTH },
+        { "south",     Command::MOVE,      Arity::NONE,     nullptr,                Direction::SOUTH },
+        { "s",         Command::MOVE,      Arity::NONE,     nullptr,                Direction::SOUTH },
+        { "east",      Command::MOVE,      Arity::NONE,     nullptr,                Direction::EAST },
+        { "e",         Command::MOVE,      Arity::NONE,     nullptr,                Direction::EAST },
+        { "west",      Command::MOVE,      Arity::NONE,     nullptr,                Direction::WEST },
+        { "w",         Command::MOVE,      Arity::NONE,     nullptr,                Direction::WEST },
+        { "up",        Command::MOVE,      Arity::NONE,     nullptr,                Direction::UP },
+        { "u",         Command::MOVE,      Arity::NONE,     nullptr,                Direction::UP },
+        { "down",      Command::MOVE,      Arity::NONE,     nullptr,                Direction::DOWN },
+        { "d",         Command::MOVE,      Arity::NONE,     nullptr,                Direction::DOWN },
+        { "look",      Command::LOOK,      Arity::NONE,     nullptr,                Direction::NORTH },
+        { "l",         Command::LOOK,      Arity::NONE,     nullptr,                Direction::NORTH },
+        { "take",      Command::TAKE,      Arity::REQUIRED, "Take what?\n",         Direction::NORTH },
+        { "drop",      Command::DROP,      Arity::REQUIRED, "Drop what?\n",         Direction::NORTH },
+        { "inventory", Command::INVENTORY, Arity::NONE,     nullptr,                Direction::NORTH },
+        { "i",         Command::INVENTORY, Arity::NONE,     nullptr,                Direction::NORTH },
+        { "examine",   Command::EXAMINE,   Arity::REQUIRED, "Examine what?\n",      Direction::NORTH },
+        { "x",         Command::EXAMINE,   Arity::REQUIRED, "Examine what?\n",      Direction::NORTH },
+        { "use",       Command::USE,       Arity::REQUIRED, "Use what?\n",          Direction::NORTH },
+        { "combine",   Command::COMBINE,   Arity::OPTIONAL, nullptr,                Direction::NORTH },
+        { "place",     Command::PLACE,     Arity::OPTIONAL, nullptr,                Direction::NORTH },
+        { "talk",      Command::TALK,      Arity::REQUIRED, "Talk to whom?\n",      Direction::NORTH },
+        { "flee",      Command::FLEE,      Arity::NONE,     nullptr,                Direction::NORTH },
+        { "sacrifice", Command::SACRIFICE, Arity::REQUIRED, "Sacrifice whom?\n",    Direction::NORTH },
+        { "forgive",   Command::FORGIVE,   Arity::REQUIRED, "Forgive whom?\n",      Direction::NORTH },
+        { "corrupt",   Command::CORRUPT,   Arity::REQUIRED, "Corrupt what?\n",      Direction::NORTH },
+        { "alignment", Command::ALIGNMENT, Arity::NONE,     nullptr,                Direction::NORTH },
+        { "karma",     Command::ALIGNMENT, Arity::NONE,     nullptr,                Direction::NORTH },
+        { "help",      Command::HELP,      Arity::NONE,     nullptr,                Direction::NORTH },
+        { "quit",      Command::QUIT,      Arity::NONE,     nullptr,                Direction::NORTH },
+        { "exit",      Command::QUIT,      Arity::NONE,     nullptr,                Direction::NORTH },
+        { "attack",    Command::ATTACK,    Arity::REQUIRED, "Attack what?\n",       Direction::NORTH },
+        { "steal",     Command::STEAL,     Arity::REQUIRED, "Steal what?\n",        Direction::NORTH },
+        { "travel",    Command::TRAVEL,    Arity::REQUIRED, "Travel where?\n",      Direction::NORTH },
+    };
+
+    constexpr size_t VERB_COUNT = sizeof(VERBS) / sizeof(VERBS[0]);
+    constexpr unsigned SLOT_BITS = 7;
+    constexpr size_t SLOT_COUNT = size_t(1) << SLOT_BITS;
+    constexpr uint32_t NO_SEED = 0xFFFFFFFFu;
+
+    static_assert(VERB_COUNT < 128 && VERB_COUNT * 2 <= SLOT_COUNT, "verb table too full for its slot count");
+
+    // Seeded FNV-1a folded to a slot index by multiplicative hashing
+    constexpr uint32_t Hash(std::string_view word, uint32_t seed) {
+        uint32_t hash = 2166136261u ^ seed;
+        for (char c : word) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 16777619u;
+        }
+        return (hash * 2654435769u) >> (32 - SLOT_BITS);
+    }
+
+    constexpr bool IsPerfect(uint32_t seed) {
+        bool used[SLOT_COUNT] = {};
+        for (const auto& info : VERBS) {
+            uint32_t slot = Hash(info.verb, seed);
+            if (used[slot]) {
+                return false;
+            }
+            used[slot] = true;
+        }
+        return true;
+    }
+
+    constexpr uint32_t FindSeed() {
+        for (uint32_t seed = 0; seed < 4096; seed++) {
+            if (IsPerfect(seed)) {
+                return seed;
+            }
+        }
+        return NO_SEED;
+    }
+
+    constexpr uint32_t SEED = FindSeed();
+    static_assert(SEED != NO_SEED, "no collision-free hash seed for the verb table, raise SLOT_BITS");
+
+    constexpr std::array<int8_t, SLOT_COUNT> BuildSlots() {
+        std::array<int8_t, SLOT_COUNT> slots{};
+        for (auto& slot : slots) {
+            slot = -1;
+        }
+        for (size_t i = 0; i < VERB_COUNT; i++) {
+            slots[Hash(VERBS[i].verb, SEED)] = static_cast<int8_t>(i);
+        }
+        return slots;
+    }
+
+    constexpr std::array<int8_t, SLOT_COUNT> SLOTS = BuildSlots();
+
+    // Returns the verb's entry, or nullptr for unknown words
+    inline const VerbInfo* Find(std::string_view word) {
+        int index = SLOTS[Hash(word, SEED)];
+        if (index < 0 || VERBS[index].verb != word) {
+            return nullptr;
+        }
+        return &VERBS[index];
+    }
+}
@@ -1,128 +1,144 @@
 #include "Creature.h"
+#include "EntityArena.h"
 #include "Exit.h"
 #include "Room.h"
 #include "GameEnums.h"
-#include <iostream>
+#include "GameIO.h"
 #include <algorithm>
 
-Creature::Creature(EntityType type, const string& name, const string& description, Room* room) :
-    Entity(type, name, description),
-    location(room),
-    health(100),    // Default health to 100
-    maxHealth(100) {
+Creature::Creature(EntityArena& arena, EntityType type, const string& name, const string& description, Room* room) :
+    Entity(arena, type, name, description),
+    row(arena.getCreatures().add(this, room != nullptr ? room->getHandle() : EntityHandle::None(), STARTING_HEALTH)) {
     if (room != nullptr) {
         room->addEntity(this);
     }
 }
 
-Creature::~Creature() {
-    // Remove this creature from its location when destroyed
-    if (location != nullptr) {
-        location->removeEntity(this);
+Creature::Creature(EntityArena& arena, EntityType type, BorrowedText name, BorrowedText description, Room* room) :
+    Entity(arena, type, name, description),
+    row(arena.getCreatures().add(this, room != nullptr ? room->getHandle() : EntityHandle::None(), STARTING_HEALTH)) {
+    if (room != nullptr) {
+        room->addEntity(this);
     }
 }
 
+void Creature::release() {
+    table().remove(row);
+}
+
+CreatureTable& Creature::table() const {
+    return arena->getCreatures();
+}
+
 // ========== Location Management ==========
 
 Room* Creature::getLocation() const {
-    return location;
+    return arena->get<Room>(table().locations[row]);
 }
 
 void Creature::setLocation(Room* newLocation) {
     // Remove from current location
-    if (location != nullptr) {
-        location->removeEntity(this);
+    Room* current = getLocation();
+    if (current != nullptr) {
+        current->removeEntity(this);
     }
 
     // Set new location
-    location = newLocation;
+    table().locations[row] = newLocation != nullptr ? newLocation->getHandle() : EntityHandle::None();
 
     // Add to new location
-    if (location != nullptr) {
-        location->addEntity(this);
+    if (newLocation != nullptr) {
+        newLocation->addEntity(this);
     }
 }
 
 // ========== Movement ==========
 
 void Creature::move(Direction direction) {
-    if (location == nullptr) return;
+    Room* room = getLocation();
+    if (room == nullptr) return;
 
     // Check if there's an exit in the specified direction
-    Entity* exitEntity = location->getExit(direction);
-    if (exitEntity == nullptr || exitEntity->getType() != EntityType::EXIT) {
-        std::cout << "You can't go that way." << std::endl;
-        return;
-    }
-
-    // Properly cast to Exit
-    Exit* exit = dynamic_cast<Exit*>(exitEntity);
+    Exit* exit = room->getExit(direction);
     if (exit == nullptr) {
-        std::cout << "You can't go that way." << std::endl;
+        GameIO::Out() << "You can't go that way." << std::endl;
         return;
     }
 
     // Check if the exit is locked
     if (exit->isLocked()) {
-        std::cout << "The exit is locked." << std::endl;
+        GameIO::Out() << "The exit is locked." << std::endl;
         return;
     }
 
     // Move to the destination
-    setLocation(exit->getDestination());
-    std::cout << "You move " << directionToString(direction) << " to " << location->getName() << std::endl;
-    location->look();
+    room = exit->getDestination();
+    setLocation(room);
+    GameIO::Out() << "You move " << directionToString(direction) << " to " << room->getName() << std::endl;
+    room->look();
 }
 
 // ========== Information Display ==========
 
 void Creature::look() const {
     // Display base entity information
-    Entity::look();
+    describe();
 
     // Display location information if available
-    if (location != nullptr) {
-        std::cout << "Location: " << location->getName() << std::endl;
+    Room* room = getLocation();
+    if (room != nullptr) {
+        GameIO::Out() << "Location: " << room->getName() << std::endl;
     }
 }
 
 // ========== Health Management ==========
 
 int Creature::getHealth() const {
-    return health;
+    return table().health[row];
 }
 
 int Creature::getMaxHealth() const {
-    return maxHealth;
+    return table().maxHealth[row];
 }
 
 void Creature::setHealth(int newHealth) {
-    health = std::max(0, std::min(newHealth, maxHealth));
+    table().health[row] = std::max(0, std::min(newHealth, getMaxHealth()));
+}
+
+void Creature::setMaxHealth(int newMaxHealth) {
+    table().maxHealth[row] = newMaxHealth;
+}
+
+void Creature::restoreHealth(int health, int maxHealth) {
+    table().health[row] = health;
+    table().maxHealth[row] = maxHealth;
 }
 
 bool Creature::isAlive() const {
-    return health > 0;
+    return getHealth() > 0;
 }
 
 void Creature::takeDamage(int amount) {
     // Ensure health doesn't go below 0
+    int& health = table().health[row];
     health = std::max(0, health - amount);
 
     // Display damage information
-    std::cout << name << " takes " << amount << " damage! ";
-    std::cout << "Health: " << health << "/" << maxHealth << std::endl;
+    GameIO::Out() << name << " takes " << amount << " damage! ";
+    GameIO::Out() << "Health: " << health << "/" << getMaxHealth() << std::endl;
 
     // Check if creature is defeated
     if (!isAlive()) {
-        std::cout << name << " has been defeated!" << std::endl;
+        GameIO::Out() << name << " has been defeated!" << std::endl;
     }
 }
 
 void Creature::heal(int amount) {
     // Ensure health doesn't exceed maxHealth
-    health = std::min(health + amount, maxHealth);
+    int& health = table().health[row];
+    health = std::min(health + amount, getMaxHealth());
 
     // Display healing information
-    std::cout << name << " heals " << amount << " HP. ";
-    std::cout << "Health: " << health << "/" << maxHealth << std::endl;
-}
\ No newline at end of file
+    GameIO::Out() << name << " heals " << amount << " HP. ";
+    GameIO::Out() << "Health: " << health << "/" << getMaxHealth() << std::endl;
+}
@@ -5,34 +5,47 @@
 
 using std::string;
 
+class CreatureTable;
 class Room;
 
 class Creature : public Entity {
 protected:
-    Room* location;  // Current location of the creature
+    // Row in the arena's CreatureTable, which holds the room the creature
+    // is in and its current and maximum health
+    uint32_t row;
 
-    int health;      // Current health points
-    int maxHealth;   // Maximum health points
+    CreatureTable& table() const;
+
+    // Sets both as saved, without clamping
+    // Gives the creature's row back to the table, when the arena destroys it
+    friend class EntityArena;
+    void release();
+
+    void restoreHealth(int health, int maxHealth);
+    void setMaxHealth(int newMaxHealth);
 
 public:
-    Creature(EntityType type, const string& name, const string& description, Room* room);
-    virtual ~Creature();
+    // Health and maximum health of every new creature
+    static constexpr int STARTING_HEALTH = 100;
+
+    Creature(EntityArena& arena, EntityType type, const string& name, const string& description, Room* room);
+    Creature(EntityArena& arena, EntityType type, BorrowedText name, BorrowedText description, Room* room);
 
     // Location management
     Room* getLocation() const;
     void setLocation(Room* newLocation);
 
     // Movement
-    virtual void move(Direction direction);
+    void move(Direction direction);
 
     // Information display
-    virtual void look() const override;
+    void look() const;
 
     // Health management
     int getHealth() const;
     int getMaxHealth() const;
     void setHealth(int newHealth);
     bool isAlive() const;
-    virtual void takeDamage(int amount);
+    void takeDamage(int amount);
     void heal(int amount);
 };
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "DialogueGraph.h"
+#include "WorldImage.h"
+#include "WorldImageWriter.h"
+
+void DialogueGraph::Load(const WorldImage& image) {
+    using namespace WorldFormat;
+
+    nodes.clear();
+    effects.clear();
+    edges.clear();
+    nodes.reserve(image.getDialogueNodeCount());
+
+    // Records are stored node by node, so appending keeps every run in place
+    for (size_t n = 0; n < image.getDialogueNodeCount(); n++) {
+        const DialogueNodeRecord& record = image.getDialogueNode(n);
+        addNode((record.flags & NODE_ASKS) != 0, image.getString(record.question));
+        for (uint32_t e = record.firstEffect; e < record.firstEffect + record.effectCount; e++) {
+            const DialogueEffectRecord& effect = image.getDialogueEffect(e);
+            addEffect(Effect{ static_cast<DialogueAction>(effect.action), effect.value,
+                image.getString(effect.subject), image.getString(effect.text) });
+        }
+        for (uint32_t e = record.firstEdge; e < record.firstEdge + record.edgeCount; e++) {
+            const DialogueEdgeRecord& edge = image.getDialogueEdge(e);
+            addEdge(Edge{ image.getString(edge.answer), static_cast<DialogueCondition>(edge.condition),
+                image.getString(edge.subject), edge.value, edge.target });
+        }
+    }
+}
+
+void DialogueGraph::Save(WorldImageWriter& writer) const {
+    for (const Node& node : nodes) {
+        uint32_t index = writer.addDialogueNode(node.question, node.asks ? WorldFormat::NODE_ASKS : 0);
+        for (uint32_t e = node.firstEffect; e < node.firstEffect + node.effectCount; e++) {
+            const Effect& effect = effects[e];
+            writer.addDialogueEffect(index, effect.action, effect.subject, effect.text, effect.value);
+        }
+        for (uint32_t e = node.firstEdge; e < node.firstEdge + node.edgeCount; e++) {
+            const Edge& edge = edges[e];
+            writer.addDialogueEdge(index, edge.answer, edge.condition, edge.subject, edge.value, edge.target);
+        }
+    }
+}
+
+uint32_t DialogueGraph::addNode(bool asks, std::string_view question) {
+    Node node{};
+    node.firstEffect = static_cast<uint32_t>(effects.size());
+    node.firstEdge = static_cast<uint32_t>(edges.size());
+    node.asks = asks;
+    node.question = question;
+    nodes.push_back(node);
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+void DialogueGraph::addEffect(const Effect& effect) {
+    effects.push_back(effect);
+    nodes.back().effectCount++;
+}
+
+void DialogueGraph::addEdge(const Edge& edge) {
+    edges.push_back(edge);
+    nodes.back().edgeCount++;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "GameEnums.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+class WorldImage;
+class WorldImageWriter;
+
+/**
+ * The conversations of a world's NPCs, as one graph of nodes.
+ * Reaching a node runs its effects in order; then the node either asks the
+ * player a question, its edges being the answers, or goes on along the
+ * first edge whose condition holds. The conversation ends at a node with no
+ * edge to follow. NPC runs the graph; the graph itself only holds the data.
+ *
+ * A graph is built once per world image (or by World::InitializeWorld) and
+ * is not changed afterwards, so every session playing the image shares it.
+ * Its text is borrowed: from the image, or from string literals.
+ */
+class DialogueGraph {
+public:
+    struct Effect {
+        DialogueAction action;
+        int value;
+        std::string_view subject;   // Item given or taken
+        std::string_view text;      // Line said, or the description of an item given
+    };
+
+    struct Edge {
+        std::string_view answer;    // Lowercase answer taking the edge, empty for any
+        DialogueCondition condition;
+        std::string_view subject;   // Item the condition looks for
+        int value;                  // Alignment the condition compares with
+        uint32_t target;
+    };
+
+    struct Node {
+        uint32_t firstEffect;
+        uint32_t effectCount;
+        uint32_t firstEdge;
+        uint32_t edgeCount;
+        bool asks;
+        std::string_view question;  // Printed without a line break before an asking node waits
+    };
+
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+    // Copies the node, effect and edge records of an image, borrowing its text
+    void Load(const WorldImage& image);
+
+    // Adds every node to an image with the same numbering
+    void Save(WorldImageWriter& writer) const;
+
+    // Building: effects and edges go to the node added last, edges may
+    // lead to nodes not added yet
+    uint32_t addNode(bool asks = false, std::string_view question = std::string_view());
+    void addEffect(const Effect& effect);
+    void addEdge(const Edge& edge);
+    void say(std::string_view line) { addEffect(Effect{ DialogueAction::SAY, 0, std::string_view(), line }); }
+    void addEffect(DialogueAction action, int value = 0) { addEffect(Effect{ action, value, std::string_view(), std::string_view() }); }
+    void addItemEffect(DialogueAction action, std::string_view item, std::string_view description = std::string_view()) {
+        addEffect(Effect{ action, 0, item, description });
+    }
+    void addAnswer(std::string_view answer, uint32_t target) {
+        addEdge(Edge{ answer, DialogueCondition::ALWAYS, std::string_view(), 0, target });
+    }
+    void addBranch(DialogueCondition condition, uint32_t target, std::string_view item = std::string_view()) {
+        addEdge(Edge{ std::string_view(), condition, item, 0, target });
+    }
+    void addGoto(uint32_t target) { addBranch(DialogueCondition::ALWAYS, target); }
+
+    size_t getNodeCount() const { return nodes.size(); }
+    const Node& getNode(uint32_t node) const { return nodes[node]; }
+    const Effect& getEffect(uint32_t effect) const { return effects[effect]; }
+    const Edge& getEdge(uint32_t edge) const { return edges[edge]; }
+
+private:
+    std::vector<Node> nodes;
+    std::vector<Effect> effects;
+    std::vector<Edge> edges;
+};
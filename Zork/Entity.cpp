@@ -1,120 +1,164 @@
 #include "Entity.h"
+#include "EntityCast.h"
+#include "Exit.h"
+#include "Item.h"
+#include "NPC.h"
+#include "Player.h"
+#include "Room.h"
+#include "EntityArena.h"
+#include "GameIO.h"
+#include "NameTable.h"
 #include <algorithm>
-#include <iostream>
-#include <climits> 
 
-Entity::Entity(EntityType type, const string& name, const string& description) :
-    type(type), name(name), description(description) {
+Entity::Entity(EntityArena& arena, EntityType type, const string& name, const string& description) :
+    type(type), name(arena.keepText(name)), description(arena.keepText(description)),
+    parent(nullptr), previousSibling(nullptr), nextSibling(nullptr), firstChild{}, lastChild{},
+    childCount(0), addOrder(0), nextAddOrder(0), lowerName(arena.getNames().intern(this->name)),
+    previousNamed(nullptr), nextNamed(nullptr), nameOrder(0), record(NO_RECORD), arena(&arena),
+    handle(arena.adopt(this)) {
 }
 
-Entity::~Entity() {
-    for (auto entity : contains) {
-        delete entity;
-    }
-}
-
-EntityType Entity::getType() const {
-    return type;
+Entity::Entity(EntityArena& arena, EntityType type, BorrowedText name, BorrowedText description) :
+    type(type), name(name.text), description(description.text),
+    parent(nullptr), previousSibling(nullptr), nextSibling(nullptr), firstChild{}, lastChild{},
+    childCount(0), addOrder(0), nextAddOrder(0), lowerName(arena.getNames().intern(this->name)),
+    previousNamed(nullptr), nextNamed(nullptr), nameOrder(0), record(NO_RECORD), arena(&arena),
+    handle(arena.adopt(this)) {
 }
 
-const string& Entity::getName() const {
-    return name;
-}
-
-const string& Entity::getDescription() const {
+std::string_view Entity::getDescription() const {
     return description;
 }
 
-const list<Entity*>& Entity::getContains() const {
-    return contains;
-}
-
 // ========== Entity Management ==========
 
 void Entity::addEntity(Entity* entity) {
-    if (entity != nullptr) {
-        contains.push_back(entity);
+    if (entity == nullptr) {
+        return;
+    }
+    if (entity->parent != nullptr) {
+        entity->parent->removeEntity(entity);
+    }
+    if (nextAddOrder == UINT32_MAX) {
+        renumberChildren();
     }
-}
 
-void Entity::removeEntity(Entity* entity) {
-    if (entity != nullptr) {
-        contains.remove(entity);
+    // Append to the entity's bucket, stamped so the buckets merge back into
+    // the order entities were added in
+    int bucket = EntityBucket::Of(entity->type);
+    entity->parent = this;
+    entity->addOrder = nextAddOrder++;
+    entity->previousSibling = lastChild[bucket];
+    entity->nextSibling = nullptr;
+    if (lastChild[bucket] != nullptr) {
+        lastChild[bucket]->nextSibling = entity;
+    }
+    else {
+        firstChild[bucket] = entity;
     }
+    lastChild[bucket] = entity;
+    childCount++;
+    containsNames.add(entity);
 }
 
-Entity* Entity::findEntity(const string& name) const {
-    if (name.empty()) {
-        return nullptr;
+void Entity::removeEntity(Entity* entity) {
+    if (entity == nullptr || entity->parent != this) {
+        return;
     }
 
-    // First try exact match (case-insensitive)
-    for (auto entity : contains) {
-        if (entity->nameMatches(name)) {
-            return entity;
-        }
+    int bucket = EntityBucket::Of(entity->type);
+    if (entity->previousSibling != nullptr) {
+        entity->previousSibling->nextSibling = entity->nextSibling;
     }
+    else {
+        firstChild[bucket] = entity->nextSibling;
+    }
+    if (entity->nextSibling != nullptr) {
+        entity->nextSibling->previousSibling = entity->previousSibling;
+    }
+    else {
+        lastChild[bucket] = entity->previousSibling;
+    }
+    entity->parent = nullptr;
+    entity->previousSibling = nullptr;
+    entity->nextSibling = nullptr;
+    childCount--;
+    containsNames.remove(entity);
+}
 
-    // Then try partial match if no exact match found
-    string lowerName = name;
-    std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
-
-    Entity* bestMatch = nullptr;
-    int bestMatchScore = INT_MAX;
-
-    for (auto entity : contains) {
-        string entityLower = entity->getName();
-        std::transform(entityLower.begin(), entityLower.end(), entityLower.begin(), ::tolower);
-
-        // Check if the entity name contains the search term
-        if (entityLower.find(lowerName) != string::npos) {
-            // Score based on length difference - closer to search term is better
-            int diff = static_cast<int>(entityLower.length()) - static_cast<int>(lowerName.length());
-            int score = diff < 0 ? -diff : diff;
-
-            if (score < bestMatchScore) {
-                bestMatch = entity;
-                bestMatchScore = score;
-            }
-        }
+void Entity::renumberChildren() {
+    // Only after four billion adds to one container; the merged order is
+    // kept, the stamps just start again from zero
+    uint32_t order = 0;
+    for (Entity* entity : getContains()) {
+        entity->addOrder = order++;
     }
+    nextAddOrder = order;
+}
 
-    return bestMatch;
+Entity* Entity::findEntity(const string& name) const {
+    // Exact name first, then the closest partial name
+    return containsNames.find(name, arena->getNames());
+}
+
+Entity* Entity::findEntity(const string& name, unsigned buckets) const {
+    return containsNames.find(name, arena->getNames(), buckets);
 }
 
 bool Entity::containsEntity(const Entity* entity) const {
-    if (entity == nullptr) {
-        return false;
-    }
-    return std::find(contains.begin(), contains.end(), entity) != contains.end();
+    return entity != nullptr && entity->parent == this;
 }
 
 // ========== Name Matching ==========
 
-bool Entity::nameMatches(const string& nameToMatch) const {
-    string thisName = name;
-    string otherName = nameToMatch;
+bool Entity::nameMatches(std::string_view nameToMatch) const {
+    if (nameToMatch.size() != lowerName.size()) {
+        return false;
+    }
+
+    // Compare against the stored lowercase form without copying either name
+    for (size_t i = 0; i < lowerName.size(); i++) {
+        char c = nameToMatch[i];
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c + ('a' - 'A'));
+        }
+        if (c != lowerName[i]) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    // Convert both names to lowercase for case-insensitive comparison
-    std::transform(thisName.begin(), thisName.end(), thisName.begin(), ::tolower);
-    std::transform(otherName.begin(), otherName.end(), otherName.begin(), ::tolower);
+// ========== Contents Views ==========
 
-    return thisName == otherName;
+size_t EntityChildren::size() const {
+    if (buckets == EntityBucket::ALL) {
+        return container->childCount;
+    }
+    return static_cast<size_t>(std::distance(begin(), end()));
 }
 
-void Entity::update() {
+uint32_t Entity::update(uint32_t turn, const Player& player) {
+    if (NPC* npc = entity_cast<NPC>(this)) {
+        return npc->update(turn, player);
+    }
+    return 0;
 }
 
 void Entity::look() const {
+    VisitEntity(*this, [](const auto& entity) { entity.look(); });
+}
+
+void Entity::describe() const {
     // Display entity name and description
-    std::cout << name << std::endl;
-    std::cout << description << std::endl;
+    GameIO::Out() << name << std::endl;
+    GameIO::Out() << description << std::endl;
 
     // Show contained entities if any
-    if (!contains.empty()) {
-        std::cout << "Contains:" << std::endl;
-        for (auto entity : contains) {
-            std::cout << "- " << entity->getName() << std::endl;
+    if (childCount > 0) {
+        GameIO::Out() << "Contains:" << std::endl;
+        for (auto entity : getContains()) {
+            GameIO::Out() << "- " << entity->getName() << std::endl;
         }
     }
 }
\ No newline at end of file
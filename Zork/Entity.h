@@ -1,13 +1,21 @@
 #pragma once
+#include "EntityHandle.h"
+#include "NameIndex.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <string>
-#include <list>
+#include <string_view>
 #include <vector>
 #include <algorithm>
 
 using std::string;
-using std::list;
 using std::vector;
 
+class Entity;
+class EntityArena;
+class Player;
+
 enum class EntityType {
     ENTITY,     // Base entity type
     ROOM,       // Game locations
@@ -18,31 +26,191 @@ enum class EntityType {
     NPC         // Non-player characters
 };
 
+// Text owned elsewhere (e.g. a mapped world image) that outlives the entity using it
+struct BorrowedText {
+    std::string_view text;
+
+    explicit BorrowedText(std::string_view text) : text(text) {}
+};
+
+// Buckets a container keeps its entities in, one per kind, as bits so a
+// lookup or a walk can ask for several
+struct EntityBucket {
+    static constexpr unsigned ITEMS = 1u << 0;
+    static constexpr unsigned NPCS = 1u << 1;
+    static constexpr unsigned PLAYERS = 1u << 2;
+    static constexpr unsigned OTHERS = 1u << 3;     // Rooms and exits, which nothing holds today
+    static constexpr unsigned ALL = ITEMS | NPCS | PLAYERS | OTHERS;
+    static constexpr int COUNT = 4;
+
+    // Bucket number (0 to COUNT - 1) for an entity of this type
+    static int Of(EntityType type) {
+        switch (type) {
+        case EntityType::ITEM: return 0;
+        case EntityType::NPC: return 1;
+        case EntityType::PLAYER: return 2;
+        default: return 3;
+        }
+    }
+    static unsigned BitOf(EntityType type) { return 1u << Of(type); }
+};
+
+/**
+ * The entities of some buckets of one container, in the order they were
+ * added. A view over the container's intrusive links: one bucket is walked
+ * by following its sibling pointers, several are merged by the order stamp
+ * each entity got when it was added, so entities of other buckets are never
+ * visited. It stays valid as entities come and go (except an iterator at an
+ * entity that is removed).
+ */
+class EntityChildren {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Entity*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Entity* const*;
+        using reference = Entity* const&;
+
+        iterator() = default;
+        iterator(const Entity& container, unsigned buckets);
+
+        reference operator*() const { return current; }
+        iterator& operator++();
+        iterator operator++(int) { iterator old = *this; ++*this; return old; }
+        bool operator==(const iterator& other) const { return current == other.current; }
+        bool operator!=(const iterator& other) const { return current != other.current; }
+
+    private:
+        Entity* next[EntityBucket::COUNT] = {};     // Next entity of each bucket walked
+        Entity* current = nullptr;
+
+        void pick();
+    };
+    using const_iterator = iterator;
+
+    EntityChildren(const Entity& container, unsigned buckets) : container(&container), buckets(buckets) {}
+
+    iterator begin() const { return iterator(*container, buckets); }
+    iterator end() const { return iterator(); }
+    bool empty() const;
+    size_t size() const;
+
+private:
+    const Entity* container;
+    unsigned buckets;
+};
+
 class Entity {
 protected:
     EntityType type;        // Type of this entity
-    string name;            // Name of the entity
-    string description;     // Description of the entity
-    list<Entity*> contains; // Items contained within this entity
+    // Name and description, kept in the arena or borrowed from a world image
+    // or an ItemPrototype, so entities own nothing that needs destroying
+    std::string_view name;
+    std::string_view description;
+
+    // Containment tree, linked through the entities themselves so moving an
+    // entity never allocates and never searches its container. Siblings are
+    // linked within their EntityBucket only.
+    Entity* parent;                 // Container this entity is in, nullptr if none
+    Entity* previousSibling;
+    Entity* nextSibling;
+    Entity* firstChild[EntityBucket::COUNT];
+    Entity* lastChild[EntityBucket::COUNT];
+    uint32_t childCount;
+    uint32_t addOrder;              // Stamp from the parent, orders siblings across buckets
+    uint32_t nextAddOrder;          // Stamp for the next entity added here
+
+    std::string_view lowerName;     // Interned lowercase name
+    NameIndex containsNames;        // Contained entities by name
+    Entity* previousNamed;          // Chain of the NameIndex this entity is in
+    Entity* nextNamed;
+    uint32_t nameOrder;             // Listing position in that index
+    uint32_t record;                // World template record it was built from
+    EntityArena* arena;             // Arena that created and owns this entity
+    EntityHandle handle;            // This entity's slot in that arena
+
+    // Name, description and contents, the common part of every look()
+    void describe() const;
+
+    // Restamps the contents from zero when the stamps run out
+    void renumberChildren();
+
+    friend class EntityChildren;
+    friend class NameIndex;
 
 public:
-    Entity(EntityType type, const string& name, const string& description);
-    virtual ~Entity();
+    // Entities are only made by EntityArena::create(), which passes itself
+    // in; strings are copied into the arena, BorrowedText is used as it is
+    Entity(EntityArena& arena, EntityType type, const string& name, const string& description);
+    Entity(EntityArena& arena, EntityType type, BorrowedText name, BorrowedText description);
+
+    Entity(const Entity&) = delete;
+    Entity& operator=(const Entity&) = delete;
 
-    EntityType getType() const;
-    const string& getName() const;
-    const string& getDescription() const;
-    const list<Entity*>& getContains() const;
+    EntityType getType() const { return type; }
+    std::string_view getName() const { return name; }
+    std::string_view getLowerName() const { return lowerName; }
+    std::string_view getDescription() const;
+    EntityChildren getContains() const { return EntityChildren(*this, EntityBucket::ALL); }
+    // Contents of some buckets only, e.g. EntityBucket::NPCS
+    EntityChildren getContains(unsigned buckets) const { return EntityChildren(*this, buckets); }
+    // Container this entity is in (a room or an item), nullptr if none
+    Entity* getParent() const { return parent; }
 
-    // Entity management
+    // Owning arena and this entity's handle there
+    EntityArena& getArena() const { return *arena; }
+    EntityHandle getHandle() const { return handle; }
+
+    // Template record this entity was loaded from, NO_RECORD if it was created in play
+    static constexpr uint32_t NO_RECORD = 0xFFFFFFFFu;
+    uint32_t getRecord() const { return record; }
+    void setRecord(uint32_t index) { record = index; }
+
+    // Entity management; adding an entity takes it out of its old container
     void addEntity(Entity* entity);
     void removeEntity(Entity* entity);
     Entity* findEntity(const string& name) const;
+    // Looks only at entities in these buckets, e.g. the NPCs to talk to
+    Entity* findEntity(const string& name, unsigned buckets) const;
     bool containsEntity(const Entity* entity) const;
 
     // Name matching (case-insensitive)
-    bool nameMatches(const string& nameToMatch) const;
+    bool nameMatches(std::string_view nameToMatch) const;
+
+    // Entities have no virtual functions: these dispatch on getType() to
+    // the entity's own class (see VisitEntity in EntityCast.h).
+    // update() acts once between turns and returns the turns until the
+    // entity wants the next update, 0 for none; only NPCs act so far
+    uint32_t update(uint32_t turn, const Player& player);
+    void look() const;
+};
+
+inline EntityChildren::iterator::iterator(const Entity& container, unsigned buckets) {
+    for (int bucket = 0; bucket < EntityBucket::COUNT; bucket++) {
+        if ((buckets & (1u << bucket)) != 0) {
+            next[bucket] = container.firstChild[bucket];
+        }
+    }
+    pick();
+}
+
+inline void EntityChildren::iterator::pick() {
+    current = nullptr;
+    for (Entity* candidate : next) {
+        if (candidate != nullptr && (current == nullptr || candidate->addOrder < current->addOrder)) {
+            current = candidate;
+        }
+    }
+}
+
+inline EntityChildren::iterator& EntityChildren::iterator::operator++() {
+    next[EntityBucket::Of(current->type)] = current->nextSibling;
+    pick();
+    return *this;
+}
 
-    virtual void update();
-    virtual void look() const;
-};
\ No newline at end of file
+inline bool EntityChildren::empty() const {
+    return begin() == end();
+}
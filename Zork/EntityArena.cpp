@@ -0,0 +1,206 @@
+#include "EntityArena.h"
+#include "Entity.h"
+#include "EntityCast.h"
+#include "Exit.h"
+#include "Item.h"
+#include "NPC.h"
+#include "Player.h"
+#include "Room.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Ending a world only rewinds the blocks, so nothing in them may need destroying
+static_assert(std::is_trivially_destructible<Room>::value, "rooms must be trivially destructible");
+static_assert(std::is_trivially_destructible<Exit>::value, "exits must be trivially destructible");
+static_assert(std::is_trivially_destructible<Item>::value, "items must be trivially destructible");
+static_assert(std::is_trivially_destructible<NPC>::value, "NPCs must be trivially destructible");
+static_assert(std::is_trivially_destructible<Player>::value, "players must be trivially destructible");
+
+void* AllocateInArena(EntityArena& arena, size_t size, size_t alignment) {
+    return arena.allocate(size, alignment);
+}
+
+EntityArena::EntityArena() = default;
+
+EntityArena::~EntityArena() {
+    release();
+}
+
+void* EntityArena::allocate(size_t size, size_t alignment) {
+    while (true) {
+        if (current < blocks.size()) {
+            Block& block = blocks[current];
+            uintptr_t base = reinterpret_cast<uintptr_t>(block.memory.get());
+            size_t offset = ((base + used + alignment - 1) & ~(alignment - 1)) - base;
+            if (offset + size <= block.size) {
+                used = offset + size;
+                return block.memory.get() + offset;
+            }
+            if (current + 1 < blocks.size()) {
+                // A block kept from an earlier world
+                current++;
+                used = 0;
+                continue;
+            }
+        }
+        addBlock(size + alignment);
+    }
+}
+
+void EntityArena::addBlock(size_t minimumSize) {
+    // Each block doubles the last, so even huge worlds take few blocks
+    size_t size = blocks.empty() ? FIRST_BLOCK_SIZE : std::min(blocks.back().size * 2, MAX_BLOCK_SIZE);
+    size = std::max(size, minimumSize);
+    blocks.push_back(Block{ std::unique_ptr<unsigned char[]>(new unsigned char[size]), size });
+    current = blocks.size() - 1;
+    used = 0;
+}
+
+EntityHandle EntityArena::adopt(Entity* entity) {
+    if (filling != NOT_FILLING) {
+        Slot& slot = slots[filling];
+        slot.entity = entity;
+        slot.built = true;
+        EntityHandle handle(filling, slot.generation);
+        filling = NOT_FILLING;
+        return handle;
+    }
+
+    if (!freeSlots.empty()) {
+        // The slot's generation moved on when its entity was destroyed
+        uint32_t index = freeSlots.back();
+        freeSlots.pop_back();
+        Slot& slot = slots[index];
+        slot.entity = entity;
+        return EntityHandle(index, slot.generation);
+    }
+
+    if (count >= EntityHandle::MAX_INDEX) {
+        // World images are checked against this limit, so this is a bug
+        std::cerr << "error: more entities than handles can address\n";
+        std::abort();
+    }
+
+    if (count == slots.size()) {
+        slots.push_back(Slot{ nullptr, 0, false });
+    }
+    Slot& slot = slots[count];
+    slot.entity = entity;
+    return EntityHandle(count++, slot.generation);
+}
+
+void EntityArena::addPlaceholders(uint32_t placeholderCount, Builder* placeholderBuilder) {
+    if (placeholderCount >= EntityHandle::MAX_INDEX) {
+        // World images are checked against this limit, so this is a bug
+        std::cerr << "error: more entities than handles can address\n";
+        std::abort();
+    }
+
+    if (slots.size() < placeholderCount) {
+        slots.resize(placeholderCount, Slot{ nullptr, 0, false });
+    }
+    count = placeholderCount;
+    placeholders = placeholderCount;
+    builder = placeholderBuilder;
+}
+
+void EntityArena::destroy(Entity* entity) {
+    EntityHandle handle = entity->getHandle();
+    if (resolve(handle) != entity) {
+        return;
+    }
+
+    // Whatever it still contains is left detached rather than pointing at it
+    for (EntityChildren contents = entity->getContains(); !contents.empty();) {
+        entity->removeEntity(*contents.begin());
+    }
+
+    // A placeholder keeps its slot, its record has no other
+    Slot& slot = slots[handle.getIndex()];
+    slot.entity = nullptr;
+    slot.generation++;
+    if (handle.getIndex() >= placeholders) {
+        freeSlots.push_back(handle.getIndex());
+    }
+    releaseRows(entity);
+}
+
+void EntityArena::releaseRows(Entity* entity) {
+    switch (entity->getType()) {
+    case EntityType::ITEM:
+        static_cast<Item*>(entity)->release();
+        break;
+    case EntityType::NPC:
+    case EntityType::PLAYER:
+        static_cast<Creature*>(entity)->release();
+        break;
+    default:
+        break;
+    }
+}
+
+std::string_view EntityArena::keepText(std::string_view text) {
+    if (text.empty()) {
+        return std::string_view();
+    }
+    char* copy = static_cast<char*>(allocate(text.size(), 1));
+    std::memcpy(copy, text.data(), text.size());
+    return std::string_view(copy, text.size());
+}
+
+void EntityArena::reserve(size_t bytes, size_t entityCount) {
+    slots.reserve(count + entityCount);
+
+    size_t free = current < blocks.size() ? blocks[current].size - used : 0;
+    for (size_t i = current + 1; i < blocks.size(); i++) {
+        free = std::max(free, blocks[i].size);
+    }
+    if (free < bytes) {
+        addBlock(bytes);
+    }
+}
+
+void EntityArena::clear() {
+    // Entities are trivially destructible and their tables are cleared
+    // whole, so ending them is only a new generation for every slot in use,
+    // which stops handles into this world from resolving; placeholders
+    // never built had handles out as well
+    for (uint32_t index = 0; index < count; index++) {
+        Slot& slot = slots[index];
+        if (slot.entity != nullptr || index < placeholders) {
+            slot.entity = nullptr;
+            slot.generation++;
+        }
+        slot.built = false;
+    }
+    count = 0;
+    freeSlots.clear();
+    placeholders = 0;
+    builder = nullptr;
+    current = 0;
+    used = 0;
+    items.clear();
+    creatures.clear();
+    names.clear();
+}
+
+void EntityArena::release() {
+    clear();
+    blocks.clear();
+    slots.clear();
+    slots.shrink_to_fit();
+    freeSlots.shrink_to_fit();
+    items = ItemTable();
+    creatures = CreatureTable();
+}
+
+size_t EntityArena::getReservedBytes() const {
+    size_t bytes = 0;
+    for (const Block& block : blocks) {
+        bytes += block.size;
+    }
+    return bytes;
+}
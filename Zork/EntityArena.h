@@ -0,0 +1,205 @@
+#pragma once
+#include "Entity.h"
+#include "EntityCast.h"
+#include "EntityComponents.h"
+#include "EntityHandle.h"
+#include "ArenaVector.h"
+#include "NameTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Storage for every entity of one world: rooms, exits, items, NPCs and the
+ * player, plus the item and creature tables their hot state lives in and
+ * the table of their names. Entities are placed one after another in large blocks instead of
+ * getting a heap allocation each, and the arena alone owns them: rooms,
+ * containers, exit tables and the player's inventory only point at entities.
+ * Everything an entity keeps (text, lists, name index buckets) is in these
+ * blocks or borrowed from a world image, so entities are trivially
+ * destructible.
+ *
+ * Each entity also gets a slot in the arena's table, and the EntityHandle
+ * of that slot is how creatures refer to their location, exits to the rooms
+ * they join and the scheduler to what it will update. The containment tree,
+ * the name indexes and the room table link entities by pointer: they only
+ * ever point at live entities of the same world, because an entity is
+ * detached before it is destroyed. destroy() ends an entity in play (a
+ * killed or sacrificed NPC), gives back its table rows, invalidates its
+ * handle by moving the slot to its next generation and puts the slot on a
+ * free list, so the next entity created takes it instead of growing the
+ * table. clear() runs no destructors: it moves every slot in use to its
+ * next generation and rewinds the blocks, keeping them and the slot
+ * generations for the next world built in it.
+ * release() also returns the memory and starts the table afresh, so no
+ * handle may be kept past it.
+ *
+ * A world can also number some entities before building them: the first
+ * slots are then placeholders whose handles are handed out (an exit's
+ * destination, a patrol stop) while the slot is still empty, and the
+ * Builder creates the entity when its handle is first resolved. A
+ * placeholder is filled once; destroying its entity does not free it.
+ */
+class EntityArena {
+public:
+    // Creates the entity of a placeholder slot, with createAt()
+    class Builder {
+    public:
+        virtual ~Builder() = default;
+        virtual Entity* build(uint32_t placeholder) = 0;
+    };
+
+    EntityArena();
+    ~EntityArena();
+
+    EntityArena(const EntityArena&) = delete;
+    EntityArena& operator=(const EntityArena&) = delete;
+
+    // Constructs an entity that the arena owns from now on; the arena is
+    // passed to the constructor ahead of 'args'
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_base_of<Entity, T>::value, "the arena only holds entities");
+        return new (allocate(sizeof(T), alignof(T))) T(*this, std::forward<Args>(args)...);
+    }
+
+    // create() into an empty placeholder slot
+    template <typename T, typename... Args>
+    T* createAt(uint32_t placeholder, Args&&... args) {
+        filling = placeholder;
+        return create<T>(std::forward<Args>(args)...);
+    }
+
+    // Makes the first 'count' slots of an empty arena placeholders, built
+    // by 'builder' when first resolved (nullptr if they are all created
+    // with createAt() before that)
+    void addPlaceholders(uint32_t count, Builder* builder);
+
+    // Handle of a placeholder slot, whether or not it has been built
+    EntityHandle placeholder(uint32_t index) const {
+        return EntityHandle(index, slots[index].generation);
+    }
+
+    // Whether a placeholder has been filled, even if its entity was destroyed since
+    bool wasBuilt(uint32_t placeholder) const { return slots[placeholder].built; }
+
+    // Zeroed array that lives in the arena until the next clear(), for
+    // tables the entities keep, e.g. the buckets of a NameIndex
+    template <typename T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "the arena never destroys arrays");
+        void* memory = allocate(sizeof(T) * count, alignof(T));
+        std::memset(memory, 0, sizeof(T) * count);
+        return static_cast<T*>(memory);
+    }
+
+    // Copy of 'text' that lives until the next clear(), empty text costs nothing
+    std::string_view keepText(std::string_view text);
+
+    // Destroys one entity now; the caller has already detached it, and
+    // anything still inside it is detached here
+    void destroy(Entity* entity);
+
+    // The entity a handle refers to, nullptr once it has been destroyed;
+    // not const, since resolving a placeholder builds its entity
+    Entity* resolve(EntityHandle handle) {
+        uint32_t index = handle.getIndex();
+        if (index >= count || slots[index].generation != handle.getGeneration()) {
+            return nullptr;
+        }
+        const Slot& slot = slots[index];
+        return slot.entity != nullptr || slot.built || index >= placeholders ? slot.entity : builder->build(index);
+    }
+
+    // resolve() for an entity of a known class, nullptr if it is another kind
+    template <typename T>
+    T* get(EntityHandle handle) {
+        return entity_cast<T>(resolve(handle));
+    }
+
+    // The entity a handle refers to if it exists, without building a
+    // placeholder: nullptr for one not built yet
+    const Entity* find(EntityHandle handle) const {
+        uint32_t index = handle.getIndex();
+        return index < count && slots[index].generation == handle.getGeneration() ? slots[index].entity : nullptr;
+    }
+
+    template <typename T>
+    const T* find(EntityHandle handle) const {
+        return entity_cast<T>(find(handle));
+    }
+
+    // Makes sure the next 'bytes' of entities fit without another block
+    void reserve(size_t bytes, size_t entityCount);
+
+    // Ends every entity at once, keeping the memory for reuse
+    void clear();
+
+    // Destroys every entity and frees the memory
+    void release();
+
+    // Hot item and creature state, a row per entity of that kind
+    ItemTable& getItems() { return items; }
+    const ItemTable& getItems() const { return items; }
+    CreatureTable& getCreatures() { return creatures; }
+    const CreatureTable& getCreatures() const { return creatures; }
+
+    // Lowercase names of the entities, cleared with them
+    NameTable& getNames() { return names; }
+    const NameTable& getNames() const { return names; }
+
+    size_t getEntityCount() const { return count - freeSlots.size(); }
+    size_t getReservedBytes() const;
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> memory;
+        size_t size;
+    };
+
+    struct Slot {
+        Entity* entity;         // nullptr once destroyed
+        uint8_t generation;
+        bool built;             // A placeholder that has been filled
+    };
+
+    static constexpr size_t FIRST_BLOCK_SIZE = 16 * 1024;
+    static constexpr size_t MAX_BLOCK_SIZE = 4 * 1024 * 1024;
+
+    std::vector<Block> blocks;
+    size_t current = 0;     // Block being filled
+    size_t used = 0;        // Bytes used in that block
+
+    // Slots of this world's entities; those past 'count' only remember
+    // their generation from earlier worlds
+    std::vector<Slot> slots;
+    uint32_t count = 0;
+    std::vector<uint32_t> freeSlots;    // Below 'count' but destroyed, taken last in first out
+    uint32_t placeholders = 0;          // Slots below this are placeholders
+    Builder* builder = nullptr;
+    uint32_t filling = NOT_FILLING;     // Placeholder the entity being created goes into
+
+    static constexpr uint32_t NOT_FILLING = ~0u;
+
+    ItemTable items;
+    CreatureTable creatures;
+    NameTable names;
+
+    // Gives back what an entity holds in the tables above
+    void releaseRows(Entity* entity);
+
+    void* allocate(size_t size, size_t alignment);
+    void addBlock(size_t minimumSize);
+
+    // Growth of the ArenaVectors entities keep
+    friend void* AllocateInArena(EntityArena& arena, size_t size, size_t alignment);
+
+    // Gives a new entity its slot, called by the Entity constructor
+    friend class Entity;
+    EntityHandle adopt(Entity* entity);
+};
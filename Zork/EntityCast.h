@@ -0,0 +1,84 @@
+#pragma once
+#include "Entity.h"
+#include <cstdlib>
+#include <type_traits>
+
+class Creature;
+class Exit;
+class Item;
+class NPC;
+class Player;
+class Room;
+
+/**
+ * Kind checks and downcasts for entities, keyed on the EntityType every
+ * entity carries instead of RTTI. Entities have no virtual functions, so
+ * dynamic_cast does not apply to them; use entity_cast<T>() where the kind
+ * is not known, and a plain static_cast where getType() was just checked.
+ *
+ * VisitEntity() calls a visitor with the entity as its concrete class
+ * (Room, Exit, Item, Player or NPC). This is how look() reaches the
+ * right class; the caller includes the headers of those classes.
+ */
+
+// Whether an entity of 'type' is a T
+template <typename T>
+struct EntityKind {
+    static bool Matches(EntityType type) { return type == T::TYPE; }
+};
+
+template <>
+struct EntityKind<Entity> {
+    static bool Matches(EntityType) { return true; }
+};
+
+template <>
+struct EntityKind<Creature> {
+    static bool Matches(EntityType type) { return type == EntityType::PLAYER || type == EntityType::NPC; }
+};
+
+template <typename T>
+bool IsEntity(const Entity* entity) {
+    return entity != nullptr && EntityKind<T>::Matches(entity->getType());
+}
+
+// The entity as a T, nullptr if it is null or of another kind
+template <typename T>
+T* entity_cast(Entity* entity) {
+    return IsEntity<T>(entity) ? static_cast<T*>(entity) : nullptr;
+}
+
+template <typename T>
+const T* entity_cast(const Entity* entity) {
+    return IsEntity<T>(entity) ? static_cast<const T*>(entity) : nullptr;
+}
+
+// T with the constness of E
+template <typename E, typename T>
+using MatchConst = std::conditional_t<std::is_const<E>::value, const T, T>;
+
+// Calls visitor(entity) with 'entity' as its concrete class; E is Entity or const Entity
+template <typename E, typename Visitor>
+void VisitEntity(E& entity, Visitor&& visitor) {
+    static_assert(std::is_same<std::remove_const_t<E>, Entity>::value, "visit through an Entity reference");
+    switch (entity.getType()) {
+    case EntityType::ROOM:
+        visitor(static_cast<MatchConst<E, Room>&>(entity));
+        return;
+    case EntityType::EXIT:
+        visitor(static_cast<MatchConst<E, Exit>&>(entity));
+        return;
+    case EntityType::ITEM:
+        visitor(static_cast<MatchConst<E, Item>&>(entity));
+        return;
+    case EntityType::PLAYER:
+        visitor(static_cast<MatchConst<E, Player>&>(entity));
+        return;
+    case EntityType::NPC:
+        visitor(static_cast<MatchConst<E, NPC>&>(entity));
+        return;
+    default:
+        // ENTITY and CREATURE only name base classes, nothing is made with them
+        std::abort();
+    }
+}
@@ -0,0 +1,68 @@
+#include "EntityComponents.h"
+
+// ========== Items ==========
+
+uint32_t ItemTable::add(Item* item, uint8_t itemFlags, int capacity) {
+    if (!freeRows.empty()) {
+        uint32_t row = freeRows.back();
+        freeRows.pop_back();
+        items[row] = item;
+        flags[row] = itemFlags;
+        capacities[row] = capacity;
+        return row;
+    }
+
+    items.push_back(item);
+    flags.push_back(itemFlags);
+    capacities.push_back(capacity);
+    return static_cast<uint32_t>(items.size() - 1);
+}
+
+void ItemTable::remove(uint32_t row) {
+    // Rows stay put so no other item's row changes
+    items[row] = nullptr;
+    flags[row] = 0;
+    freeRows.push_back(row);
+}
+
+void ItemTable::clear() {
+    items.clear();
+    flags.clear();
+    capacities.clear();
+    freeRows.clear();
+}
+
+// ========== Creatures ==========
+
+uint32_t CreatureTable::add(Creature* creature, EntityHandle location, int startingHealth) {
+    if (!freeRows.empty()) {
+        uint32_t row = freeRows.back();
+        freeRows.pop_back();
+        creatures[row] = creature;
+        locations[row] = location;
+        health[row] = startingHealth;
+        maxHealth[row] = startingHealth;
+        return row;
+    }
+
+    creatures.push_back(creature);
+    locations.push_back(location);
+    health.push_back(startingHealth);
+    maxHealth.push_back(startingHealth);
+    return static_cast<uint32_t>(creatures.size() - 1);
+}
+
+void CreatureTable::remove(uint32_t row) {
+    creatures[row] = nullptr;
+    locations[row] = EntityHandle::None();
+    health[row] = 0;
+    freeRows.push_back(row);
+}
+
+void CreatureTable::clear() {
+    creatures.clear();
+    locations.clear();
+    health.clear();
+    maxHealth.clear();
+    freeRows.clear();
+}
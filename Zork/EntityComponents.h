@@ -0,0 +1,66 @@
+#pragma once
+#include "EntityHandle.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Creature;
+class Item;
+
+/**
+ * The state play reads and changes about items, one dense column per
+ * attribute with a row per item. Queries such as "every lit item" scan one
+ * byte per item instead of visiting item objects; names, descriptions and
+ * contents stay with the Item itself. Rows of destroyed items are handed
+ * to the next items added, so the columns grow only with the most items
+ * alive at once.
+ */
+class ItemTable {
+public:
+    // Bits of the flags column
+    static constexpr uint8_t CONTAINER = 1u << 0;
+    static constexpr uint8_t FRAGMENT = 1u << 1;
+    static constexpr uint8_t LIT = 1u << 2;
+    static constexpr uint8_t FIXED = 1u << 3;
+
+    std::vector<Item*> items;       // nullptr once destroyed
+    std::vector<uint8_t> flags;
+    std::vector<int32_t> capacities;
+    std::vector<uint32_t> freeRows;     // Rows of destroyed items, reused first
+
+    uint32_t add(Item* item, uint8_t itemFlags, int capacity);
+    void remove(uint32_t row);
+    void clear();
+
+    size_t size() const { return items.size(); }
+
+    // Visits every live item with all of 'mask' set, in row order
+    template <typename Visit>
+    void forEachWith(uint8_t mask, Visit visit) const {
+        for (size_t row = 0; row < flags.size(); row++) {
+            if ((flags[row] & mask) == mask && items[row] != nullptr) {
+                visit(items[row]);
+            }
+        }
+    }
+};
+
+/**
+ * Location and health of every creature (the player and NPCs), one dense
+ * column per attribute with a row per creature. Like ItemTable it hands
+ * the rows of destroyed creatures to the next ones added.
+ */
+class CreatureTable {
+public:
+    std::vector<Creature*> creatures;   // nullptr once destroyed
+    std::vector<EntityHandle> locations;
+    std::vector<int32_t> health;
+    std::vector<int32_t> maxHealth;
+    std::vector<uint32_t> freeRows;     // Rows of destroyed creatures, reused first
+
+    uint32_t add(Creature* creature, EntityHandle location, int startingHealth);
+    void remove(uint32_t row);
+    void clear();
+
+    size_t size() const { return creatures.size(); }
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * 32-bit reference to an entity in a world's EntityArena: the entity's slot
+ * in the low 24 bits and the slot's generation in the high 8. A slot's
+ * generation changes whenever its entity is destroyed, so a handle kept past
+ * that (to a killed NPC, or into a world that was reset) no longer resolves
+ * instead of pointing at whatever took the slot. Handles hold no addresses,
+ * so state made of them stays valid when copied byte for byte.
+ */
+class EntityHandle {
+public:
+    static constexpr uint32_t INDEX_BITS = 24;
+    static constexpr uint32_t MAX_INDEX = (1u << INDEX_BITS) - 1;   // Reserved for NONE
+
+    constexpr EntityHandle() : value(NONE_VALUE) {}
+    constexpr EntityHandle(uint32_t index, uint8_t generation) :
+        value((static_cast<uint32_t>(generation) << INDEX_BITS) | index) {
+    }
+
+    static constexpr EntityHandle None() { return EntityHandle(); }
+
+    uint32_t getIndex() const { return value & MAX_INDEX; }
+    uint8_t getGeneration() const { return static_cast<uint8_t>(value >> INDEX_BITS); }
+    uint32_t getValue() const { return value; }
+    bool isNone() const { return value == NONE_VALUE; }
+
+    bool operator==(EntityHandle other) const { return value == other.value; }
+    bool operator!=(EntityHandle other) const { return value != other.value; }
+
+private:
+    static constexpr uint32_t NONE_VALUE = 0xFFFFFFFFu;
+    uint32_t value;
+};
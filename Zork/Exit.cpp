@@ -1,17 +1,21 @@
 ﻿#include "Exit.h"
+#include "EntityArena.h"
 #include "GameEnums.h"
 #include "Room.h" 
-#include <iostream>
+#include "GameIO.h"
+#include "WorldGraph.h"
 
-Exit::Exit(Direction direction, Room* source, Room* destination,
+Exit::Exit(EntityArena& arena, Direction direction, Room* source, Room* destination,
     const string& name, const string& description,
     bool locked, const string& keyName) :
-    Entity(EntityType::EXIT, name, description),
+    Entity(arena, EntityType::EXIT, name, description),
     direction(direction),
-    source(source),
-    destination(destination),
+    source(source != nullptr ? source->getHandle() : EntityHandle::None()),
+    destination(destination != nullptr ? destination->getHandle() : EntityHandle::None()),
     locked(locked),
-    keyName(keyName)
+    keyName(arena.keepText(keyName)),
+    graph(nullptr),
+    graphEdge(-1)
 {
     // Automatically register this exit with the source room
     if (source != nullptr) {
@@ -19,26 +23,48 @@ Exit::Exit(Direction direction, Room* source, Room* destination,
     }
 }
 
+Exit::Exit(EntityArena& arena, Direction direction, Room* source, EntityHandle destination,
+    BorrowedText name, BorrowedText description,
+    bool locked, BorrowedText keyName) :
+    Entity(arena, EntityType::EXIT, name, description),
+    direction(direction),
+    source(source != nullptr ? source->getHandle() : EntityHandle::None()),
+    destination(destination),
+    locked(locked),
+    keyName(keyName.text),
+    graph(nullptr),
+    graphEdge(-1)
+{
+    if (source != nullptr) {
+        source->setExit(direction, this);
+    }
+}
+
 Direction Exit::getDirection() const {
     return direction;
 }
 
 Room* Exit::getSource() const {
-    return source;
+    return arena->get<Room>(source);
 }
 
 Room* Exit::getDestination() const {
-    return destination;
+    return arena->get<Room>(destination);
 }
 
 bool Exit::isLocked() const {
     return locked;
 }
 
-const string& Exit::getKeyName() const {
+std::string_view Exit::getKeyName() const {
     return keyName;
 }
 
+void Exit::attachToGraph(GraphChanges* changes, int edge) {
+    graph = changes;
+    graphEdge = edge;
+}
+
 Direction Exit::getReverseDirection() const {
     switch (direction) {
     case Direction::NORTH: return Direction::SOUTH;
@@ -53,10 +79,13 @@ Direction Exit::getReverseDirection() const {
 
 // ========== Actions ==========
 
-bool Exit::unlock(const string& key) {
+bool Exit::unlock(std::string_view key) {
     // Check if the provided key matches the required key
     if (key == keyName) {
         locked = false;
+        if (graph != nullptr) {
+            graph->onUnlocked(graphEdge);
+        }
         return true;
     }
     return false;
@@ -64,13 +93,13 @@ bool Exit::unlock(const string& key) {
 
 void Exit::look() const {
     // Display basic entity information
-    Entity::look();
+    describe();
 
     // Display lock status if locked
     if (locked) {
-        std::cout << "The exit is locked. You need " << keyName << " to unlock it." << std::endl;
+        GameIO::Out() << "The exit is locked. You need " << keyName << " to unlock it." << std::endl;
     }
     else {
-        std::cout << "This exit leads to " << destination->getName() << "." << std::endl;
+        GameIO::Out() << "This exit leads to " << getDestination()->getName() << "." << std::endl;
     }
 }
\ No newline at end of file
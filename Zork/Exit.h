@@ -2,30 +2,42 @@
 #include "Entity.h"
 #include "GameEnums.h"
 
+class GraphChanges;
 class Room;
 
 class Exit : public Entity {
 private:
     Direction direction;  // Direction this exit connects from source room
-    Room* source;         // The room this exit leads from
-    Room* destination;    // The room this exit leads to
+    EntityHandle source;        // The room this exit leads from
+    EntityHandle destination;   // The room this exit leads to
     bool locked;          // Whether this exit is currently locked
-    string keyName;       // Name of the key required to unlock this exit
+    std::string_view keyName;   // Name of the key required to unlock this exit, kept in the arena or borrowed
+    GraphChanges* graph;  // Session's graph changes told about unlocks, if any
+    int graphEdge;        // This exit's edge in the graph
 
     Direction getReverseDirection() const;  // Gets the opposite direction
 
 public:
-    Exit(Direction direction, Room* source, Room* destination,
+    static constexpr EntityType TYPE = EntityType::EXIT;
+
+    Exit(EntityArena& arena, Direction direction, Room* source, Room* destination,
         const string& name, const string& description,
         bool locked = false, const string& keyName = "");
+    // The destination may be a room not built yet, see EntityArena::placeholder()
+    Exit(EntityArena& arena, Direction direction, Room* source, EntityHandle destination,
+        BorrowedText name, BorrowedText description,
+        bool locked = false, BorrowedText keyName = BorrowedText(std::string_view()));
 
     Direction getDirection() const;
     Room* getSource() const;
     Room* getDestination() const;
     bool isLocked() const;
-    const string& getKeyName() const;
+    std::string_view getKeyName() const;
+
+    // Links the exit to its graph edge (nullptr detaches)
+    void attachToGraph(GraphChanges* changes, int edge);
 
     // Actions
-    bool unlock(const string& key);
-    void look() const override;
+    bool unlock(std::string_view key);
+    void look() const;
 };
\ No newline at end of file
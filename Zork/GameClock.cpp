@@ -0,0 +1,123 @@
+#include "GameClock.h"
+#include <algorithm>
+
+GameClock::GameClock(Mode mode, double speed) :
+    mode(mode),
+    speed(speed > 0.0 ? speed : 1.0),
+    currentTime(0),
+    currentTurn(0),
+    nextId(1),
+    lastSync(WallClock::now()) {
+}
+
+// ========== Timer Management ==========
+
+GameClock::TimerId GameClock::scheduleAfter(long long delayMs, Callback callback) {
+    sync();
+
+    TimerId id = nextId++;
+    long long due = currentTime + std::max(0LL, delayMs);
+    timers.emplace(std::make_pair(due, id), std::move(callback));
+    timerDue[id] = due;
+    return id;
+}
+
+GameClock::TimerId GameClock::scheduleEveryTurn(int interval, Callback callback) {
+    TimerId id = nextId++;
+    interval = std::max(1, interval);
+    turnTimers.push_back({ id, interval, currentTurn + interval, std::move(callback) });
+    return id;
+}
+
+void GameClock::cancel(TimerId id) {
+    auto due = timerDue.find(id);
+    if (due != timerDue.end()) {
+        timers.erase(std::make_pair(due->second, id));
+        timerDue.erase(due);
+        return;
+    }
+
+    turnTimers.erase(std::remove_if(turnTimers.begin(), turnTimers.end(),
+        [id](const TurnTimer& timer) { return timer.id == id; }), turnTimers.end());
+}
+
+// ========== Advancing Time ==========
+
+void GameClock::advanceTurn() {
+    currentTurn++;
+
+    // Callbacks may add or cancel turn timers, so walk by id rather than iterator
+    std::vector<TimerId>& due = dueTurnTimers;
+    due.clear();
+    for (const auto& timer : turnTimers) {
+        if (timer.nextTurn <= currentTurn) {
+            due.push_back(timer.id);
+        }
+    }
+
+    for (TimerId id : due) {
+        auto it = std::find_if(turnTimers.begin(), turnTimers.end(),
+            [id](const TurnTimer& timer) { return timer.id == id; });
+        if (it == turnTimers.end()) {
+            continue; // Cancelled by an earlier callback
+        }
+        it->nextTurn = currentTurn + it->interval;
+        Callback callback = it->callback;
+        callback();
+    }
+}
+
+void GameClock::poll() {
+    sync();
+
+    while (!timers.empty()) {
+        auto next = timers.begin();
+        long long due = next->first.first;
+        if (mode != Mode::INSTANT && due > currentTime) {
+            break;
+        }
+
+        currentTime = std::max(currentTime, due);
+        Callback callback = std::move(next->second);
+        timerDue.erase(next->first.second);
+        timers.erase(next);
+        callback();
+    }
+}
+
+std::chrono::milliseconds GameClock::timeUntilNextTimer() const {
+    if (timers.empty() || mode == Mode::INSTANT) {
+        return std::chrono::milliseconds(0);
+    }
+
+    double elapsed = std::chrono::duration<double, std::milli>(WallClock::now() - lastSync).count();
+    double remaining = (timers.begin()->first.first - currentTime) / getScale() - elapsed;
+    return std::chrono::milliseconds(static_cast<long long>(std::max(0.0, remaining)));
+}
+
+// ========== Wall-Clock Mapping ==========
+
+void GameClock::sync() {
+    if (mode == Mode::INSTANT) {
+        return;
+    }
+
+    // Only move forward through time that has pending work, idle time is not simulated
+    WallClock::time_point wallNow = WallClock::now();
+    if (timers.empty()) {
+        lastSync = wallNow;
+        return;
+    }
+
+    double elapsed = std::chrono::duration<double, std::milli>(wallNow - lastSync).count();
+    long long advance = static_cast<long long>(elapsed * getScale());
+    currentTime += advance;
+
+    // Keep the fractional remainder so frequent polls still make progress
+    lastSync += std::chrono::duration_cast<WallClock::duration>(
+        std::chrono::duration<double, std::milli>(advance / getScale()));
+}
+
+double GameClock::getScale() const {
+    return mode == Mode::ACCELERATED ? speed : 1.0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <chrono>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+/**
+ * Virtual simulation clock of a game session.
+ * Turn timers fire as the game advances turn by turn. Timed timers run on
+ * virtual milliseconds which map to wall-clock time depending on the mode:
+ *  - REAL_TIME:   1 virtual ms per wall ms (interactive play)
+ *  - ACCELERATED: 'speed' virtual ms per wall ms
+ *  - INSTANT:     pending timers fire as soon as the clock is polled
+ * The clock never sleeps; hosts wait timeUntilNextTimer() and poll again.
+ */
+class GameClock {
+public:
+    enum class Mode {
+        REAL_TIME,
+        ACCELERATED,
+        INSTANT
+    };
+
+    using Callback = std::function<void()>;
+    using TimerId = unsigned int;
+
+    explicit GameClock(Mode mode = Mode::REAL_TIME, double speed = 1.0);
+
+    // Timer management
+    TimerId scheduleAfter(long long delayMs, Callback callback);
+    TimerId scheduleEveryTurn(int interval, Callback callback);
+    void cancel(TimerId id);
+
+    // Advancing time
+    void advanceTurn();
+    void poll();
+
+    // Queries
+    Mode getMode() const { return mode; }
+    long long now() const { return currentTime; }
+    int getTurn() const { return currentTurn; }
+    bool hasPendingTimers() const { return !timers.empty(); }
+    std::chrono::milliseconds timeUntilNextTimer() const;
+
+private:
+    using WallClock = std::chrono::steady_clock;
+
+    struct TurnTimer {
+        TimerId id;
+        int interval;
+        int nextTurn;
+        Callback callback;
+    };
+
+    Mode mode;
+    double speed;                 // Virtual ms per wall ms (ACCELERATED only)
+    long long currentTime;        // Virtual milliseconds
+    int currentTurn;
+    TimerId nextId;
+    WallClock::time_point lastSync;
+
+    std::map<std::pair<long long, TimerId>, Callback> timers;  // Ordered by due time, then creation
+    std::map<TimerId, long long> timerDue;
+    std::vector<TurnTimer> turnTimers;
+    std::vector<TimerId> dueTurnTimers;   // Scratch list reused by advanceTurn()
+
+    void sync();
+    double getScale() const;
+};
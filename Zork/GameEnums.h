@@ -11,6 +11,9 @@ enum class Direction {
     DOWN    
 };
 
+// Number of directions, Direction values index arrays of this size
+constexpr int DIRECTION_COUNT = 6;
+
 /**
  * Converts Direction enum to readable string
  * @return String representation ("north", "south", etc.)
@@ -25,4 +28,161 @@ inline std::string directionToString(Direction direction) {
     case Direction::DOWN:  return "down";
     default:  return "unknown";
     }
-}
\ No newline at end of file
+}
+
+// How a game session ended
+enum class Ending {
+    NONE,             // Still in progress
+    LEGENDARY_HERO,
+    SAVIOR,
+    TYRANT,
+    CONSUMED,
+    AGE_OF_BALANCE,
+    PYRRHIC_VICTORY,
+    EVIL_DEATH,       // Killed in the darkness with an evil alignment
+    DEATH,
+    QUIT
+};
+
+/**
+ * Converts Ending enum to readable string
+ * @return String representation ("legendary hero", "quit", etc.)
+ */
+inline std::string endingToString(Ending ending) {
+    switch (ending) {
+    case Ending::NONE:            return "none";
+    case Ending::LEGENDARY_HERO:  return "legendary hero";
+    case Ending::SAVIOR:          return "savior of eldoria";
+    case Ending::TYRANT:          return "rise of a tyrant";
+    case Ending::CONSUMED:        return "consumed by power";
+    case Ending::AGE_OF_BALANCE:  return "age of balance";
+    case Ending::PYRRHIC_VICTORY: return "pyrrhic victory";
+    case Ending::EVIL_DEATH:      return "evil ending";
+    case Ending::DEATH:           return "game over";
+    case Ending::QUIT:            return "quit";
+    default:  return "unknown";
+    }
+}
+
+// A question the game has asked and is waiting on; the next input line is the answer
+enum class Prompt {
+    NONE,
+    GIVE_REQUIRED_ITEM,   // Hand an NPC the item it asked for
+    IMPORTANT_INFO,       // What to make of an NPC's rumor
+    DIALOGUE,             // A choice in an NPC's dialogue graph, see Player::getPromptAnswers()
+    DROP_LANTERN,         // Confirm dropping a lit lantern in the dark
+    AMULET_ENDING         // What to do with the amulet at the altar
+};
+
+/**
+ * Answers a prompt offers, for hosts that show them as buttons or menus
+ * @return The accepted answers; anything else declines or keeps things as they are
+ */
+inline std::string promptAnswers(Prompt prompt) {
+    switch (prompt) {
+    case Prompt::NONE:
+    case Prompt::DIALOGUE:      return "";
+    case Prompt::IMPORTANT_INFO: return "1 2 3";
+    case Prompt::AMULET_ENDING: return "1 2 3 4";
+    default:                    return "yes no";
+    }
+}
+
+// What a dialogue edge needs before the conversation may follow it
+enum class DialogueCondition {
+    ALWAYS,
+    HAS_ITEM,             // The player carries the named item
+    LACKS_ITEM,
+    ALIGNMENT_AT_LEAST,   // The player's alignment is at least the value
+    ALIGNMENT_BELOW,
+    TRUSTED,              // The NPC trusts the player
+    DISTRUSTED,
+    REWARD_PENDING,       // The NPC has not handed out its reward yet
+    REWARD_GIVEN
+};
+
+constexpr int DIALOGUE_CONDITION_COUNT = 9;
+
+/**
+ * Converts DialogueCondition enum to its world source word
+ * @return String representation ("always", "has", etc.)
+ */
+inline std::string dialogueConditionToString(DialogueCondition condition) {
+    switch (condition) {
+    case DialogueCondition::ALWAYS:             return "always";
+    case DialogueCondition::HAS_ITEM:           return "has";
+    case DialogueCondition::LACKS_ITEM:         return "lacks";
+    case DialogueCondition::ALIGNMENT_AT_LEAST: return "alignment-at-least";
+    case DialogueCondition::ALIGNMENT_BELOW:    return "alignment-below";
+    case DialogueCondition::TRUSTED:            return "trusted";
+    case DialogueCondition::DISTRUSTED:         return "distrusted";
+    case DialogueCondition::REWARD_PENDING:     return "reward-pending";
+    case DialogueCondition::REWARD_GIVEN:       return "reward-given";
+    default:  return "unknown";
+    }
+}
+
+// One step a dialogue node takes when the conversation reaches it
+enum class DialogueAction {
+    SAY,                  // Prints the text as a line, {npc} and {player} replaced by the names
+    GIVE_ITEM,            // Puts a new item (name, description) in the player's inventory
+    TAKE_ITEM,            // Takes the named item from the player
+    ALIGNMENT,            // That many altruistic choices, or selfish ones when negative
+    TRUST,                // The NPC trusts the player (value 1) or stops trusting them (0)
+    REWARD_GIVEN,         // The NPC's reward has been handed out
+    END_INTERACTIONS,     // The NPC will not talk to the player again
+    TALK                  // The NPC's usual lines, as from the talk command
+};
+
+constexpr int DIALOGUE_ACTION_COUNT = 8;
+
+/**
+ * Converts DialogueAction enum to its world source word
+ * @return String representation ("say", "give", etc.)
+ */
+inline std::string dialogueActionToString(DialogueAction action) {
+    switch (action) {
+    case DialogueAction::SAY:              return "say";
+    case DialogueAction::GIVE_ITEM:        return "give";
+    case DialogueAction::TAKE_ITEM:        return "take";
+    case DialogueAction::ALIGNMENT:        return "alignment";
+    case DialogueAction::TRUST:            return "trust";
+    case DialogueAction::REWARD_GIVEN:     return "reward-given";
+    case DialogueAction::END_INTERACTIONS: return "end";
+    case DialogueAction::TALK:             return "talk";
+    default:  return "unknown";
+    }
+}
+
+// What an NPC does on its own between the player's turns
+enum class NpcBehavior {
+    STILL,                // Stays put; only says its announcement, if it has one
+    WANDER,               // Leaves through an unlocked exit picked at random
+    PATROL                // Walks its route of patrol stops, round and round
+};
+
+constexpr int NPC_BEHAVIOR_COUNT = 3;
+
+/**
+ * Converts NpcBehavior enum to its world source word
+ * @return String representation ("still", "wander", "patrol")
+ */
+inline std::string npcBehaviorToString(NpcBehavior behavior) {
+    switch (behavior) {
+    case NpcBehavior::STILL:  return "still";
+    case NpcBehavior::WANDER: return "wander";
+    case NpcBehavior::PATROL: return "patrol";
+    default:  return "unknown";
+    }
+}
+
+// Items the game itself hands out during play, in the order of their
+// prototypes (see ItemPrototype::Stock)
+enum class StockItem {
+    BLACKSMITH_KEY,       // Taken from the Blacksmith by force or by stealth
+    HERMIT_FRAGMENT,      // Taken from the Hermit by force or by stealth
+    VILLAGE_BREAD,        // Extorted from the villagers
+    AMULET                // The restored Amulet of Eldoria
+};
+
+constexpr int STOCK_ITEM_COUNT = 4;
@@ -0,0 +1,41 @@
+#include "GameIO.h"
+
+static thread_local GameIO* currentIO = nullptr;
+
+GameIO& GameIO::Current() {
+    static thread_local ConsoleIO console;
+    return currentIO != nullptr ? *currentIO : console;
+}
+
+GameIO::Scope::Scope(GameIO& io) : previous(currentIO) {
+    currentIO = &io;
+}
+
+GameIO::Scope::~Scope() {
+    currentIO = previous;
+}
+
+// ========== Console ==========
+
+bool ConsoleIO::readLine(std::string& line) {
+    return static_cast<bool>(std::getline(std::cin, line));
+}
+
+// ========== Buffered ==========
+
+bool BufferedIO::readLine(std::string& line) {
+    if (input.empty()) {
+        line.clear();
+        return false;
+    }
+    line = input.front();
+    input.pop_front();
+    return true;
+}
+
+std::string BufferedIO::takeOutput() {
+    std::string text = output.str();
+    output.str("");
+    output.clear();
+    return text;
+}
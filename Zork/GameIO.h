@@ -0,0 +1,57 @@
+#pragma once
+#include <deque>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+/**
+ * Input/output channel of a game session.
+ * Game code never touches std::cin/std::cout directly; it writes to
+ * GameIO::Out(), which resolves to the channel of the session currently
+ * running on this thread. Game code never reads either: questions wait for
+ * the host's next step() (see Player::ask), and hosts read their own input.
+ */
+class GameIO {
+public:
+    virtual ~GameIO() = default;
+
+    virtual std::ostream& out() = 0;
+    virtual bool readLine(std::string& line) = 0;
+
+    // Channel of the session active on this thread (console if none)
+    static GameIO& Current();
+    static std::ostream& Out() { return Current().out(); }
+
+    // Makes an IO channel current for the lifetime of the scope
+    class Scope {
+    public:
+        explicit Scope(GameIO& io);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        GameIO* previous;
+    };
+};
+
+// Standard console channel (std::cin/std::cout)
+class ConsoleIO : public GameIO {
+public:
+    std::ostream& out() override { return std::cout; }
+    bool readLine(std::string& line) override;
+};
+
+// In-memory channel for embedded hosts: queued input lines, captured output
+class BufferedIO : public GameIO {
+private:
+    std::ostringstream output;
+    std::deque<std::string> input;
+
+public:
+    std::ostream& out() override { return output; }
+    bool readLine(std::string& line) override;
+
+    void pushInput(const std::string& line) { input.push_back(line); }
+    std::string takeOutput();
+};
@@ -0,0 +1,147 @@
+#pragma once
+#include "CommandTable.h"
+#include "GameClock.h"
+#include "GameEnums.h"
+#include "GameIO.h"
+#include "Player.h"
+#include "Tokenizer.h"
+#include "World.h"
+#include "WorldDelta.h"
+#include "WorldTemplate.h"
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Outcome of a single GameSession::step()
+struct TurnResult {
+    bool gameOver = false;  // The session ended this turn (quit, ending or death)
+    bool playerAlive = true;
+    int health = 0;
+    int alignment = 0;
+    int moves = 0;
+    Ending ending = Ending::NONE;
+    bool turnPending = false;                    // A timed sequence is still running, poll() again
+    std::chrono::milliseconds nextWakeup{ 0 };   // Wall-clock time until the next poll() is due
+    Prompt prompt = Prompt::NONE;                // Question the next step() answers (see Player::getPromptAnswers)
+};
+
+/**
+ * One independent game: its own world, player and IO channel.
+ * Hosts drive it with step(command); the console binary is one such host.
+ */
+class GameSession {
+private:
+    GameIO& io;
+    GameClock clock;
+    std::shared_ptr<const WorldTemplate> worldTemplate;
+    World world;
+    Player* player;               // Owned by the world
+    bool parked;                  // World and player released, 'delta' holds them
+    WorldDelta delta;
+
+    bool running;
+    bool turnSuspended;           // Current turn waits on clock timers
+    std::deque<std::string> pendingCommands;
+    Tokenizer tokenizer;          // Token buffer reused every turn
+
+    int darknessTurns;            // Track turns spent in darkness
+    bool darknessWarningGiven;    // Track if warning has been given
+
+    void Unpark();
+    void RunPendingCommands();
+    void RunLine(const std::string& line);
+    void BeginTurn(const std::string& command);
+    void ResolveTurn(const std::vector<std::string_view>& tokens, bool attacked = false);
+    void AnswerPrompt(const std::string& answer);
+    void FinishTurn(bool gameEnded, bool countsAsMove);
+    bool InDarkness() const;
+
+    // Unseen creatures strike before a command in darkness; the player may
+    // die of it once the command has run
+    void DarknessAttack();
+    void DieInDarkness();
+
+    // Clock timers
+    void BurnLantern();
+    void UpdateWorld();
+
+    void PrintWelcome() const;
+    void PrintHelp() const;
+    TurnResult MakeResult() const;
+
+    // Everything a command handler needs to know about the current command
+    struct CommandContext {
+        const std::vector<std::string_view>& tokens;
+        const std::string& argument;    // Words after the verb, space separated
+        const VerbInfo& verb;
+        Player& player;
+        bool inDarkness;
+    };
+
+    // Handlers return true when the command ends the game
+    using Handler = bool (GameSession::*)(const CommandContext& context);
+    static const Handler HANDLERS[];
+    std::string argument;         // Reused by every command
+
+    bool ProcessCommand(const std::vector<std::string_view>& tokens, Player& player);
+    bool HandleGo(const CommandContext& context);
+    bool HandleMove(const CommandContext& context);
+    bool HandleLook(const CommandContext& context);
+    bool HandleTake(const CommandContext& context);
+    bool HandleDrop(const CommandContext& context);
+    bool HandleInventory(const CommandContext& context);
+    bool HandleExamine(const CommandContext& context);
+    bool HandleUse(const CommandContext& context);
+    bool HandleCombine(const CommandContext& context);
+    bool HandlePlace(const CommandContext& context);
+    bool HandleTalk(const CommandContext& context);
+    bool HandleFlee(const CommandContext& context);
+    bool HandleSacrifice(const CommandContext& context);
+    bool HandleForgive(const CommandContext& context);
+    bool HandleCorrupt(const CommandContext& context);
+    bool HandleAlignment(const CommandContext& context);
+    bool HandleHelp(const CommandContext& context);
+    bool HandleQuit(const CommandContext& context);
+    bool HandleAttack(const CommandContext& context);
+    bool HandleSteal(const CommandContext& context);
+    bool HandleTravel(const CommandContext& context);
+
+    // Walks to a room by name along the shortest known route
+    void TravelTo(std::string_view destination, Player& player);
+
+public:
+    // Plays a shared world template, the built-in world unless one is given
+    explicit GameSession(GameIO& io,
+        GameClock::Mode clockMode = GameClock::Mode::REAL_TIME, double clockSpeed = 1.0,
+        std::shared_ptr<const WorldTemplate> worldTemplate = nullptr);
+
+    GameSession(const GameSession&) = delete;
+    GameSession& operator=(const GameSession&) = delete;
+
+    // Prints the welcome banner and the starting room
+    void start();
+
+    // Runs one command line through the game, or answers the question the
+    // last one asked; a turn that asks finishes with its answer
+    TurnResult step(const std::string& command);
+
+    // Fires due clock timers and resumes a suspended turn
+    TurnResult poll();
+
+    // Frees the world and player of an idle session, keeping only what play
+    // changed in the template; start(), step() and poll() rebuild them.
+    // Fails while a timed sequence runs or commands are queued.
+    bool park();
+    bool isParked() const { return parked; }
+
+    // Memory held by the parked delta, 0 while not parked
+    size_t getParkedBytes() const { return parked ? delta.getByteSize() : 0; }
+
+    bool isRunning() const { return running; }
+    // Not available while parked
+    const Player& getPlayer() const { return *player; }
+    const GameClock& getClock() const { return clock; }
+};
@@ -0,0 +1,101 @@
+#include "Inventory.h"
+#include "EntityCast.h"
+#include "Item.h"
+#include "NameTable.h"
+#include <algorithm>
+
+unsigned Inventory::FlagFor(std::string_view name) {
+    if (name == "backpack") return BACKPACK;
+    if (name == "lantern") return LANTERN;
+    if (name == "amethyst") return AMETHYST;
+    if (name == "sapphire") return SAPPHIRE;
+    if (name == "ruby") return RUBY;
+    return 0;
+}
+
+// ========== Adding and Removing ==========
+
+void Inventory::add(Entity* item) {
+    // An entity is in one name index at a time
+    if (item->getParent() != nullptr) {
+        item->getParent()->removeEntity(item);
+    }
+    items.push_back(item->getArena(), item);
+    names.add(item);
+    track(item, 1);
+}
+
+bool Inventory::remove(Entity* item) {
+    auto it = std::find(items.begin(), items.end(), item);
+    if (it == items.end()) {
+        return false;
+    }
+
+    items.erase(it);
+    names.remove(item);
+    track(item, -1);
+    return true;
+}
+
+void Inventory::track(Entity* item, int delta) {
+    unsigned flag = FlagFor(item->getName());
+    if (flag != 0) {
+        int index = 0;
+        while ((1u << index) != flag) {
+            index++;
+        }
+
+        flagCounts[index] += delta;
+        if (flagCounts[index] > 0) {
+            flags |= flag;
+        }
+        else {
+            flags &= ~flag;
+        }
+    }
+
+    if (IsLitLantern(item)) {
+        litLanterns += delta;
+    }
+}
+
+bool Inventory::IsLitLantern(Entity* item) {
+    if (item->getName() != "lantern") {
+        return false;
+    }
+    Item* lantern = entity_cast<Item>(item);
+    return lantern != nullptr && lantern->getIsLit();
+}
+
+// ========== Lookup ==========
+
+Entity* Inventory::findByName(std::string_view name) const {
+    thread_local std::string buffer;
+    for (Entity* item = names.findExact(NameTable::Lowercase(name, buffer)); item != nullptr;
+        item = NameIndex::NextNamed(item)) {
+        if (item->getName() == name) {
+            return item;
+        }
+    }
+    return nullptr;
+}
+
+Entity* Inventory::findIgnoringCase(std::string_view name) const {
+    thread_local std::string buffer;
+    return names.findExact(NameTable::Lowercase(name, buffer));
+}
+
+// ========== Item State ==========
+
+void Inventory::setLit(Item* item, bool lit) {
+    bool carried = std::find(items.begin(), items.end(), item) != items.end();
+    if (carried && IsLitLantern(item)) {
+        litLanterns--;
+    }
+
+    item->setLit(lit);
+
+    if (carried && IsLitLantern(item)) {
+        litLanterns++;
+    }
+}
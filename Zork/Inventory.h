@@ -0,0 +1,66 @@
+#pragma once
+#include "ArenaVector.h"
+#include "Entity.h"
+#include "NameIndex.h"
+#include <string>
+
+class Item;
+
+/**
+ * Items carried by the player.
+ * Keeps the carrying order for display (in the items' arena, so the player
+ * stays trivially destructible), a name index for lookups and a set of
+ * flags for the items the game asks about every turn (backpack, lantern,
+ * amulet fragments). Flags are updated as items come and go, so checking
+ * them never walks the inventory.
+ */
+class Inventory {
+public:
+    // Presence flags, set while at least one item of that name is carried
+    static constexpr unsigned BACKPACK = 1u << 0;
+    static constexpr unsigned LANTERN = 1u << 1;
+    static constexpr unsigned AMETHYST = 1u << 2;
+    static constexpr unsigned SAPPHIRE = 1u << 3;
+    static constexpr unsigned RUBY = 1u << 4;
+    static constexpr unsigned FRAGMENTS = AMETHYST | SAPPHIRE | RUBY;
+
+    // Flag tracked for an item name, 0 if none
+    static unsigned FlagFor(std::string_view name);
+
+    void add(Entity* item);
+    bool remove(Entity* item);
+
+    // First item with exactly this name (case-sensitive)
+    Entity* findByName(std::string_view name) const;
+    // First item with this name in any case
+    Entity* findIgnoringCase(std::string_view name) const;
+    // Exact name, then the closest partial name; 'table' holds the names of the items' world
+    Entity* resolve(const std::string& name, const NameTable& table) const { return names.find(name, table); }
+
+    bool has(unsigned flag) const { return (flags & flag) == flag; }
+    unsigned getFlags() const { return flags; }
+
+    // Lights or douses a carried item, keeping the lit-lantern count current
+    void setLit(Item* item, bool lit);
+    bool hasLitLantern() const { return litLanterns > 0; }
+
+    // Carrying order
+    const ArenaVector<Entity*>& getItems() const { return items; }
+    Entity* const* begin() const { return items.begin(); }
+    Entity* const* end() const { return items.end(); }
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+    Entity* back() const { return items.back(); }
+
+private:
+    static constexpr int FLAG_COUNT = 5;
+
+    ArenaVector<Entity*> items;
+    NameIndex names;
+    unsigned flags = 0;
+    int flagCounts[FLAG_COUNT] = {};   // Items carried per flag
+    int litLanterns = 0;
+
+    void track(Entity* item, int delta);
+    static bool IsLitLantern(Entity* item);
+};
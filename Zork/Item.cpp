@@ -1,45 +1,78 @@
 #include "Item.h"
-#include <iostream>
+#include "EntityArena.h"
+#include "GameIO.h"
+#include "ItemPrototype.h"
+#include "WorldImage.h"
 
-Item::Item(const string& name, const string& description,
+namespace {
+
+    uint8_t FlagsFor(bool isContainer, bool isFragment, bool isFixedInPlace) {
+        return static_cast<uint8_t>((isContainer ? ItemTable::CONTAINER : 0)
+            | (isFragment ? ItemTable::FRAGMENT : 0)
+            | (isFixedInPlace ? ItemTable::FIXED : 0));    // Items start unlit
+    }
+}
+
+Item::Item(EntityArena& arena, const string& name, const string& description,
+    bool isContainer, int capacity, bool isFragment, bool isFixedInPlace) :
+    Entity(arena, EntityType::ITEM, name, description),
+    row(arena.getItems().add(this, FlagsFor(isContainer, isFragment, isFixedInPlace), capacity)),
+    prototype(ItemPrototype::NONE) {
+}
+
+Item::Item(EntityArena& arena, BorrowedText name, BorrowedText description,
     bool isContainer, int capacity, bool isFragment, bool isFixedInPlace) :
-    Entity(EntityType::ITEM, name, description),
-    isContainer(isContainer),
-    capacity(capacity),
-    isFragment(isFragment),
-    isLit(false),  // Items start unlit by default
-    isFixedInPlace(isFixedInPlace) {
+    Entity(arena, EntityType::ITEM, name, description),
+    row(arena.getItems().add(this, FlagsFor(isContainer, isFragment, isFixedInPlace), capacity)),
+    prototype(ItemPrototype::NONE) {
+}
+
+Item::Item(EntityArena& arena, const ItemPrototype& prototype) :
+    Entity(arena, EntityType::ITEM, BorrowedText(prototype.name), BorrowedText(prototype.description)),
+    row(arena.getItems().add(this, FlagsFor((prototype.flags & WorldFormat::ITEM_CONTAINER) != 0,
+        (prototype.flags & WorldFormat::ITEM_FRAGMENT) != 0, (prototype.flags & WorldFormat::ITEM_FIXED) != 0),
+        prototype.capacity)),
+    prototype(prototype.number) {
+}
+
+void Item::release() {
+    arena->getItems().remove(row);
+}
+
+bool Item::hasFlag(uint8_t flag) const {
+    return (arena->getItems().flags[row] & flag) != 0;
 }
 
 bool Item::getIsContainer() const {
-    return isContainer;
+    return hasFlag(ItemTable::CONTAINER);
 }
 
 int Item::getCapacity() const {
-    return capacity;
+    return arena->getItems().capacities[row];
 }
 
 bool Item::getIsFragment() const {
-    return isFragment;
+    return hasFlag(ItemTable::FRAGMENT);
 }
 
 bool Item::getIsFixedInPlace() const {
-    return isFixedInPlace;
+    return hasFlag(ItemTable::FIXED);
 }
 
 bool Item::getIsLit() const {
-    return isLit;
+    return hasFlag(ItemTable::LIT);
 }
 
 void Item::setLit(bool lit) {
-    isLit = lit;
+    uint8_t& flags = arena->getItems().flags[row];
+    flags = static_cast<uint8_t>(lit ? flags | ItemTable::LIT : flags & ~ItemTable::LIT);
 }
 
 // ========== Item Behavior ==========
 
 bool Item::canContain(const Entity* entity) const {
     // Check if this item can contain the specified entity
-    if (!isContainer) {
+    if (!getIsContainer()) {
         return false; // This item is not a container
     }
 
@@ -47,7 +80,8 @@ bool Item::canContain(const Entity* entity) const {
         return false; // Cannot contain a null entity
     }
 
-    if (capacity > 0 && contains.size() >= static_cast<size_t>(capacity)) {
+    int capacity = getCapacity();
+    if (capacity > 0 && childCount >= static_cast<size_t>(capacity)) {
         return false; // Container is at capacity
     }
 
@@ -57,38 +91,39 @@ bool Item::canContain(const Entity* entity) const {
 // ========== Information Display ==========
 
 void Item::look() const {
-    Entity::look(); // Shows name and description
-    if (isContainer) {
-        std::cout << "It can hold items";
+    describe(); // Shows name and description
+    if (getIsContainer()) {
+        int capacity = getCapacity();
+        GameIO::Out() << "It can hold items";
         if (capacity > 0) {
-            std::cout << " (capacity: " << capacity << ")";
+            GameIO::Out() << " (capacity: " << capacity << ")";
         }
-        std::cout << "." << std::endl;
+        GameIO::Out() << "." << std::endl;
 
         // Show contents if any
-        if (!contains.empty()) {
-            std::cout << "Inside you see:" << std::endl;
-            for (auto entity : contains) {
-                std::cout << "- " << entity->getName() << std::endl;
+        if (childCount > 0) {
+            GameIO::Out() << "Inside you see:" << std::endl;
+            for (auto entity : getContains()) {
+                GameIO::Out() << "- " << entity->getName() << std::endl;
             }
         }
         else {
-            std::cout << "It is currently empty." << std::endl;
+            GameIO::Out() << "It is currently empty." << std::endl;
         }
     }
 
     // Display fragment information if applicable
-    if (isFragment) {
-        std::cout << "It looks like part of a broken amulet." << std::endl;
+    if (getIsFragment()) {
+        GameIO::Out() << "It looks like part of a broken amulet." << std::endl;
     }
 
     // Display fixed in place information if applicable
-    if (isFixedInPlace) {
-        std::cout << "It appears to be permanently fixed in place." << std::endl;
+    if (getIsFixedInPlace()) {
+        GameIO::Out() << "It appears to be permanently fixed in place." << std::endl;
     }
 
     // Display lighting status for light sources
     if (getName() == "lantern" || getName() == "torch") {
-        std::cout << "It is currently " << (isLit ? "lit" : "unlit") << "." << std::endl;
+        GameIO::Out() << "It is currently " << (getIsLit() ? "lit" : "unlit") << "." << std::endl;
     }
 }
\ No newline at end of file
@@ -1,24 +1,42 @@
 #pragma once
 #include "Entity.h"
 
+struct ItemPrototype;
+
 class Item : public Entity {
 private:
-    bool isContainer;      // Whether this item can contain other items
-    int capacity;          // Maximum number of items this container can hold (0 = unlimited)
-    bool isFragment;       // Whether this is an amulet fragment for the main quest
-    bool isLit;            // Whether this item is currently providing light (for lanterns, torches)
-    bool isFixedInPlace;   // Whether this item can be picked up or is fixed to its location
+    // Row in the arena's ItemTable, which holds whether the item is a
+    // container (and its capacity, 0 = unlimited), an amulet fragment, lit
+    // or fixed in place
+    uint32_t row;
+
+    // Registry number of the ItemPrototype it was made from, ItemPrototype::NONE if none
+    uint32_t prototype;
+
+    bool hasFlag(uint8_t flag) const;
+
+    // Gives the item's row back to the table, when the arena destroys it
+    friend class EntityArena;
+    void release();
 
 public:
-    Item(const string& name, const string& description,
+    static constexpr EntityType TYPE = EntityType::ITEM;
+
+    Item(EntityArena& arena, const string& name, const string& description,
+        bool isContainer = false, int capacity = 0,
+        bool isFragment = false, bool isFixedInPlace = false);
+    Item(EntityArena& arena, BorrowedText name, BorrowedText description,
         bool isContainer = false, int capacity = 0,
         bool isFragment = false, bool isFixedInPlace = false);
+    // An item made in play, borrowing its text from a shared prototype
+    Item(EntityArena& arena, const ItemPrototype& prototype);
 
     bool getIsContainer() const;
     int getCapacity() const;
     bool getIsFragment() const;
     bool getIsFixedInPlace() const;
     bool getIsLit() const;
+    uint32_t getPrototype() const { return prototype; }
 
     // Item state modification
     void setLit(bool lit);
@@ -27,5 +45,5 @@ public:
     bool canContain(const Entity* entity) const;
 
     // Information display
-    void look() const override;
+    void look() const;
 };
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "ItemPrototype.h"
+#include "WorldImage.h"
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+    class Registry {
+    public:
+        Registry() {
+            using namespace WorldFormat;
+
+            // In StockItem order, so a stock item's number is its enum value
+            add("rusty key", "An old rusted key that might open something.", 0, 0);
+            add("sapphire", "Stolen fragment", ITEM_CONTAINER | ITEM_FRAGMENT, 0);
+            add("bread", "Stolen food from the villagers.", 0, 0);
+            add("Amulet of Eldoria",
+                "The fully restored artifact thrums with primordial energy.\n"
+                "You feel its power resonating with your very soul.", 0, 0);
+        }
+
+        const ItemPrototype& intern(std::string_view name, std::string_view description,
+            uint32_t flags, int32_t capacity) {
+            {
+                std::shared_lock<std::shared_mutex> lock(mutex);
+                const ItemPrototype* found = find(name, description, flags, capacity);
+                if (found != nullptr) {
+                    return *found;
+                }
+            }
+
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            const ItemPrototype* found = find(name, description, flags, capacity);
+            return found != nullptr ? *found : add(name, description, flags, capacity);
+        }
+
+        const ItemPrototype& get(uint32_t number) {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            return prototypes[number];
+        }
+
+        size_t getCount() {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            return prototypes.size();
+        }
+
+    private:
+        std::shared_mutex mutex;
+        std::deque<ItemPrototype> prototypes;           // Never move once added
+        std::unordered_set<std::string> texts;          // Node-based, so the text never moves either
+        std::unordered_multimap<std::string_view, uint32_t> byName;
+
+        const ItemPrototype* find(std::string_view name, std::string_view description,
+            uint32_t flags, int32_t capacity) const {
+            auto range = byName.equal_range(name);
+            for (auto it = range.first; it != range.second; ++it) {
+                const ItemPrototype& prototype = prototypes[it->second];
+                if (prototype.description == description && prototype.flags == flags
+                    && prototype.capacity == capacity) {
+                    return &prototype;
+                }
+            }
+            return nullptr;
+        }
+
+        const ItemPrototype& add(std::string_view name, std::string_view description,
+            uint32_t flags, int32_t capacity) {
+            uint32_t number = static_cast<uint32_t>(prototypes.size());
+            std::string_view keptName = *texts.emplace(name).first;
+            prototypes.push_back(ItemPrototype{ keptName, *texts.emplace(description).first,
+                flags, capacity, number });
+            byName.emplace(keptName, number);
+            return prototypes.back();
+        }
+    };
+
+    Registry& Prototypes() {
+        static Registry registry;
+        return registry;
+    }
+}
+
+const ItemPrototype& ItemPrototype::Intern(std::string_view name, std::string_view description,
+    uint32_t flags, int32_t capacity) {
+    return Prototypes().intern(name, description, flags, capacity);
+}
+
+const ItemPrototype& ItemPrototype::Stock(StockItem item) {
+    return Prototypes().get(static_cast<uint32_t>(item));
+}
+
+const ItemPrototype& ItemPrototype::Get(uint32_t number) {
+    return Prototypes().get(number);
+}
+
+size_t ItemPrototype::GetCount() {
+    return Prototypes().getCount();
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "GameEnums.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * What every copy of an item made during play shares: its name, its
+ * description and its kind. Prototypes live in a process-wide registry
+ * and never move or go away, so an item made from one borrows its text
+ * instead of copying it, and a parked session records such an item as the
+ * prototype's number and whether it is lit. Rewards, loot and corrupted
+ * artifacts of the same kind therefore cost their text once per process,
+ * however many sessions create them.
+ */
+struct ItemPrototype {
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+    std::string_view name;
+    std::string_view description;
+    uint32_t flags;         // WorldFormat::ITEM_* flags
+    int32_t capacity;       // For containers, 0 = unlimited
+    uint32_t number;        // Position in the registry
+
+    // The prototype with exactly this text and kind; the first call copies
+    // the text into the registry, later ones only look it up
+    static const ItemPrototype& Intern(std::string_view name, std::string_view description,
+        uint32_t flags = 0, int32_t capacity = 0);
+
+    // Prototype of an item the game hands out itself, registered with the registry
+    static const ItemPrototype& Stock(StockItem item);
+
+    static const ItemPrototype& Get(uint32_t number);
+    static size_t GetCount();
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * Read-only memory mapping of a whole file.
+ * The mapping is shared with the OS page cache, so several processes mapping
+ * the same file share one physical copy.
+ */
+class MappedFile {
+private:
+    const char* data;
+    size_t size;
+
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+    void Close();
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps the file, returns false if it cannot be opened (empty files map to no data)
+    bool Open(const std::string& path);
+
+    const char* getData() const { return data; }
+    size_t getSize() const { return size; }
+};
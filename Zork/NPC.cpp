@@ -1,31 +1,125 @@
 #include "NPC.h"
+#include "EntityArena.h"
+#include "Exit.h"
 #include "Player.h"
 #include "Room.h"
 #include "Item.h"
-#include <iostream>
+#include "ItemPrototype.h"
+#include "GameIO.h"
 #include <algorithm>
 
-NPC::NPC(const std::string& name, const std::string& description, Room* room) :
-    Creature(EntityType::NPC, name, description, room),
+namespace {
+
+    // Prints a dialogue line with {npc} and {player} replaced by the names
+    void SayLine(std::string_view line, std::string_view npcName, std::string_view playerName) {
+        size_t start = 0;
+        for (size_t open = line.find('{'); open != std::string_view::npos; open = line.find('{', start)) {
+            GameIO::Out() << line.substr(start, open - start);
+            if (line.compare(open, 5, "{npc}") == 0) {
+                GameIO::Out() << npcName;
+                start = open + 5;
+            }
+            else if (line.compare(open, 8, "{player}") == 0) {
+                GameIO::Out() << playerName;
+                start = open + 8;
+            }
+            else {
+                GameIO::Out() << '{';
+                start = open + 1;
+            }
+        }
+        GameIO::Out() << line.substr(start) << "\n";
+    }
+
+    // Stands in for a random number, the same for the same NPC and turn so
+    // that a session replays (or rebuilds from a delta) the same way
+    uint32_t Mix(uint32_t npc, uint32_t turn) {
+        uint32_t hash = (npc * 0x9E3779B1u) ^ turn;
+        hash ^= hash >> 16;
+        hash *= 0x85EBCA6Bu;
+        hash ^= hash >> 13;
+        hash *= 0xC2B2AE35u;
+        hash ^= hash >> 16;
+        return hash;
+    }
+}
+
+NPC::NPC(EntityArena& arena, const std::string& name, const std::string& description, Room* room) :
+    Creature(arena, EntityType::NPC, name, description, room),
+    dialogueGraph(nullptr),
+    dialogueRoot(DialogueGraph::NONE),
+    behavior(NpcBehavior::STILL),
+    period(0),
+    patrolStop(0),
+    nextUpdate(0),
     hasGivenReward(false),
     trusts(true),
     hasImportantInfo(false),
+    hasInteracted(false),
     isEnemy(false),
+    preventReinteraction(false) {
+}
+
+NPC::NPC(EntityArena& arena, BorrowedText name, BorrowedText description, Room* room) :
+    Creature(arena, EntityType::NPC, name, description, room),
+    dialogueGraph(nullptr),
+    dialogueRoot(DialogueGraph::NONE),
+    behavior(NpcBehavior::STILL),
+    period(0),
+    patrolStop(0),
+    nextUpdate(0),
+    hasGivenReward(false),
+    trusts(true),
+    hasImportantInfo(false),
     hasInteracted(false),
+    isEnemy(false),
     preventReinteraction(false) {
 }
 
 void NPC::addDialogue(const std::string& dialogue) {
-    dialogues.push_back(dialogue);
+    addDialogue(BorrowedText(arena->keepText(dialogue)));
+}
+
+void NPC::addDialogue(BorrowedText dialogue) {
+    dialogues.push_back(*arena, dialogue.text);
 }
 
 void NPC::addResponse(const std::string& playerInput, const std::string& npcResponse) {
-    responses[playerInput] = npcResponse;
+    addResponse(BorrowedText(arena->keepText(playerInput)), BorrowedText(arena->keepText(npcResponse)));
+}
+
+void NPC::addResponse(BorrowedText playerInput, BorrowedText npcResponse) {
+    // A repeated input replaces the earlier answer
+    Response* slot = std::lower_bound(responses.begin(), responses.end(), playerInput.text,
+        [](const Response& response, std::string_view input) { return response.input < input; });
+    if (slot != responses.end() && slot->input == playerInput.text) {
+        slot->reply = npcResponse.text;
+    }
+    else {
+        responses.insert(*arena, slot, Response{ playerInput.text, npcResponse.text });
+    }
 }
 
 void NPC::setInteraction(const std::string& required, const std::string& reward) {
-    requiredItem = required;
-    rewardItem = reward;
+    setInteraction(BorrowedText(arena->keepText(required)), BorrowedText(arena->keepText(reward)));
+}
+
+void NPC::setInteraction(BorrowedText required, BorrowedText reward) {
+    requiredItem = required.text;
+    rewardItem = reward.text;
+}
+
+void NPC::setRewardDescription(const std::string& description) {
+    rewardDescription = arena->keepText(description);
+}
+
+void NPC::setRewardDescription(BorrowedText description) {
+    rewardDescription = description.text;
+}
+
+void NPC::setDialogue(const DialogueGraph* graph, uint32_t root) {
+    dialogueGraph = graph;
+    dialogueRoot = root;
 }
 
 void NPC::setAsEnemy(bool enemy) {
@@ -48,63 +142,89 @@ void NPC::setHasInteracted(bool interacted) {
     hasInteracted = interacted;
 }
 
+void NPC::setBehavior(NpcBehavior newBehavior, uint32_t newPeriod) {
+    behavior = newBehavior;
+    period = newPeriod;
+}
+
+void NPC::addPatrolStop(Room* room) {
+    addPatrolStop(room->getHandle());
+}
+
+void NPC::addPatrolStop(EntityHandle room) {
+    patrolStops.push_back(*arena, room);
+}
+
+void NPC::setAnnouncement(const std::string& line) {
+    announcement = arena->keepText(line);
+}
+
+void NPC::setAnnouncement(BorrowedText line) {
+    announcement = line.text;
+}
+
+bool NPC::State::operator==(const State& other) const {
+    return hasGivenReward == other.hasGivenReward && trusts == other.trusts
+        && hasImportantInfo == other.hasImportantInfo && hasInteracted == other.hasInteracted
+        && isEnemy == other.isEnemy && preventReinteraction == other.preventReinteraction
+        && health == other.health && maxHealth == other.maxHealth
+        && patrolStop == other.patrolStop && nextUpdate == other.nextUpdate;
+}
+
+NPC::State NPC::StartingState(bool isEnemy, bool hasImportantInfo, bool preventReinteraction) {
+    // As the constructor and the setters the world loader calls leave it
+    return State{ false, true, hasImportantInfo, false, isEnemy, preventReinteraction,
+        STARTING_HEALTH, STARTING_HEALTH, 0, 0 };
+}
+
+NPC::State NPC::getState() const {
+    return State{ hasGivenReward, trusts, hasImportantInfo, hasInteracted,
+        isEnemy, preventReinteraction, getHealth(), getMaxHealth(), patrolStop, nextUpdate };
+}
+
+void NPC::setState(const State& state) {
+    hasGivenReward = state.hasGivenReward;
+    trusts = state.trusts;
+    hasImportantInfo = state.hasImportantInfo;
+    hasInteracted = state.hasInteracted;
+    isEnemy = state.isEnemy;
+    preventReinteraction = state.preventReinteraction;
+    restoreHealth(state.health, state.maxHealth);
+    patrolStop = state.patrolStop;
+    nextUpdate = state.nextUpdate;
+}
+
 void NPC::talk() const {
     if (dialogues.empty()) {
-        std::cout << name << " has nothing to say." << std::endl;
+        GameIO::Out() << name << " has nothing to say." << std::endl;
         return;
     }
 
     // Display ALL dialogue lines
-    std::cout << name << " says:" << std::endl;
+    GameIO::Out() << name << " says:" << std::endl;
     for (const auto& line : dialogues) {
-        std::cout << "\"" << line << "\"" << std::endl;
+        GameIO::Out() << "\"" << line << "\"" << std::endl;
     }
 
     // If there are specific responses, give a hint
     if (!responses.empty()) {
-        std::cout << "You could ask about: ";
+        GameIO::Out() << "You could ask about: ";
         bool first = true;
-        for (const auto& pair : responses) {
+        for (const Response& response : responses) {
             if (!first) {
-                std::cout << ", ";
+                GameIO::Out() << ", ";
             }
-            std::cout << pair.first;
+            GameIO::Out() << response.input;
             first = false;
         }
-        std::cout << std::endl;
-    }
-}
-
-void NPC::handlePlayerInput(const std::string& input, Player* player) {
-    // Convert input to lowercase for case-insensitive comparison
-    std::string lowerInput = input;
-    std::transform(lowerInput.begin(), lowerInput.end(), lowerInput.begin(), ::tolower);
-
-    auto it = responses.find(lowerInput);
-    if (it != responses.end()) {
-        std::cout << name << " says: \"" << it->second << "\"" << std::endl;
-
-        // Potentially affect alignment based on input content
-        if (lowerInput.find("help") != std::string::npos ||
-            lowerInput.find("assist") != std::string::npos ||
-            lowerInput.find("save") != std::string::npos) {
-            player->makeAltruisticChoice();
-        }
-        else if (lowerInput.find("threat") != std::string::npos ||
-            lowerInput.find("lie") != std::string::npos ||
-            lowerInput.find("steal") != std::string::npos) {
-            player->makeSelfishChoice();
-        }
-    }
-    else {
-        std::cout << name << " doesn't understand what you're asking about." << std::endl;
+        GameIO::Out() << std::endl;
     }
 }
 
 void NPC::interact(Player* player) {
     // Check if NPC prevents reinteraction and has already interacted
     if (hasInteracted && preventReinteraction) {
-        std::cout << name << " has nothing more to say to you." << std::endl;
+        GameIO::Out() << name << " has nothing more to say to you." << std::endl;
         return;
     }
 
@@ -115,41 +235,41 @@ void NPC::interact(Player* player) {
     if (player->getAlignment() < -3 || player->hasBetrayed()) {
         if (trusts) {
             // First time mistrust - NPC becomes cautious
-            std::cout << name << " eyes you warily...\n";
+            GameIO::Out() << name << " eyes you warily...\n";
 
             if (player->hasBetrayed()) {
-                std::cout << "\"I've heard about your betrayals, " << player->getName() << ". ";
-                std::cout << "Why should I trust you?\"\n";
+                GameIO::Out() << "\"I've heard about your betrayals, " << player->getName() << ". ";
+                GameIO::Out() << "Why should I trust you?\"\n";
             }
             else {
-                std::cout << "\"There's a darkness about you that I don't trust, " << player->getName() << ".\"\n";
+                GameIO::Out() << "\"There's a darkness about you that I don't trust, " << player->getName() << ".\"\n";
             }
 
             trusts = false;
 
             // If enemy NPC, they become more aggressive
             if (isEnemy) {
-                std::cout << name << " reaches for their weapon. \"Stay back!\"\n";
+                GameIO::Out() << name << " reaches for their weapon. \"Stay back!\"\n";
                 return;
             }
 
             // If NPC has important info, they hide it
             if (hasImportantInfo) {
-                std::cout << "\"I don't think I should tell you what I know.\"\n";
+                GameIO::Out() << "\"I don't think I should tell you what I know.\"\n";
                 return;
             }
         }
         else {
             // Already mistrusting
-            std::cout << name << " refuses to speak with you further.\n";
-            std::cout << "\"Leave me be, " << player->getName() << ".\"\n";
+            GameIO::Out() << name << " refuses to speak with you further.\n";
+            GameIO::Out() << "\"Leave me be, " << player->getName() << ".\"\n";
             return;
         }
     }
     else if (!trusts && player->getAlignment() > 2) {
         // Redemption - NPC begins to trust again
-        std::cout << name << " seems to relax slightly around you.\n";
-        std::cout << "\"Perhaps I misjudged you, " << player->getName() << ".\"\n";
+        GameIO::Out() << name << " seems to relax slightly around you.\n";
+        GameIO::Out() << "\"Perhaps I misjudged you, " << player->getName() << ".\"\n";
         trusts = true;
     }
 
@@ -157,366 +277,304 @@ void NPC::interact(Player* player) {
     if (!requiredItem.empty() && !hasGivenReward) {
         // Check if player has the required item
         if (player->hasItem(requiredItem)) {
-            std::cout << name << " says: \"I see you have " << requiredItem
+            GameIO::Out() << name << " says: \"I see you have " << requiredItem
                 << ". Would you like to give it to me?\" (yes/no)" << std::endl;
-
-            // Get player response
-            std::string response;
-            std::getline(std::cin, response);
-            std::transform(response.begin(), response.end(), response.begin(), ::tolower);
-
-            if (response == "yes" || response == "y") {
-                if (player->removeItem(requiredItem)) {
-                    // Successfully gave item
-                    std::cout << "You give " << requiredItem << " to " << name << "." << std::endl;
-
-                    // Improve alignment for helping
-                    player->makeAltruisticChoice();
-
-                    // Give reward if specified
-                    if (!rewardItem.empty()) {
-                        std::string rewardDesc = "A reward from " + name;
-
-                        // Special descriptions for known rewards
-                        if (rewardItem == "scroll") {
-                            rewardDesc = "Ancient Scroll from the Hermit \
-                                The parchment is yellowed with age, covered in delicate script and strange symbols.It reads : \
-                                'To the Seeker of the Amulet : \
-                                The three fragments must be reunited at the temple forge to restore the amulet's power. Each fragment resonates with a unique energy: \
-                                - The amethyst controls shadows and can part the darkness \
-                                - The sapphire holds protective magic against curses \
-                                - The ruby contains the power to break or strengthen magical bonds \
-                                BEWARE : The corrupted altar in the tower will try to tempt you.The restored amulet must be placed there to break the curse, but approach with a pure heart. \
-                                The curse grows stronger in darkness.Keep your lantern lit in the mine, for shadow creatures feed on fear and flesh alike. \
-                                The fragments can be combined only at the temple forge.All three must be placed simultaneously for the ritual to succeed. \
-                                Choose your path wisely.The amulet reveals the true nature of its bearer. \
-                                - Eldric, Last of the Keepers' \
-                                At the bottom of the scroll is a hastily drawn map showing the relationship between the village, forest, mine, temple, and tower, with small notes about dangers in each location.";
-                        }
-                        else if (rewardItem == "sapphire") {
-                            rewardDesc = "A smooth blue fragment encased in ice that never melts. It whispers when held.";
-                        }
-                        else if (rewardItem == "rusty key") {
-                            rewardDesc = "An old iron key that opens the mine entrance";
-                        }
-
-                        // Check if player can carry more items
-                        if (player->canCarryMoreItems()) {
-                            Item* reward = new Item(rewardItem, rewardDesc);
-                            player->addItem(reward);
-                            std::cout << name << " gives you " << rewardItem << " in return." << std::endl;
-                        }
-                        else {
-                            std::cout << name << " tries to give you " << rewardItem
-                                << ", but you can't carry it!" << std::endl;
-                            // drop the reward in the room if inventory is full
-                            if (location) {
-                                Item* reward = new Item(rewardItem, rewardDesc);
-                                location->addEntity(reward);
-                                std::cout << rewardItem << " falls to the ground." << std::endl;
-                            }
-                        }
-                    }
-
-                    // Show additional dialogue if available
-                    if (dialogues.size() > 1) {
-                        std::cout << name << " says: \"" << dialogues[1] << "\"" << std::endl;
-                    }
-
-                    hasGivenReward = true;
-                    return;
-                }
-            }
-            else {
-                std::cout << "You decide to keep " << requiredItem << "." << std::endl;
-                return;
-            }
+            player->ask(Prompt::GIVE_REQUIRED_ITEM, this);
+            return;
         }
         else {
             // Player doesn't have the required item
-            std::cout << name << " says: \"Bring me " << requiredItem
+            GameIO::Out() << name << " says: \"Bring me " << requiredItem
                 << " and I'll help you.\"" << std::endl;
             if (dialogues.size() > 2) {  // Show hint if available
-                std::cout << name << " adds: \"" << dialogues[2] << "\"" << std::endl;
+                GameIO::Out() << name << " adds: \"" << dialogues[2] << "\"" << std::endl;
             }
             return;
         }
     }
 
+    offerChoices(player);
+}
+
+void NPC::offerChoices(Player* player) {
     // Special interaction for NPCs with important information
     if (hasImportantInfo && trusts) {
-        std::cout << name << " leans in closer and whispers:\n";
+        GameIO::Out() << name << " leans in closer and whispers:\n";
         if (dialogues.size() > 3) {
-            std::cout << "\"" << dialogues[3] << "\"\n";
+            GameIO::Out() << "\"" << dialogues[3] << "\"\n";
         }
         else {
-            std::cout << "\"I've heard rumors of an amulet fragment hidden in a nearby cave.\"\n";
+            GameIO::Out() << "\"I've heard rumors of an amulet fragment hidden in a nearby cave.\"\n";
         }
 
         // Choice to pursue this info or not
-        std::cout << "\nYou could:\n";
-        std::cout << "1. Thank them for the information\n";
-        std::cout << "2. Ask for more details\n";
-        std::cout << "3. Ignore this seemingly useless gossip\n";
-        std::cout << "Choose (1-3): ";
-
-        std::string choice;
-        std::getline(std::cin, choice);
+        GameIO::Out() << "\nYou could:\n";
+        GameIO::Out() << "1. Thank them for the information\n";
+        GameIO::Out() << "2. Ask for more details\n";
+        GameIO::Out() << "3. Ignore this seemingly useless gossip\n";
+        GameIO::Out() << "Choose (1-3): ";
+        player->ask(Prompt::IMPORTANT_INFO, this);
+        return;
+    }
 
-        if (choice == "1") {
-            std::cout << "You thank " << name << " for the valuable information.\n";
-            player->makeAltruisticChoice();
-        }
-        else if (choice == "2") {
-            std::cout << "You eagerly ask for more details.\n";
-            std::cout << name << " shares everything they know about the rumor.\n";
-            if (dialogues.size() > 4) {
-                std::cout << name << ": \"" << dialogues[4] << "\"\n";
-            }
-            player->makeAltruisticChoice();
-        }
-        else if (choice == "3") {
-            std::cout << "You dismiss " << name << "'s information with a shrug.\n";
-            std::cout << name << " looks hurt by your indifference.\n";
-            player->makeSelfishChoice();
-            trusts = false;
-        }
+    // Whatever else the NPC does is in its dialogue graph
+    if (dialogueGraph != nullptr && dialogueRoot != DialogueGraph::NONE) {
+        runDialogue(player, dialogueRoot);
         return;
     }
 
-    // Special NPC-specific interactions
-    if (name == "Blacksmith" && !hasGivenReward) {
-        if (player->hasItem("bread")) {
-            std::cout << name << " eyes the bread hungrily. \"I'll trade my rusty key for that loaf.\" (yes/no)\n";
-            std::string response;
-            std::getline(std::cin, response);
-            std::transform(response.begin(), response.end(), response.begin(), ::tolower);
-
-            if (response == "yes" || response == "y") {
-                if (player->removeItem("bread")) {
-                    std::cout << "You trade the bread for the rusty key.\n";
-                    std::cout << "The blacksmith tears into the loaf. \"This mine key is yours now. Be careful down there.\"\n";
-
-                    Item* key = new Item("rusty key", "An old iron key that opens the mine entrance");
-                    player->addItem(key);
-                    player->makeAltruisticChoice();
-                    hasGivenReward = true;
-                    return;
+    // Default dialogue if no special interaction is needed
+    talk();
+}
+
+// ========== Answers ==========
+
+void NPC::answer(Player* player, Prompt prompt, uint32_t node, std::string response) {
+    switch (prompt) {
+    case Prompt::GIVE_REQUIRED_ITEM:
+        answerRequiredItem(player, response);
+        break;
+    case Prompt::IMPORTANT_INFO:
+        answerImportantInfo(player, response);
+        break;
+    case Prompt::DIALOGUE:
+        std::transform(response.begin(), response.end(), response.begin(), ::tolower);
+        runDialogue(player, nextNode(node, player, response));
+        break;
+    default:
+        break;
+    }
+}
+
+void NPC::answerRequiredItem(Player* player, std::string response) {
+    std::transform(response.begin(), response.end(), response.begin(), ::tolower);
+
+    if (response == "yes" || response == "y") {
+        if (player->removeItem(requiredItem)) {
+            // Successfully gave item
+            GameIO::Out() << "You give " << requiredItem << " to " << name << "." << std::endl;
+
+            // Improve alignment for helping
+            player->makeAltruisticChoice();
+
+            // Give reward if specified
+            if (!rewardItem.empty()) {
+                const ItemPrototype& prototype = rewardDescription.empty()
+                    ? ItemPrototype::Intern(rewardItem, "A reward from " + std::string(name))
+                    : ItemPrototype::Intern(rewardItem, rewardDescription);
+
+                // Check if player can carry more items
+                if (player->canCarryMoreItems()) {
+                    Item* reward = getArena().create<Item>(prototype);
+                    player->addItem(reward);
+                    GameIO::Out() << name << " gives you " << rewardItem << " in return." << std::endl;
+                }
+                else {
+                    GameIO::Out() << name << " tries to give you " << rewardItem
+                        << ", but you can't carry it!" << std::endl;
+                    // drop the reward in the room if inventory is full
+                    if (getLocation()) {
+                        Item* reward = getArena().create<Item>(prototype);
+                        getLocation()->addEntity(reward);
+                        GameIO::Out() << rewardItem << " falls to the ground." << std::endl;
+                    }
                 }
             }
-            else {
-                std::cout << "You decide to keep your bread for now.\n";
-                return;
+
+            // Show additional dialogue if available
+            if (dialogues.size() > 1) {
+                GameIO::Out() << name << " says: \"" << dialogues[1] << "\"" << std::endl;
             }
-        }
-        else {
-            std::cout << "\"Bring me some bread if you want the mine key. A man's got to eat.\"\n";
+
+            hasGivenReward = true;
             return;
         }
     }
-    else if (name == "Hermit" && !hasGivenReward && player->hasItem("potion")) {
-        std::cout << "The hermit looks at your potion with desperate eyes.\n";
-        std::cout << "\"That elixir would ease my suffering greatly. Will you share it?\" (yes/no)\n";
+    else {
+        GameIO::Out() << "You decide to keep " << requiredItem << "." << std::endl;
+        return;
+    }
 
-        std::string response;
-        std::getline(std::cin, response);
-        std::transform(response.begin(), response.end(), response.begin(), ::tolower);
+    // The item could not be handed over, so the conversation goes on
+    offerChoices(player);
+}
 
-        if (response == "yes" || response == "y") {
-            if (player->removeItem("potion")) {
-                std::cout << "You give the potion to the hermit.\n";
-                std::cout << "He drinks it and his breathing eases. \"Thank you, kind soul.\"\n";
-                std::cout << "\"The lantern you found will protect you in the mine's darkness. The shadows flee from its light.\"\n";
-                std::cout << "\"But beware - its oil won't last forever. Make haste when in dark places.\"\n";
-
-                Item* scroll = new Item("scroll", "Ancient parchment with instructions for combining the amulet fragments");
-                player->addItem(scroll);
-                player->makeAltruisticChoice();
-                hasGivenReward = true;
-                return;
-            }
+void NPC::answerImportantInfo(Player* player, const std::string& choice) {
+    if (choice == "1") {
+        GameIO::Out() << "You thank " << name << " for the valuable information.\n";
+        player->makeAltruisticChoice();
+    }
+    else if (choice == "2") {
+        GameIO::Out() << "You eagerly ask for more details.\n";
+        GameIO::Out() << name << " shares everything they know about the rumor.\n";
+        if (dialogues.size() > 4) {
+            GameIO::Out() << name << ": \"" << dialogues[4] << "\"\n";
         }
+        player->makeAltruisticChoice();
     }
-    else if (name == "Dark Spirit") {
-        std::cout << "The dark spirit's voice slithers into your mind. What do you do?\n";
-        std::cout << "1. Reject its offer\n";
-        std::cout << "2. Listen to learn more\n";
-        std::cout << "3. Embrace the darkness\n";
-
-        std::string choice;
-        std::getline(std::cin, choice);
-
-        if (choice == "1") {
-            std::cout << "You steel your mind against the spirit's temptations.\n";
-            std::cout << "\"You will regret spurning such power!\" it hisses as it fades back into the shadows.\n";
-            player->makeAltruisticChoice();
+    else if (choice == "3") {
+        GameIO::Out() << "You dismiss " << name << "'s information with a shrug.\n";
+        GameIO::Out() << name << " looks hurt by your indifference.\n";
+        player->makeSelfishChoice();
+        trusts = false;
+    }
+}
 
-            hasInteracted = true;
-            preventReinteraction = true;
-        }
-        else if (choice == "2") {
-            std::cout << "You cautiously allow the spirit to continue...\n";
-            std::cout << "\"The fragments themselves can be corrupted at the shrine,\" it purrs.\n";
-            std::cout << "\"Their power twisted to serve only you. Think of the possibilities...\"\n";
-            player->makeSelfishChoice();
+// ========== Dialogue graph ==========
 
-            hasInteracted = true;
-            preventReinteraction = true;
+void NPC::runDialogue(Player* player, uint32_t node) {
+    // Without a question in between no conversation visits more nodes than
+    // the graph has, so a graph that loops without asking stops there
+    for (size_t steps = 0; node != DialogueGraph::NONE && steps < dialogueGraph->getNodeCount(); steps++) {
+        const DialogueGraph::Node& current = dialogueGraph->getNode(node);
+        for (uint32_t e = current.firstEffect; e < current.firstEffect + current.effectCount; e++) {
+            apply(dialogueGraph->getEffect(e), player);
         }
-        else if (choice == "3") {
-            std::cout << "You open yourself to the darkness, feeling it seep into your very being.\n";
-            std::cout << "\"Excellent,\" the spirit whispers. \"The first step is taken.\"\n";
-            std::cout << "\"Sacrifice at the dark shrine to seal your path to power.\"\n";
-            player->makeSelfishChoice();
-            player->makeSelfishChoice(); // Double impact for embracing darkness
 
-            hasInteracted = true;
-            preventReinteraction = true;
+        if (current.asks) {
+            GameIO::Out() << current.question;
+            player->ask(Prompt::DIALOGUE, this, node);
+            return;
         }
-        return;
+        node = nextNode(node, player, std::string_view());
     }
-    else if (name == "Elder") {
-        std::cout << "The village elder looks at you with hopeful eyes.\n";
-        std::cout << "1. Share some of your supplies\n";
-        std::cout << "2. Ignore the elder's request\n";
-        std::cout << "3. Demand payment for your help\n";
-        std::cout << "Choose (1-3): ";
-
-        std::string choice;
-        std::getline(std::cin, choice);
-
-        if (choice == "1") {
-            std::cout << "You offer some of your supplies to help the villagers.\n";
-            std::cout << "\"Bless you, traveler. Your kindness brings light to our darkest hour.\"\n";
-            player->makeAltruisticChoice();
-            player->makeAltruisticChoice(); // Double impact for significant kindness
+}
 
-            hasInteracted = true;
-            preventReinteraction = true;
+uint32_t NPC::nextNode(uint32_t node, const Player* player, std::string_view answer) const {
+    const DialogueGraph::Node& current = dialogueGraph->getNode(node);
+    for (uint32_t e = current.firstEdge; e < current.firstEdge + current.edgeCount; e++) {
+        const DialogueGraph::Edge& edge = dialogueGraph->getEdge(e);
+        if ((edge.answer.empty() || edge.answer == answer) && holds(edge, player)) {
+            return edge.target;
         }
-        else if (choice == "2") {
-            std::cout << "You tell the elder you need to focus on your quest first.\n";
-            std::cout << "\"I see. Another who cares only for themselves. May you find what you seek, though it brings you no joy.\"\n";
-            // No alignment change - neutral choice
+    }
+    return DialogueGraph::NONE;
+}
+
+bool NPC::holds(const DialogueGraph::Edge& edge, const Player* player) const {
+    switch (edge.condition) {
+    case DialogueCondition::ALWAYS:
+        return true;
+    case DialogueCondition::HAS_ITEM:
+        return player->hasItem(std::string(edge.subject));
+    case DialogueCondition::LACKS_ITEM:
+        return !player->hasItem(std::string(edge.subject));
+    case DialogueCondition::ALIGNMENT_AT_LEAST:
+        return player->getAlignment() >= edge.value;
+    case DialogueCondition::ALIGNMENT_BELOW:
+        return player->getAlignment() < edge.value;
+    case DialogueCondition::TRUSTED:
+        return trusts;
+    case DialogueCondition::DISTRUSTED:
+        return !trusts;
+    case DialogueCondition::REWARD_PENDING:
+        return !hasGivenReward;
+    case DialogueCondition::REWARD_GIVEN:
+        return hasGivenReward;
+    default:
+        return false;
+    }
+}
 
-            hasInteracted = true;
-            preventReinteraction = true;
+void NPC::apply(const DialogueGraph::Effect& effect, Player* player) {
+    switch (effect.action) {
+    case DialogueAction::SAY:
+        SayLine(effect.text, name, player->getName());
+        break;
+    case DialogueAction::GIVE_ITEM:
+        player->addItem(getArena().create<Item>(ItemPrototype::Intern(effect.subject, effect.text)));
+        break;
+    case DialogueAction::TAKE_ITEM:
+        player->removeItem(std::string(effect.subject));
+        break;
+    case DialogueAction::ALIGNMENT:
+        for (int i = 0; i < effect.value; i++) {
+            player->makeAltruisticChoice();
         }
-        else if (choice == "3") {
-            std::cout << "You demand payment for your services despite their desperate situation.\n";
-            std::cout << "\"Even in these desperate times, there are those who would profit from suffering.\"\n";
-            std::cout << "The elder reluctantly hands you a few coins. \"It's all we can spare.\"\n";
+        for (int i = 0; i < -effect.value; i++) {
             player->makeSelfishChoice();
-
-            hasInteracted = true;
-            preventReinteraction = true;
         }
-        return;
+        break;
+    case DialogueAction::TRUST:
+        trusts = effect.value != 0;
+        break;
+    case DialogueAction::REWARD_GIVEN:
+        hasGivenReward = true;
+        break;
+    case DialogueAction::END_INTERACTIONS:
+        hasInteracted = true;
+        preventReinteraction = true;
+        break;
+    case DialogueAction::TALK:
+        talk();
+        break;
+    default:
+        break;
     }
-    else if (name == "Bandit") {
-        std::cout << "The desperate bandit stands before you, knife trembling in his hand.\n";
-        std::cout << "1. Attack the bandit\n";
-        std::cout << "2. Forgive and help him\n";
-        std::cout << "3. Threaten and rob him instead\n";
-        std::cout << "Choose (1-3): ";
-
-        std::string choice;
-        std::getline(std::cin, choice);
-
-        if (choice == "1") {
-            std::cout << "You draw your weapon as the bandit readies for combat!\n";
-            std::cout << "\"I won't go down without a fight!\"\n";
-            player->makeSelfishChoice();
+}
 
-            hasInteracted = true;
-            preventReinteraction = true;
+std::string NPC::getAnswers(uint32_t node) const {
+    std::string answers;
+    if (dialogueGraph == nullptr || node >= dialogueGraph->getNodeCount()) {
+        return answers;
+    }
+    const DialogueGraph::Node& current = dialogueGraph->getNode(node);
+    for (uint32_t e = current.firstEdge; e < current.firstEdge + current.edgeCount; e++) {
+        std::string_view answer = dialogueGraph->getEdge(e).answer;
+        if (!answer.empty()) {
+            answers += answers.empty() ? "" : " ";
+            answers += answer;
         }
-        else if (choice == "2") {
-            std::cout << "You lower your guard and offer to help the bandit and his family.\n";
-            std::cout << "\"You... would help me? After I threatened you?\" Tears form in his eyes.\n";
-            std::cout << "\"I won't forget this mercy. Take this - I found it in the forest.\"\n";
-
-            Item* herbalMix = new Item("herbal mix", "A potent mixture of medicinal herbs");
-            player->addItem(herbalMix);
-            player->makeAltruisticChoice();
-            player->makeAltruisticChoice(); // Double positive impact
+    }
+    return answers;
+}
 
-            hasInteracted = true;
-            preventReinteraction = true;
-        }
-        else if (choice == "3") {
-            std::cout << "You turn the tables and threaten the bandit with your superior weapons.\n";
-            std::cout << "\"P-please! Don't take everything! My children will starve!\"\n";
-            std::cout << "You take his meager belongings anyway.\n";
+// ========== Behavior ==========
 
-            Item* smallPouch = new Item("small pouch", "A pouch containing a few coins");
-            player->addItem(smallPouch);
-            player->makeSelfishChoice();
-            player->makeSelfishChoice(); // Double negative impact
+uint32_t NPC::update(uint32_t turn, const Player& player) {
+    Room* room = getLocation();
+    if (period == 0 || room == nullptr) {
+        return 0;
+    }
 
-            hasInteracted = true;
-            preventReinteraction = true;
+    if (behavior == NpcBehavior::WANDER) {
+        const Exit* open[DIRECTION_COUNT];
+        size_t openCount = 0;
+        for (const Exit* exit : room->getExits()) {
+            if (exit != nullptr && !exit->isLocked()) {
+                open[openCount++] = exit;
+            }
+        }
+        if (openCount > 0) {
+            walk(open[Mix(getRecord(), turn) % openCount], player);
         }
-        return;
     }
-    else if (name == "Corrupted Villager") {
-        std::cout << "The corrupted villager stumbles toward you, twisted by the curse.\n";
-        std::cout << "Their humanity seems to be fighting against the corruption.\n";
-        std::cout << "1. Try to save them with herbs\n";
-        std::cout << "2. End their suffering mercifully\n";
-        std::cout << "3. Sacrifice their corrupted essence for power\n";
-        std::cout << "Choose (1-3): ";
-
-        std::string choice;
-        std::getline(std::cin, choice);
-
-        if (choice == "1") {
-            if (player->hasItem("herbs") || player->hasItem("herbal mix")) {
-                std::string herbItem = player->hasItem("herbal mix") ? "herbal mix" : "herbs";
-
-                std::cout << "You attempt to administer " << herbItem << " to calm the corrupted villager...\n";
-                player->removeItem(herbItem);
-
-                std::cout << "The herbs take effect, and the darkness begins to recede from their eyes.\n";
-                std::cout << "\"T-thank you,\" they stammer. \"I was lost... but you brought me back.\"\n";
-                std::cout << "They hand you a small trinket. \"This may help you on your journey.\"\n";
-
-                Item* amuletShard = new Item("amulet shard", "A tiny fragment that seems to resonate with the larger amulet pieces");
-                player->addItem(amuletShard);
-                player->makeAltruisticChoice();
-                player->makeAltruisticChoice(); // Double positive impact
-            }
-            else {
-                std::cout << "You try to help, but without herbs, there's little you can do.\n";
-                std::cout << "The villager lunges at you, fully consumed by the darkness!\n";
+    else if (behavior == NpcBehavior::PATROL && !patrolStops.empty()) {
+        // Heads for the next stop; a locked or missing way keeps it waiting
+        uint32_t next = (patrolStop + 1) % static_cast<uint32_t>(patrolStops.size());
+        const Room* target = getArena().get<Room>(patrolStops[next]);
+        for (const Exit* exit : room->getExits()) {
+            if (exit != nullptr && !exit->isLocked() && exit->getDestination() == target) {
+                walk(exit, player);
+                patrolStop = next;
+                break;
             }
-
-            hasInteracted = true;
-            preventReinteraction = true;
-        }
-        else if (choice == "2") {
-            std::cout << "With a heavy heart, you end the villager's suffering quickly and painlessly.\n";
-            std::cout << "It was the only humane choice. Their twisted features relax in final peace.\n";
-            // No alignment change - this was a mercy
-
-            hasInteracted = true;
-            preventReinteraction = true;
         }
-        else if (choice == "3") {
-            std::cout << "You begin a dark ritual, drawing the corrupted essence from the villager...\n";
-            std::cout << "You have made your choice, complete the ritual by typing 'Sacrifice villager'\n";
-
-            // Give player a power but decrease alignment significantly
-            player->makeSelfishChoice();
-            player->makeSelfishChoice();
-            player->makeSelfishChoice(); // Triple negative impact
+    }
 
-            hasInteracted = true;
-            preventReinteraction = true;
-        }
-        return;
+    if (!announcement.empty() && getLocation() == player.getLocation()) {
+        SayLine(announcement, name, player.getName());
     }
+    return period;
+}
 
-    // Default dialogue if no special interaction is needed
-    talk();
-}
\ No newline at end of file
+void NPC::walk(const Exit* exit, const Player& player) {
+    Room* destination = exit->getDestination();
+    if (getLocation() == player.getLocation()) {
+        GameIO::Out() << name << " leaves " << directionToString(exit->getDirection()) << "." << std::endl;
+    }
+    setLocation(destination);
+    if (destination == player.getLocation()) {
+        GameIO::Out() << name << " arrives." << std::endl;
+    }
+}
@@ -1,46 +1,146 @@
 #pragma once
+#include "ArenaVector.h"
 #include "Creature.h"
-#include <vector>
-#include <map>
+#include "DialogueGraph.h"
+#include "EntityHandle.h"
+#include "GameEnums.h"
 #include <string>
+#include <string_view>
 
+class Exit;
 class Player;
 class Room;
 
 class NPC : public Creature {
+public:
+    // What the NPC answers to 'input'
+    struct Response {
+        std::string_view input;
+        std::string_view reply;
+    };
+
 private:
-    std::vector<std::string> dialogues;
-    std::map<std::string, std::string> responses; // Key: player input, Value: NPC response
-    std::string requiredItem;
-    std::string rewardItem;
+    // Lines and lists are in the arena, text kept there or borrowed from
+    // the world image, so an NPC owns nothing that needs destroying
+    ArenaVector<std::string_view> dialogues;
+    ArenaVector<Response> responses;    // Sorted by input, one per input
+    std::string_view requiredItem;
+    std::string_view rewardItem;
+    std::string_view rewardDescription; // Empty for the generic one
+    const DialogueGraph* dialogueGraph; // Shared by every NPC of the world, nullptr if none
+    uint32_t dialogueRoot;              // Node the conversation starts at, DialogueGraph::NONE to just talk
+    NpcBehavior behavior;
+    uint32_t period;                    // Turns between updates, 0 for none
+    ArenaVector<EntityHandle> patrolStops;  // Rooms of a patrol route, in order
+    std::string_view announcement;      // Said in the player's room after each update, empty for none
+    uint32_t patrolStop;                // Index of the stop last headed for
+    uint32_t nextUpdate;                // Turn of the scheduled update, 0 while asleep
     bool hasGivenReward;
     bool trusts;              // Tracks if NPC trusts the player
     bool hasImportantInfo;    // If NPC has important story information
     bool hasInteracted;       // Track if player has interacted with this NPC
 
+    // The rest of interact() once any item trade is settled
+    void offerChoices(Player* player);
+
+    // Ends an interaction with the player's answer to a question it asked
+    void answerRequiredItem(Player* player, std::string response);
+    void answerImportantInfo(Player* player, const std::string& choice);
+
+    // Dialogue graph interpreter: runs nodes from 'node' on until one asks
+    // or the conversation ends
+    void runDialogue(Player* player, uint32_t node);
+    uint32_t nextNode(uint32_t node, const Player* player, std::string_view answer) const;
+    bool holds(const DialogueGraph::Edge& edge, const Player* player) const;
+    void apply(const DialogueGraph::Effect& effect, Player* player);
+
+    // Moves through an exit, telling the player when it happens in their room
+    void walk(const Exit* exit, const Player& player);
+
 public:
+    static constexpr EntityType TYPE = EntityType::NPC;
+
+    // Everything play can change about an NPC, for saving a session as a delta
+    struct State {
+        bool hasGivenReward;
+        bool trusts;
+        bool hasImportantInfo;
+        bool hasInteracted;
+        bool isEnemy;
+        bool preventReinteraction;
+        int health;
+        int maxHealth;
+        uint32_t patrolStop;
+        uint32_t nextUpdate;
+
+        bool operator==(const State& other) const;
+        bool operator!=(const State& other) const { return !(*this == other); }
+    };
+
+    // State of an NPC just built from its world record
+    static State StartingState(bool isEnemy, bool hasImportantInfo, bool preventReinteraction);
+
     // Constructor
-    NPC(const std::string& name, const std::string& description, Room* room);
+    NPC(EntityArena& arena, const std::string& name, const std::string& description, Room* room);
+    NPC(EntityArena& arena, BorrowedText name, BorrowedText description, Room* room);
 
     // Dialogue and response management
     void addDialogue(const std::string& dialogue);
+    void addDialogue(BorrowedText dialogue);
     void addResponse(const std::string& playerInput, const std::string& npcResponse);
+    void addResponse(BorrowedText playerInput, BorrowedText npcResponse);
 
     // Setup methods
     void setInteraction(const std::string& required, const std::string& reward);
+    void setInteraction(BorrowedText required, BorrowedText reward);
+    void setRewardDescription(const std::string& description);
+    void setRewardDescription(BorrowedText description);
+    void setDialogue(const DialogueGraph* graph, uint32_t root);
     void setAsEnemy(bool enemy);
     void setHasImportantInfo(bool hasInfo);
     void setPreventReinteraction(bool prevent);
     void setHasInteracted(bool interacted);
 
+    // Behavior between turns; the world schedules NPCs with a period (see World::UpdateEntities())
+    void setBehavior(NpcBehavior newBehavior, uint32_t newPeriod);
+    void addPatrolStop(Room* room);
+    void addPatrolStop(EntityHandle room);
+    void setAnnouncement(const std::string& line);
+    void setAnnouncement(BorrowedText line);
+    void setNextUpdate(uint32_t turn) { nextUpdate = turn; }
+
     // Interaction methods
     void talk() const;
+    // Questions do not wait for input: interact() asks through Player::ask()
+    // and returns, and the session passes the next line to answer(); 'node'
+    // is the dialogue node that asked, for Prompt::DIALOGUE
     void interact(Player* player);
-    void handlePlayerInput(const std::string& input, Player* player);
+    void answer(Player* player, Prompt prompt, uint32_t node, std::string response);
+
+    // Acts on its behavior once; returns the turns until the next update,
+    // 0 for none
+    uint32_t update(uint32_t turn, const Player& player);
+
+    State getState() const;
+    void setState(const State& state);
 
     // Status query methods
     bool getIsEnemy() const { return isEnemy; }
     bool hasPlayerInteracted() const;
+    bool getHasImportantInfo() const { return hasImportantInfo; }
+    std::string_view getRequiredItem() const { return requiredItem; }
+    std::string_view getRewardItem() const { return rewardItem; }
+    std::string_view getRewardDescription() const { return rewardDescription; }
+    uint32_t getDialogueRoot() const { return dialogueRoot; }
+    // Answers a dialogue node accepts, separated by spaces
+    std::string getAnswers(uint32_t node) const;
+    const ArenaVector<std::string_view>& getDialogues() const { return dialogues; }
+    const ArenaVector<Response>& getResponses() const { return responses; }
+    NpcBehavior getBehavior() const { return behavior; }
+    uint32_t getPeriod() const { return period; }
+    const ArenaVector<EntityHandle>& getPatrolStops() const { return patrolStops; }
+    std::string_view getAnnouncement() const { return announcement; }
+    uint32_t getNextUpdate() const { return nextUpdate; }
 
     bool isEnemy;             // Determines if NPC is hostile to player
     bool preventReinteraction; // Prevents multiple interactions if set to true
@@ -0,0 +1,178 @@
+#include "NameIndex.h"
+#include "Entity.h"
+#include "EntityArena.h"
+#include "NameTable.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+// ========== Maintenance ==========
+
+void NameIndex::add(Entity* entity) {
+    if (entityCount >= bucketCount) {
+        grow(entity);
+    }
+    entity->nameOrder = nextOrder++;
+    link(entity);
+    entityCount++;
+}
+
+void NameIndex::remove(Entity* entity) {
+    if (entityCount == 0) {
+        return;
+    }
+    unlink(entity);
+    entityCount--;
+}
+
+void NameIndex::clear() {
+    buckets = nullptr;
+    bucketCount = 0;
+    entityCount = 0;
+    nextOrder = 0;
+}
+
+Entity*& NameIndex::headOf(std::string_view lowerName) const {
+    return buckets[std::hash<std::string_view>()(lowerName) & (bucketCount - 1)];
+}
+
+void NameIndex::link(Entity* entity) {
+    // Appended, so entities with the same name stay in listing order
+    Entity*& head = headOf(entity->lowerName);
+    entity->nextNamed = nullptr;
+    if (head == nullptr) {
+        head = entity;
+        entity->previousNamed = entity;
+    }
+    else {
+        Entity* last = head->previousNamed;
+        last->nextNamed = entity;
+        entity->previousNamed = last;
+        head->previousNamed = entity;
+    }
+}
+
+void NameIndex::unlink(Entity* entity) {
+    Entity*& head = headOf(entity->lowerName);
+    if (entity == head) {
+        head = entity->nextNamed;
+        if (head != nullptr) {
+            head->previousNamed = entity->previousNamed;
+        }
+    }
+    else {
+        entity->previousNamed->nextNamed = entity->nextNamed;
+        if (entity->nextNamed != nullptr) {
+            entity->nextNamed->previousNamed = entity->previousNamed;
+        }
+        else {
+            head->previousNamed = entity->previousNamed;
+        }
+    }
+    entity->previousNamed = nullptr;
+    entity->nextNamed = nullptr;
+}
+
+void NameIndex::grow(Entity* entity) {
+    Entity** old = buckets;
+    uint32_t oldCount = bucketCount;
+
+    bucketCount = oldCount == 0 ? FIRST_BUCKET_COUNT : oldCount * 2;
+    buckets = entity->getArena().allocateArray<Entity*>(bucketCount);
+
+    // Each chain moves in order, so same-named entities keep their order
+    for (uint32_t i = 0; i < oldCount; i++) {
+        Entity* chained = old[i];
+        while (chained != nullptr) {
+            Entity* next = chained->nextNamed;
+            link(chained);
+            chained = next;
+        }
+    }
+}
+
+// ========== Lookup ==========
+
+Entity* NameIndex::find(std::string_view name, const NameTable& table, unsigned kinds) const {
+    if (name.empty()) {
+        return nullptr;
+    }
+
+    // Commands arrive lowercase already, other callers get a reused buffer
+    thread_local std::string buffer;
+    std::string_view lowerName = NameTable::Lowercase(name, buffer);
+
+    Entity* entity = findExact(lowerName, kinds);
+    return entity != nullptr ? entity : findPartial(lowerName, table, kinds);
+}
+
+Entity* NameIndex::findExact(std::string_view lowerName, unsigned kinds) const {
+    if (entityCount == 0) {
+        return nullptr;
+    }
+    for (Entity* entity = headOf(lowerName); entity != nullptr; entity = entity->nextNamed) {
+        if ((EntityBucket::BitOf(entity->type) & kinds) != 0 && entity->lowerName == lowerName) {
+            return entity;
+        }
+    }
+    return nullptr;
+}
+
+Entity* NameIndex::NextNamed(const Entity* entity) {
+    for (Entity* next = entity->nextNamed; next != nullptr; next = next->nextNamed) {
+        if (next->lowerName == entity->lowerName) {
+            return next;
+        }
+    }
+    return nullptr;
+}
+
+Entity* NameIndex::findPartial(std::string_view lowerFragment, const NameTable& table, unsigned kinds) const {
+    if (lowerFragment.empty() || entityCount == 0) {
+        return nullptr;
+    }
+
+    // Every candidate contains the fragment, so the closest length is the shortest name
+    Entity* best = nullptr;
+    auto consider = [&best](Entity* entity) {
+        if (best == nullptr || entity->lowerName.size() < best->lowerName.size()
+            || (entity->lowerName.size() == best->lowerName.size() && entity->nameOrder < best->nameOrder)) {
+            best = entity;
+        }
+    };
+
+    // Large index: the world's names containing the fragment, when there
+    // are fewer of them than entities here
+    thread_local std::vector<std::string_view> candidates;
+    bool large = entityCount > SMALL;
+    if (large) {
+        table.findNamesContaining(lowerFragment, candidates);
+    }
+
+    if (!large || candidates.size() >= entityCount) {
+        // Small index: check every entity
+        for (uint32_t i = 0; i < bucketCount; i++) {
+            for (Entity* entity = buckets[i]; entity != nullptr; entity = entity->nextNamed) {
+                if ((EntityBucket::BitOf(entity->type) & kinds) != 0
+                    && entity->lowerName.find(lowerFragment) != std::string_view::npos) {
+                    consider(entity);
+                }
+            }
+        }
+    }
+    else {
+        // Shortest first, so stop after the first length that is present here
+        for (std::string_view name : candidates) {
+            if (best != nullptr && name.size() > best->lowerName.size()) {
+                break;
+            }
+
+            Entity* entity = findExact(name, kinds);
+            if (entity != nullptr) {
+                consider(entity);
+            }
+        }
+    }
+
+    return best;
+}
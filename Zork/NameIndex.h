@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+class Entity;
+class NameTable;
+
+/**
+ * Entities of one container (a room, a bag, the inventory) by interned name.
+ * Resolves what the player typed the same way everywhere: an exact name
+ * (case-insensitive) first, otherwise the entity whose name contains the text
+ * and is closest to it in length, the earliest listed one on ties.
+ *
+ * A hash table chained through the entities themselves (previousNamed and
+ * nextNamed), so adding and removing an entity are constant time and only
+ * touch its chain; an entity is in one index at a time. Entities with the
+ * same name follow each other in the order they were added. The bucket
+ * array comes from the entities' EntityArena and doubles once the entities
+ * outnumber the buckets; an outgrown array stays in the arena until the
+ * world is cleared, and together they are smaller than the array in use.
+ */
+class NameIndex {
+public:
+    void add(Entity* entity);
+    void remove(Entity* entity);
+
+    // Forgets every entity without touching them, e.g. once the arena has been cleared
+    void clear();
+
+    // Every EntityBucket
+    static constexpr unsigned ALL_BUCKETS = ~0u;
+
+    // Exact name, then closest partial name; nullptr if nothing matches.
+    // 'names' is the table of the world the entities belong to, and
+    // 'buckets' limits the search to some kinds of entity (EntityBucket bits).
+    Entity* find(std::string_view name, const NameTable& names, unsigned buckets = ALL_BUCKETS) const;
+
+    // Lowercase lookups
+    Entity* findExact(std::string_view lowerName, unsigned buckets = ALL_BUCKETS) const;
+    Entity* findPartial(std::string_view lowerFragment, const NameTable& names, unsigned buckets = ALL_BUCKETS) const;
+
+    // Entity after this one with the same name, in listing order; nullptr at the last
+    static Entity* NextNamed(const Entity* entity);
+
+    bool empty() const { return entityCount == 0; }
+
+private:
+    // Containers with at most this many entities are searched entity by entity
+    static constexpr uint32_t SMALL = 32;
+    static constexpr uint32_t FIRST_BUCKET_COUNT = 8;
+
+    // Chain heads; a head's previousNamed is the last entity of its chain
+    Entity** buckets = nullptr;
+    uint32_t bucketCount = 0;       // A power of two
+    uint32_t entityCount = 0;
+    uint32_t nextOrder = 0;         // Listing position of the next entity added
+
+    Entity*& headOf(std::string_view lowerName) const;
+    void link(Entity* entity);
+    void unlink(Entity* entity);
+    void grow(Entity* entity);
+};
@@ -0,0 +1,132 @@
+#include "NameTable.h"
+#include <algorithm>
+
+namespace {
+
+    inline char ToLower(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+}
+
+std::string_view NameTable::intern(std::string_view name) {
+    std::string buffer;
+    std::string_view lower = Lowercase(name, buffer);
+    if (shared != nullptr) {
+        std::string_view common = shared->find(lower);
+        if (common.data() != nullptr) {
+            return common;
+        }
+    }
+    auto existing = numbers.find(lower);
+    if (existing != numbers.end()) {
+        return names[existing->second];
+    }
+
+    uint32_t number = static_cast<uint32_t>(names.size());
+    names.emplace_back(lower);
+    std::string_view symbol = names.back();
+    numbers.emplace(symbol, number);
+    addWordSuffixes(number);
+    return symbol;
+}
+
+void NameTable::reserve(size_t count) {
+    numbers.reserve(numbers.size() + count);
+}
+
+void NameTable::clear() {
+    shared = nullptr;
+    wordSuffixes.clear();
+    numbers.clear();
+    names.clear();
+}
+
+void NameTable::share(const NameTable* base) {
+    shared = base;
+}
+
+std::string_view NameTable::find(std::string_view lowerName) const {
+    auto existing = numbers.find(lowerName);
+    return existing != numbers.end() ? std::string_view(names[existing->second]) : std::string_view();
+}
+
+void NameTable::addWordSuffixes(uint32_t number) {
+    // A name is filed once per distinct suffix, and numbers only grow, so
+    // a repeat is always the last entry
+    std::string_view name = names[number];
+    size_t start = 0;
+    while (start < name.size()) {
+        size_t end = std::min(name.find(' ', start), name.size());
+        for (size_t from = start; from < end; from++) {
+            std::vector<uint32_t>& filed = wordSuffixes[name.substr(from, end - from)];
+            if (filed.empty() || filed.back() != number) {
+                filed.push_back(number);
+            }
+        }
+        start = end + 1;
+    }
+}
+
+std::string_view NameTable::Lowercase(std::string_view text, std::string& buffer) {
+    if (IsLowercase(text)) {
+        return text;
+    }
+
+    buffer.assign(text.data(), text.size());
+    for (char& c : buffer) {
+        c = ToLower(c);
+    }
+    return buffer;
+}
+
+bool NameTable::IsLowercase(std::string_view text) {
+    for (char c : text) {
+        if (c >= 'A' && c <= 'Z') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ========== Partial Names ==========
+
+void NameTable::findNamesContaining(std::string_view fragment, std::vector<std::string_view>& found) const {
+    found.clear();
+    if (fragment.empty()) {
+        return;
+    }
+
+    // Shared names count as interned before this table's own
+    if (shared != nullptr) {
+        shared->appendNamesContaining(fragment, found);
+    }
+    appendNamesContaining(fragment, found);
+    std::stable_sort(found.begin(), found.end(),
+        [](std::string_view a, std::string_view b) { return a.size() < b.size(); });
+}
+
+void NameTable::appendNamesContaining(std::string_view fragment, std::vector<std::string_view>& found) const {
+    // Text up to the first space ends a word of any name containing the
+    // fragment, so it starts one of that word's suffixes
+    candidates.clear();
+    std::string_view head = fragment.substr(0, fragment.find(' '));
+    if (head.empty()) {
+        for (uint32_t number = 0; number < names.size(); number++) {
+            candidates.push_back(number);
+        }
+    }
+    else {
+        for (auto suffix = wordSuffixes.lower_bound(head);
+            suffix != wordSuffixes.end() && suffix->first.compare(0, head.size(), head) == 0; ++suffix) {
+            candidates.insert(candidates.end(), suffix->second.begin(), suffix->second.end());
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    }
+
+    for (uint32_t number : candidates) {
+        if (names[number].find(fragment) != std::string::npos) {
+            found.push_back(names[number]);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Symbol table of the lowercase entity names of one world, owned by the
+ * world's EntityArena. Every distinct name is stored once and never moves,
+ * so the returned views stay valid until the world is cleared and two
+ * entities with the same name (in any case) share one canonical form.
+ * Interning also files every suffix of each word of the name, so the names
+ * containing a fragment are found by looking up the fragment's first word
+ * among those suffixes instead of scanning every name. A world only holds
+ * the names of its own entities and drops them all when it is cleared.
+ * A session's world shares the table of its WorldTemplate, which holds
+ * every name of the image: those are handed out from there, and only
+ * names made in play are copied here.
+ */
+class NameTable {
+public:
+    NameTable() = default;
+
+    NameTable(const NameTable&) = delete;
+    NameTable& operator=(const NameTable&) = delete;
+
+    // Canonical lowercase form of a name, interned on first use
+    std::string_view intern(std::string_view name);
+
+    // Sizes the table for 'count' more names, e.g. before loading a world image
+    void reserve(size_t count);
+
+    // Forgets every name and the shared table; views handed out so far dangle
+    void clear();
+
+    // Takes names from 'base' before interning them here; 'base' must
+    // outlive this table or the next clear()
+    void share(const NameTable* base);
+
+    // Interned form of a lowercase name, empty if it is not in the table
+    std::string_view find(std::string_view lowerName) const;
+
+    size_t size() const { return names.size(); }
+
+    // Interned names containing a lowercase fragment, shortest first and in
+    // interning order on ties
+    void findNamesContaining(std::string_view fragment, std::vector<std::string_view>& found) const;
+
+    // 'text' itself when already lowercase, otherwise a lowercase copy in 'buffer'
+    static std::string_view Lowercase(std::string_view text, std::string& buffer);
+
+    static bool IsLowercase(std::string_view text);
+
+private:
+    const NameTable* shared = nullptr;
+    std::deque<std::string> names;      // By number, in interning order
+    std::unordered_map<std::string_view, uint32_t> numbers;
+
+    // Suffix of a word -> numbers of the names with a word ending in it, ascending
+    std::map<std::string_view, std::vector<uint32_t>> wordSuffixes;
+
+    mutable std::vector<uint32_t> candidates;   // Reused by findNamesContaining()
+
+    void addWordSuffixes(uint32_t number);
+    void appendNamesContaining(std::string_view fragment, std::vector<std::string_view>& found) const;
+};
@@ -2,15 +2,18 @@
 #include "Room.h"
 #include "Creature.h"
 #include "Entity.h"
+#include "EntityArena.h"
+#include "EntityCast.h"
 #include "Exit.h"
 #include "NPC.h"
 #include "GameEnums.h"
 #include "Item.h"
-#include <iostream>
+#include "ItemPrototype.h"
+#include "GameIO.h"
 #include <algorithm>
 
-Player::Player(const std::string& name, const std::string& description, Room* room) :
-    Creature(EntityType::PLAYER, name, description, room),
+Player::Player(EntityArena& arena, const std::string& name, const std::string& description, Room* room) :
+    Creature(arena, EntityType::PLAYER, name, description, room),
     lanternTurnsRemaining(0),
     movesTaken(0),
     moralAlignment(0),
@@ -19,51 +22,103 @@ Player::Player(const std::string& name, const std::string& description, Room* ro
     setHealth(100);
 }
 
-// Movement and Location Methods
-bool Player::moveTo(Direction direction) {
-    if (location == nullptr) {
-        std::cout << "You are nowhere!" << std::endl;
-        return false;
+Player::State Player::getState() const {
+    const NPC* asker = getArena().get<NPC>(promptFrom);
+    return State{ getHealth(), getMaxHealth(), lanternTurnsRemaining, moralAlignment,
+        hasBetrayedNPCs, hasSacrificed, movesTaken, ending,
+        prompt, asker != nullptr ? asker->getRecord() : NO_RECORD, promptNode };
+}
+
+void Player::setState(const State& state) {
+    restoreHealth(state.health, state.maxHealth);
+    lanternTurnsRemaining = state.lanternTurnsRemaining;
+    moralAlignment = state.moralAlignment;
+    hasBetrayedNPCs = state.hasBetrayedNPCs;
+    hasSacrificed = state.hasSacrificed;
+    movesTaken = state.movesTaken;
+    ending = state.ending;
+    prompt = state.prompt;
+    promptFrom = EntityHandle::None();
+    promptNode = state.promptNode;
+}
+
+// ========== Questions ==========
+
+void Player::ask(Prompt question, NPC* asker, uint32_t node) {
+    prompt = question;
+    promptFrom = asker != nullptr ? asker->getHandle() : EntityHandle::None();
+    promptNode = node;
+}
+
+std::string Player::getPromptAnswers() const {
+    const NPC* asker = getArena().get<NPC>(promptFrom);
+    if (prompt == Prompt::DIALOGUE && asker != nullptr) {
+        return asker->getAnswers(promptNode);
     }
+    return promptAnswers(prompt);
+}
+
+bool Player::answer(const std::string& response) {
+    Prompt question = prompt;
+    NPC* asker = getArena().get<NPC>(promptFrom);
+    prompt = Prompt::NONE;
+    promptFrom = EntityHandle::None();
 
-    Entity* exitEntity = location->getExit(direction);
-    if (exitEntity == nullptr) {
-        std::cout << "You can't go that way." << std::endl;
+    switch (question) {
+    case Prompt::NONE:
+        return false;
+    case Prompt::DROP_LANTERN:
+        answerDropLantern(response);
+        return false;
+    case Prompt::AMULET_ENDING:
+        return answerAmuletEnding(response);
+    default:
+        if (asker != nullptr) {
+            asker->answer(this, question, promptNode, response);
+        }
         return false;
     }
+}
 
-    if (exitEntity->getType() != EntityType::EXIT) {
-        std::cout << "That's not a valid exit." << std::endl;
+// Movement and Location Methods
+bool Player::moveTo(Direction direction, bool describeArrival) {
+    if (getLocation() == nullptr) {
+        GameIO::Out() << "You are nowhere!" << std::endl;
         return false;
     }
 
-    Exit* exit = dynamic_cast<Exit*>(exitEntity);
+    Exit* exit = getLocation()->getExit(direction);
     if (exit == nullptr) {
-        std::cout << "Something strange happened with that exit." << std::endl;
+        GameIO::Out() << "You can't go that way." << std::endl;
         return false;
     }
 
     if (exit->isLocked()) {
-        std::cout << "The " << exit->getName() << " is locked. You need a "
+        GameIO::Out() << "The " << exit->getName() << " is locked. You need a "
             << exit->getKeyName() << " to open it." << std::endl;
         return false;
     }
 
     Room* destination = exit->getDestination();
     if (destination == nullptr) {
-        std::cout << "The exit leads nowhere!" << std::endl;
+        GameIO::Out() << "The exit leads nowhere!" << std::endl;
         return false;
     }
 
-    std::cout << "You go " << directionToString(direction) << " to "
+    GameIO::Out() << "You go " << directionToString(direction) << " to "
         << destination->getName() << "." << std::endl;
 
     setLocation(destination);
 
+    // Rooms passed through on a longer walk are not described
+    if (!describeArrival) {
+        return true;
+    }
+
     if (destination->getIsDark() && !hasActiveLantern()) {
-        std::cout << "\nYou step into pitch darkness. You can't see a thing!\n";
-        std::cout << "You should use your lantern if you have one, or flee immediately.\n";
-        std::cout << "You sense movement in the shadows around you...\n";
+        GameIO::Out() << "\nYou step into pitch darkness. You can't see a thing!\n";
+        GameIO::Out() << "You should use your lantern if you have one, or flee immediately.\n";
+        GameIO::Out() << "You sense movement in the shadows around you...\n";
     }
     else {
         destination->look();
@@ -74,38 +129,37 @@ bool Player::moveTo(Direction direction) {
 
 // Inventory Management Methods
 bool Player::takeItem(const std::string& itemName) {
-    if (location == nullptr) return false;
-    if (location->getIsDark() && !hasActiveLantern()) {
-        std::cout << "You blindly grope around in the darkness, but can't find anything.\n";
-        std::cout << "Using your lantern would be much safer than fumbling in the dark.\n";
+    if (getLocation() == nullptr) return false;
+    if (getLocation()->getIsDark() && !hasActiveLantern()) {
+        GameIO::Out() << "You blindly grope around in the darkness, but can't find anything.\n";
+        GameIO::Out() << "Using your lantern would be much safer than fumbling in the dark.\n";
         return false;
     }
 
     // First check if the item is in the current room (existing functionality)
-    Entity* entity = location->findEntity(itemName);
-    if (entity && entity->getType() == EntityType::ITEM) {
-        Item* item = dynamic_cast<Item*>(entity);
+    Item* item = static_cast<Item*>(getLocation()->findEntity(itemName, EntityBucket::ITEMS));
+    if (item != nullptr) {
         // Check if the item is fixed in place
         if (item->getIsFixedInPlace()) {
-            std::cout << "The " << item->getName() << " is firmly fixed in place and cannot be moved." << std::endl;
+            GameIO::Out() << "The " << item->getName() << " is firmly fixed in place and cannot be moved." << std::endl;
             return false;
         }
         if (canCarryMoreItems()) {
-            location->removeEntity(entity);
-            inventory.push_back(entity);
-            std::cout << "You took the " << entity->getName() << "." << std::endl;
+            getLocation()->removeEntity(item);
+            inventory.add(item);
+            GameIO::Out() << "You took the " << item->getName() << "." << std::endl;
             return true;
         }
         else {
-            std::cout << "You can't carry more items right now." << std::endl;
+            GameIO::Out() << "You can't carry more items right now." << std::endl;
             return false;
         }
     }
 
     // If not in room, check inside containers in inventory
     for (Entity* containerEntity : inventory) {
-        if (containerEntity->getType() == EntityType::ITEM) {
-            Item* containerItem = dynamic_cast<Item*>(containerEntity);
+        Item* containerItem = entity_cast<Item>(containerEntity);
+        if (containerItem != nullptr) {
             if (containerItem->getIsContainer()) {
                 // Check if the item is in this container
                 Entity* containedEntity = nullptr;
@@ -120,13 +174,13 @@ bool Player::takeItem(const std::string& itemName) {
                     // Found the item inside this container
                     if (canCarryMoreItems()) {
                         containerItem->removeEntity(containedEntity);
-                        inventory.push_back(containedEntity);
-                        std::cout << "You took the " << containedEntity->getName()
+                        inventory.add(containedEntity);
+                        GameIO::Out() << "You took the " << containedEntity->getName()
                             << " from the " << containerItem->getName() << "." << std::endl;
                         return true;
                     }
                     else {
-                        std::cout << "You can't carry more items right now." << std::endl;
+                        GameIO::Out() << "You can't carry more items right now." << std::endl;
                         return false;
                     }
                 }
@@ -135,129 +189,108 @@ bool Player::takeItem(const std::string& itemName) {
     }
 
     // Item wasn't found in room or containers
-    std::cout << "You don't see ";
+    GameIO::Out() << "You don't see ";
     if (itemName.find(' ') != std::string::npos) {
-        std::cout << "\"" << itemName << "\"";
+        GameIO::Out() << "\"" << itemName << "\"";
     }
     else {
-        std::cout << itemName;
+        GameIO::Out() << itemName;
     }
-    std::cout << " here." << std::endl;
-    if (!location->getIsDark() || hasActiveLantern()) {
-        std::cout << "You see: ";
+    GameIO::Out() << " here." << std::endl;
+    if (!getLocation()->getIsDark() || hasActiveLantern()) {
+        GameIO::Out() << "You see: ";
         bool first = true;
-        for (auto entity : location->getContains()) {
-            if (entity->getType() == EntityType::ITEM) {
-                if (!first) std::cout << ", ";
-                std::cout << entity->getName();
-                first = false;
-            }
+        for (auto entity : getLocation()->getContains(EntityBucket::ITEMS)) {
+            if (!first) GameIO::Out() << ", ";
+            GameIO::Out() << entity->getName();
+            first = false;
         }
         if (first) {
-            std::cout << "no items";
+            GameIO::Out() << "no items";
         }
-        std::cout << std::endl;
+        GameIO::Out() << std::endl;
     }
     return false;
 }
 
 bool Player::dropItem(const std::string& itemName) {
-    for (auto it = inventory.begin(); it != inventory.end(); ++it) {
-        if ((*it)->getName() == itemName) {
-            if (itemName == "lantern" && dynamic_cast<Item*>(*it)->getIsLit() &&
-                location && location->getIsDark()) {
-                std::cout << "You hesitate to drop your lit lantern in this darkness.\n";
-                std::cout << "That would leave you vulnerable to whatever lurks here.\n";
-
-                std::cout << "Are you sure? (y/n): ";
-                std::string response;
-                std::getline(std::cin, response);
-                std::transform(response.begin(), response.end(), response.begin(), ::tolower);
-
-                if (response != "y" && response != "yes") {
-                    std::cout << "Wise decision. You keep the lantern.\n";
-                    return false;
-                }
-
-                std::cout << "You drop the lantern. Its light continues to illuminate the area...\n";
-                std::cout << "...but you realize that would be a terrible idea. You pick it back up.\n";
-                return false;
-            }
+    Entity* item = inventory.findByName(itemName);
+    if (item != nullptr) {
+        const Item* lantern = entity_cast<Item>(item);
+        if (itemName == "lantern" && lantern != nullptr && lantern->getIsLit() &&
+            getLocation() && getLocation()->getIsDark()) {
+            GameIO::Out() << "You hesitate to drop your lit lantern in this darkness.\n";
+            GameIO::Out() << "That would leave you vulnerable to whatever lurks here.\n";
+
+            GameIO::Out() << "Are you sure? (y/n): ";
+            ask(Prompt::DROP_LANTERN);
+            return false;
+        }
 
-            if (location != nullptr) {
-                location->addEntity(*it);
-            }
-            inventory.erase(it);
-            std::cout << "You dropped the " << itemName << "." << std::endl;
-            return true;
+        inventory.remove(item);
+        if (getLocation() != nullptr) {
+            getLocation()->addEntity(item);
         }
+        GameIO::Out() << "You dropped the " << itemName << "." << std::endl;
+        return true;
     }
 
-    std::cout << "You don't have a " << itemName << "." << std::endl;
+    GameIO::Out() << "You don't have a " << itemName << "." << std::endl;
     return false;
 }
 
+void Player::answerDropLantern(std::string response) {
+    std::transform(response.begin(), response.end(), response.begin(), ::tolower);
+
+    if (response != "y" && response != "yes") {
+        GameIO::Out() << "Wise decision. You keep the lantern.\n";
+        return;
+    }
+
+    GameIO::Out() << "You drop the lantern. Its light continues to illuminate the area...\n";
+    GameIO::Out() << "...but you realize that would be a terrible idea. You pick it back up.\n";
+}
+
 void Player::showInventory() const {
     if (inventory.empty()) {
-        std::cout << "You're not carrying anything." << std::endl;
+        GameIO::Out() << "You're not carrying anything." << std::endl;
         return;
     }
 
-    std::cout << "You're carrying:" << std::endl;
+    GameIO::Out() << "You're carrying:" << std::endl;
     for (auto item : inventory) {
         if (item->getName() == "lantern") {
-            Item* lantern = dynamic_cast<Item*>(item);
-            std::cout << "- " << item->getName();
+            Item* lantern = entity_cast<Item>(item);
+            GameIO::Out() << "- " << item->getName();
             if (lantern && lantern->getIsLit()) {
-                std::cout << " (lit, " << lanternTurnsRemaining << " turns remaining)";
+                GameIO::Out() << " (lit, " << lanternTurnsRemaining << " turns remaining)";
             }
             else {
-                std::cout << " (unlit)";
+                GameIO::Out() << " (unlit)";
             }
-            std::cout << std::endl;
+            GameIO::Out() << std::endl;
         }
         else {
-            std::cout << "- " << item->getName() << std::endl;
+            GameIO::Out() << "- " << item->getName() << std::endl;
         }
     }
 }
 
-bool Player::hasItem(const std::string& itemName) const {
-    std::string lowerInput = itemName;
-    std::transform(lowerInput.begin(), lowerInput.end(), lowerInput.begin(), ::tolower);
-
-    for (auto item : inventory) {
-        std::string lowerItemName = item->getName();
-        std::transform(lowerItemName.begin(), lowerItemName.end(), lowerItemName.begin(), ::tolower);
-
-        if (lowerItemName == lowerInput) {
-            return true;
-        }
-    }
-    return false;
+bool Player::hasItem(std::string_view itemName) const {
+    return inventory.findIgnoringCase(itemName) != nullptr;
 }
 
 void Player::addItem(Entity* item) {
-    inventory.push_back(item);
+    inventory.add(item);
 }
 
-bool Player::removeItem(const std::string& itemName) {
-    for (auto it = inventory.begin(); it != inventory.end(); ++it) {
-        if ((*it)->getName() == itemName) {
-            inventory.erase(it);
-            return true;
-        }
-    }
-    return false;
+bool Player::removeItem(std::string_view itemName) {
+    Entity* item = inventory.findByName(itemName);
+    return item != nullptr && inventory.remove(item);
 }
 
 bool Player::hasBackpack() const {
-    for (auto item : inventory) {
-        if (item->getName() == "backpack") {
-            return true;
-        }
-    }
-    return false;
+    return inventory.has(Inventory::BACKPACK);
 }
 
 bool Player::canCarryMoreItems() const {
@@ -269,121 +302,87 @@ bool Player::canCarryMoreItems() const {
 
 // Item Interaction Methods
 bool Player::useItem(const std::string& itemName) {
-    Entity* itemToUse = nullptr;
     std::string lowerInput = itemName;
     std::transform(lowerInput.begin(), lowerInput.end(), lowerInput.begin(), ::tolower);
 
-    for (auto item : inventory) {
-        std::string lowerItemName = item->getName();
-        std::transform(lowerItemName.begin(), lowerItemName.end(), lowerItemName.begin(), ::tolower);
-
-        if (lowerItemName == lowerInput) {
-            itemToUse = item;
-            break;
-        }
-    }
-
-    if (!itemToUse) {
-        int bestMatchLength = 0;
-        for (auto item : inventory) {
-            string lowerItemName = item->getName();
-            transform(lowerItemName.begin(), lowerItemName.end(), lowerItemName.begin(), ::tolower);
-
-            if (lowerItemName.find(lowerInput) != string::npos) {
-                // Prefer the item with the closest name length
-                if (itemToUse == nullptr || abs(static_cast<int>(lowerItemName.length()) - static_cast<int>(lowerInput.length()))
-                    < bestMatchLength) {
-                    itemToUse = item;
-                    bestMatchLength = abs(static_cast<int>(lowerItemName.length()) - static_cast<int>(lowerInput.length()));
-                }
-            }
-        }
-    }
+    // Exact name first, then the item with the closest name length
+    Entity* itemToUse = inventory.resolve(lowerInput, getArena().getNames());
 
     // Lantern handling
     if (lowerInput == "lantern" || (itemToUse && itemToUse->getName() == "lantern")) {
         Item* lantern = nullptr;
 
         if (!itemToUse || itemToUse->getName() != "lantern") {
-            for (auto item : inventory) {
-                if (item->getName() == "lantern") {
-                    lantern = dynamic_cast<Item*>(item);
-                    break;
-                }
-            }
+            lantern = entity_cast<Item>(inventory.findByName("lantern"));
         }
         else {
-            lantern = dynamic_cast<Item*>(itemToUse);
+            lantern = entity_cast<Item>(itemToUse);
         }
 
         if (lantern) {
             if (lantern->getIsLit()) {
-                std::cout << "The lantern is already lit.\n";
+                GameIO::Out() << "The lantern is already lit.\n";
 
                 if (lanternTurnsRemaining > 0) {
-                    std::cout << "It will last for " << lanternTurnsRemaining << " more turns.\n";
+                    GameIO::Out() << "It will last for " << lanternTurnsRemaining << " more turns.\n";
                 }
                 else {
-                    std::cout << "But it seems to be out of fuel.\n";
+                    GameIO::Out() << "But it seems to be out of fuel.\n";
                 }
             }
             else {
-                lantern->setLit(true);
+                inventory.setLit(lantern, true);
                 lanternTurnsRemaining = 10;
 
-                if (location->getIsDark()) {
-                    std::cout << "The lantern flames to life, its golden light pushing back the darkness!\n";
-                    std::cout << "Shadows flee to the corners as you can now see clearly.\n";
-                    std::cout << "The lantern will last for " << lanternTurnsRemaining << " turns.\n";
-                    location->look();
+                if (getLocation()->getIsDark()) {
+                    GameIO::Out() << "The lantern flames to life, its golden light pushing back the darkness!\n";
+                    GameIO::Out() << "Shadows flee to the corners as you can now see clearly.\n";
+                    GameIO::Out() << "The lantern will last for " << lanternTurnsRemaining << " turns.\n";
+                    getLocation()->look();
                 }
                 else {
-                    std::cout << "You light the lantern. It will last for about " << lanternTurnsRemaining << " turns.\n";
+                    GameIO::Out() << "You light the lantern. It will last for about " << lanternTurnsRemaining << " turns.\n";
                 }
             }
             return true;
         }
         else {
-            std::cout << "You don't have a lantern.\n";
+            GameIO::Out() << "You don't have a lantern.\n";
             return false;
         }
     }
 
     if (!itemToUse) {
-        std::cout << "You don't have '" << itemName << "'.";
+        GameIO::Out() << "You don't have '" << itemName << "'.";
         if (!inventory.empty()) {
-            std::cout << " You have: ";
+            GameIO::Out() << " You have: ";
             for (auto item : inventory) {
-                std::cout << item->getName();
+                GameIO::Out() << item->getName();
                 if (item != inventory.back()) {
-                    std::cout << ", ";
+                    GameIO::Out() << ", ";
                 }
             }
         }
-        std::cout << std::endl;
+        GameIO::Out() << std::endl;
         return false;
     }
 
     // Check for locked exits
     Room* currentRoom = getLocation();
     if (currentRoom) {
-        for (auto exitPair : currentRoom->getExits()) {
-            Entity* exitEntity = exitPair.second;
-            if (exitEntity->getType() == EntityType::EXIT) {
-                Exit* exit = dynamic_cast<Exit*>(exitEntity);
-                if (exit && exit->isLocked()) {
-                    if (itemToUse->nameMatches(exit->getKeyName())) {
-                        if (currentRoom->getIsDark() && !hasActiveLantern()) {
-                            std::cout << "You fumble with the " << itemToUse->getName() << " in the darkness,\n";
-                            std::cout << "but can't find the keyhole. You need light to unlock doors here.\n";
-                            return false;
-                        }
-
-                        if (exit->unlock(itemToUse->getName())) {
-                            std::cout << "You use the " << itemToUse->getName()
-                                << " to unlock the " << exit->getName() << "." << std::endl;
-                            return true;
-                        }
+        for (Exit* exit : currentRoom->getExits()) {
+            if (exit && exit->isLocked()) {
+                if (itemToUse->nameMatches(exit->getKeyName())) {
+                    if (currentRoom->getIsDark() && !hasActiveLantern()) {
+                        GameIO::Out() << "You fumble with the " << itemToUse->getName() << " in the darkness,\n";
+                        GameIO::Out() << "but can't find the keyhole. You need light to unlock doors here.\n";
+                        return false;
+                    }
+
+                    if (exit->unlock(itemToUse->getName())) {
+                        GameIO::Out() << "You use the " << itemToUse->getName()
+                            << " to unlock the " << exit->getName() << "." << std::endl;
+                        return true;
                     }
                 }
             }
@@ -394,31 +393,30 @@ bool Player::useItem(const std::string& itemName) {
     if (itemToUse->getName() == "potion") {
         int previousHealth = getHealth();
         heal(25);
-        std::cout << "You drink the potion. A surge of warmth floods your veins, healing your wounds.\n";
-        std::cout << "Health restored: " << getHealth() - previousHealth << " points. ";
-        std::cout << "Current health: " << getHealth() << "/" << getMaxHealth() << std::endl;
+        GameIO::Out() << "You drink the potion. A surge of warmth floods your veins, healing your wounds.\n";
+        GameIO::Out() << "Health restored: " << getHealth() - previousHealth << " points. ";
+        GameIO::Out() << "Current health: " << getHealth() << "/" << getMaxHealth() << std::endl;
 
         removeItem(itemToUse->getName());
         return true;
     }
 
-    std::cout << "You're not sure how to use the " << itemToUse->getName() << " here." << std::endl;
+    GameIO::Out() << "You're not sure how to use the " << itemToUse->getName() << " here." << std::endl;
     return false;
 }
 
 bool Player::combineItems(const std::string& item1, const std::string& item2) {
-    std::cout << "Nothing happens when you try to combine " << item1 << " and " << item2 << "." << std::endl;
+    GameIO::Out() << "Nothing happens when you try to combine " << item1 << " and " << item2 << "." << std::endl;
     return false;
 }
 
 // Amulet Fragment Methods
 bool Player::hasAmuletFragment(const std::string& fragmentName) const {
-    for (auto item : inventory) {
-        if (item->getName() == fragmentName) {
-            return true;
-        }
+    unsigned flag = Inventory::FlagFor(fragmentName);
+    if (flag & Inventory::FRAGMENTS) {
+        return inventory.has(flag);
     }
-    return false;
+    return inventory.findByName(fragmentName) != nullptr;
 }
 
 bool Player::combineAmuletFragments() {
@@ -429,35 +427,35 @@ bool Player::combineAmuletFragments() {
         if (hasAmuletFragment("ruby")) fragmentCount++;
 
         if (fragmentCount > 0) {
-            std::cout << "\nThe " << (fragmentCount == 1 ? "fragment" : "fragments")
+            GameIO::Out() << "\nThe " << (fragmentCount == 1 ? "fragment" : "fragments")
                 << " in your inventory pulse weakly but nothing happens.\n";
-            std::cout << "You sense they need to be brought to the Ruined Temple to be combined.\n";
+            GameIO::Out() << "You sense they need to be brought to the Ruined Temple to be combined.\n";
 
-            std::cout << "You have ";
+            GameIO::Out() << "You have ";
             bool first = true;
             if (hasAmuletFragment("amethyst")) {
-                std::cout << "amethyst";
+                GameIO::Out() << "amethyst";
                 first = false;
             }
             if (hasAmuletFragment("sapphire")) {
-                if (!first) std::cout << ", ";
-                std::cout << "sapphire";
+                if (!first) GameIO::Out() << ", ";
+                GameIO::Out() << "sapphire";
                 first = false;
             }
             if (hasAmuletFragment("ruby")) {
-                if (!first) std::cout << ", ";
-                std::cout << "ruby";
+                if (!first) GameIO::Out() << ", ";
+                GameIO::Out() << "ruby";
             }
-            std::cout << " fragment" << (fragmentCount > 1 ? "s" : "") << ".\n";
+            GameIO::Out() << " fragment" << (fragmentCount > 1 ? "s" : "") << ".\n";
         }
         else {
-            std::cout << "You don't have any amulet fragments to combine.\n";
+            GameIO::Out() << "You don't have any amulet fragments to combine.\n";
         }
         return false;
     }
 
     bool onAltar = false;
-    for (auto entity : getLocation()->getContains()) {
+    for (auto entity : getLocation()->getContains(EntityBucket::ITEMS)) {
         if (entity->getName() == "forge") {
             onAltar = true;
             break;
@@ -465,8 +463,8 @@ bool Player::combineAmuletFragments() {
     }
 
     if (!onAltar) {
-        std::cout << "\nThe fragments vibrate intensely but refuse to combine.\n";
-        std::cout << "You noticed an ancient forge in the temple - perhaps they need to be placed there?\n";
+        GameIO::Out() << "\nThe fragments vibrate intensely but refuse to combine.\n";
+        GameIO::Out() << "You noticed an ancient forge in the temple - perhaps they need to be placed there?\n";
         return false;
     }
 
@@ -475,49 +473,46 @@ bool Player::combineAmuletFragments() {
         hasAmuletFragment("ruby");
 
     if (!hasAll) {
-        std::cout << "\nYou stand before the altar with ";
+        GameIO::Out() << "\nYou stand before the altar with ";
         int fragmentCount = 0;
         if (hasAmuletFragment("amethyst")) fragmentCount++;
         if (hasAmuletFragment("sapphire")) fragmentCount++;
         if (hasAmuletFragment("ruby")) fragmentCount++;
 
-        std::cout << "only " << fragmentCount << " fragment" << (fragmentCount > 1 ? "s" : "") << ".\n";
-        std::cout << "The altar's three depressions mock you with their emptiness.\n";
+        GameIO::Out() << "only " << fragmentCount << " fragment" << (fragmentCount > 1 ? "s" : "") << ".\n";
+        GameIO::Out() << "The altar's three depressions mock you with their emptiness.\n";
 
-        std::cout << "You're missing: ";
+        GameIO::Out() << "You're missing: ";
         bool first = true;
         if (!hasAmuletFragment("amethyst")) {
-            std::cout << "amethyst";
+            GameIO::Out() << "amethyst";
             first = false;
         }
         if (!hasAmuletFragment("sapphire")) {
-            if (!first) std::cout << ", ";
-            std::cout << "sapphire";
+            if (!first) GameIO::Out() << ", ";
+            GameIO::Out() << "sapphire";
             first = false;
         }
         if (!hasAmuletFragment("ruby")) {
-            if (!first) std::cout << ", ";
-            std::cout << "ruby";
+            if (!first) GameIO::Out() << ", ";
+            GameIO::Out() << "ruby";
         }
-        std::cout << ".\n";
+        GameIO::Out() << ".\n";
         return false;
     }
 
-    std::cout << "\nAs you place the three fragments in the forge:\n";
-    std::cout << "1. The amethyst begins humming at a piercing frequency\n";
-    std::cout << "2. The sapphire emits a wave of comforting warmth\n";
-    std::cout << "3. The ruby burns with sudden intensity\n\n";
-    std::cout << "The fragments rise into the air, spinning rapidly as arcane energy connects them!\n";
-    std::cout << "With a blinding flash and thunderous BOOM, the Amulet of Eldoria is restored!\n";
+    GameIO::Out() << "\nAs you place the three fragments in the forge:\n";
+    GameIO::Out() << "1. The amethyst begins humming at a piercing frequency\n";
+    GameIO::Out() << "2. The sapphire emits a wave of comforting warmth\n";
+    GameIO::Out() << "3. The ruby burns with sudden intensity\n\n";
+    GameIO::Out() << "The fragments rise into the air, spinning rapidly as arcane energy connects them!\n";
+    GameIO::Out() << "With a blinding flash and thunderous BOOM, the Amulet of Eldoria is restored!\n";
 
     removeItem("amethyst");
     removeItem("sapphire");
     removeItem("ruby");
 
-    Item* amulet = new Item("Amulet of Eldoria",
-        "The fully restored artifact thrums with primordial energy.\n"
-        "You feel its power resonating with your very soul.",
-        false, 0, false);
+    Item* amulet = getArena().create<Item>(ItemPrototype::Stock(StockItem::AMULET));
     addItem(amulet);
 
     return true;
@@ -526,14 +521,14 @@ bool Player::combineAmuletFragments() {
 bool Player::placeAmuletOnAltar() {
     if (getLocation()->getName() != "Sorcerer's Tower") {
         if (hasItem("Amulet of Eldoria")) {
-            std::cout << "\nThe amulet pulses powerfully but nothing happens.\n";
-            std::cout << "You sense it must be placed in the Sorcerer's Tower to break the curse.\n";
+            GameIO::Out() << "\nThe amulet pulses powerfully but nothing happens.\n";
+            GameIO::Out() << "You sense it must be placed in the Sorcerer's Tower to break the curse.\n";
         }
         return false;
     }
 
     bool altarExists = false;
-    for (auto entity : getLocation()->getContains()) {
+    for (auto entity : getLocation()->getContains(EntityBucket::ITEMS)) {
         if (entity->getName() == "altar") {
             altarExists = true;
             break;
@@ -541,168 +536,172 @@ bool Player::placeAmuletOnAltar() {
     }
 
     if (!altarExists) {
-        std::cout << "There's no altar here to place the amulet on!\n";
+        GameIO::Out() << "There's no altar here to place the amulet on!\n";
         return false;
     }
 
     if (!hasItem("Amulet of Eldoria")) {
-        std::cout << "You need the restored Amulet of Eldoria to break the curse.\n";
+        GameIO::Out() << "You need the restored Amulet of Eldoria to break the curse.\n";
         return false;
     }
 
-    std::cout << "\nAs you approach the altar with the amulet, you feel immense power flowing through your veins.\n";
-    std::cout << "The amulet grows warm in your hands, whispering temptations of unlimited power.\n\n";
+    GameIO::Out() << "\nAs you approach the altar with the amulet, you feel immense power flowing through your veins.\n";
+    GameIO::Out() << "The amulet grows warm in your hands, whispering temptations of unlimited power.\n\n";
 
-    std::cout << "What will you choose?\n";
-    std::cout << "1. Place the amulet on the altar to break the curse (Selfless)\n";
-    std::cout << "2. Absorb the amulet's power for yourself (Selfish)\n";
-    std::cout << "3. Destroy the amulet forever (Neutral)\n";
-    std::cout << "4. Hesitate and reconsider your options\n";
-    std::cout << "Choose (1-4): ";
-
-    std::string choice;
-    std::getline(std::cin, choice);
+    GameIO::Out() << "What will you choose?\n";
+    GameIO::Out() << "1. Place the amulet on the altar to break the curse (Selfless)\n";
+    GameIO::Out() << "2. Absorb the amulet's power for yourself (Selfish)\n";
+    GameIO::Out() << "3. Destroy the amulet forever (Neutral)\n";
+    GameIO::Out() << "4. Hesitate and reconsider your options\n";
+    GameIO::Out() << "Choose (1-4): ";
+    ask(Prompt::AMULET_ENDING);
+    return false;
+}
 
+bool Player::answerAmuletEnding(const std::string& choice) {
     if (choice == "1") {
-        std::cout << "\nWith trembling hands, you place the Amulet of Eldoria on the ancient altar...\n\n";
-        std::cout << "A brilliant light erupts from the amulet, filling the room!\n";
-        std::cout << "The tower shakes as dark energy swirls around you, drawn into the amulet.\n";
+        GameIO::Out() << "\nWith trembling hands, you place the Amulet of Eldoria on the ancient altar...\n\n";
+        GameIO::Out() << "A brilliant light erupts from the amulet, filling the room!\n";
+        GameIO::Out() << "The tower shakes as dark energy swirls around you, drawn into the amulet.\n";
 
         if (getAlignment() > 3) {
-            std::cout << "The amulet recognizes your pure heart and amplifies your noble intentions.\n";
-            std::cout << "Not only is the curse broken, but the land begins to heal at an astonishing rate!\n";
-            std::cout << "The villagers will speak of your heroism for generations to come.\n";
-            std::cout << "*** PERFECT ENDING: LEGENDARY HERO ***\n";
+            GameIO::Out() << "The amulet recognizes your pure heart and amplifies your noble intentions.\n";
+            GameIO::Out() << "Not only is the curse broken, but the land begins to heal at an astonishing rate!\n";
+            GameIO::Out() << "The villagers will speak of your heroism for generations to come.\n";
+            GameIO::Out() << "*** PERFECT ENDING: LEGENDARY HERO ***\n";
+            setEnding(Ending::LEGENDARY_HERO);
         }
         else {
-            std::cout << "The amulet's glow intensifies, absorbing all the cursed energy.\n\n";
-            std::cout << "Suddenly - SILENCE.\n\n";
-            std::cout << "The curse is broken! Eldoria is saved!\n";
-            std::cout << "*** GOOD ENDING: SAVIOR OF ELDORIA ***\n";
+            GameIO::Out() << "The amulet's glow intensifies, absorbing all the cursed energy.\n\n";
+            GameIO::Out() << "Suddenly - SILENCE.\n\n";
+            GameIO::Out() << "The curse is broken! Eldoria is saved!\n";
+            GameIO::Out() << "*** GOOD ENDING: SAVIOR OF ELDORIA ***\n";
+            setEnding(Ending::SAVIOR);
         }
         return true;
     }
     else if (choice == "2") {
-        std::cout << "\nYou clutch the amulet tightly, feeling its power coursing through you...\n";
+        GameIO::Out() << "\nYou clutch the amulet tightly, feeling its power coursing through you...\n";
 
         if (getAlignment() < -5 || hasBetrayed()) {
-            std::cout << "The amulet recognizes the darkness in your heart and bonds with your corrupt soul.\n";
-            std::cout << "Immense power floods your body as your eyes turn pitch black.\n";
-            std::cout << "The villagers of Eldoria will serve their new dark master - YOU.\n";
-            std::cout << "*** DARK ENDING: RISE OF A TYRANT ***\n";
+            GameIO::Out() << "The amulet recognizes the darkness in your heart and bonds with your corrupt soul.\n";
+            GameIO::Out() << "Immense power floods your body as your eyes turn pitch black.\n";
+            GameIO::Out() << "The villagers of Eldoria will serve their new dark master - YOU.\n";
+            GameIO::Out() << "*** DARK ENDING: RISE OF A TYRANT ***\n";
+            setEnding(Ending::TYRANT);
         }
         else {
-            std::cout << "You attempt to absorb the amulet's power, but it resists your will!\n";
-            std::cout << "The power is too great for your unprepared body and mind.\n";
-            std::cout << "The amulet shatters in your hands, releasing a blast that consumes you.\n";
-            std::cout << "*** BAD ENDING: CONSUMED BY POWER ***\n";
+            GameIO::Out() << "You attempt to absorb the amulet's power, but it resists your will!\n";
+            GameIO::Out() << "The power is too great for your unprepared body and mind.\n";
+            GameIO::Out() << "The amulet shatters in your hands, releasing a blast that consumes you.\n";
+            GameIO::Out() << "*** BAD ENDING: CONSUMED BY POWER ***\n";
+            setEnding(Ending::CONSUMED);
             takeDamage(getHealth());
         }
         return true;
     }
     else if (choice == "3") {
-        std::cout << "\nYou raise the amulet high and slam it down onto the altar with all your might.\n";
-        std::cout << "The amulet shatters with a deafening crack!\n\n";
+        GameIO::Out() << "\nYou raise the amulet high and slam it down onto the altar with all your might.\n";
+        GameIO::Out() << "The amulet shatters with a deafening crack!\n\n";
 
         if (getAlignment() > 0) {
-            std::cout << "The magical energies disperse harmlessly, washing over the land.\n";
-            std::cout << "The curse fades gradually, though Eldoria will never regain its former glory.\n";
-            std::cout << "The age of magic in this realm has come to an end.\n";
-            std::cout << "*** NEUTRAL ENDING: AGE OF BALANCE ***\n";
+            GameIO::Out() << "The magical energies disperse harmlessly, washing over the land.\n";
+            GameIO::Out() << "The curse fades gradually, though Eldoria will never regain its former glory.\n";
+            GameIO::Out() << "The age of magic in this realm has come to an end.\n";
+            GameIO::Out() << "*** NEUTRAL ENDING: AGE OF BALANCE ***\n";
+            setEnding(Ending::AGE_OF_BALANCE);
         }
         else {
-            std::cout << "The magical energies explode outward violently!\n";
-            std::cout << "The curse is broken, but much of Eldoria's natural magic is forever lost.\n";
-            std::cout << "You survive, but wonder if your choice was truly the best one.\n";
-            std::cout << "*** NEUTRAL ENDING: PYRRHIC VICTORY ***\n";
+            GameIO::Out() << "The magical energies explode outward violently!\n";
+            GameIO::Out() << "The curse is broken, but much of Eldoria's natural magic is forever lost.\n";
+            GameIO::Out() << "You survive, but wonder if your choice was truly the best one.\n";
+            GameIO::Out() << "*** NEUTRAL ENDING: PYRRHIC VICTORY ***\n";
+            setEnding(Ending::PYRRHIC_VICTORY);
         }
         return true;
     }
     else {
-        std::cout << "\nYou step back from the altar, the weight of your decision heavy on your shoulders.\n";
-        std::cout << "Perhaps you need more time to consider your options...\n";
+        GameIO::Out() << "\nYou step back from the altar, the weight of your decision heavy on your shoulders.\n";
+        GameIO::Out() << "Perhaps you need more time to consider your options...\n";
         return false;
     }
 }
 
 // Combat and Interaction Methods
 bool Player::attackCreature(const std::string& creatureName) {
-    if (location == nullptr) return false;
+    if (getLocation() == nullptr) return false;
 
-    Entity* target = location->findEntity(creatureName);
-    if (!target || target->getType() != EntityType::NPC) {
-        std::cout << "You can't attack that!\n";
+    NPC* npc = static_cast<NPC*>(getLocation()->findEntity(creatureName, EntityBucket::NPCS));
+    if (npc == nullptr) {
+        GameIO::Out() << "You can't attack that!\n";
         return false;
     }
 
-    NPC* npc = dynamic_cast<NPC*>(target);
-    std::cout << "You attack " << npc->getName() << "!\n";
+    GameIO::Out() << "You attack " << npc->getName() << "!\n";
 
     if (rand() % 2 == 0) {
-        std::cout << "You defeat " << npc->getName() << "!\n";
+        GameIO::Out() << "You defeat " << npc->getName() << "!\n";
 
         if (npc->getName() == "Blacksmith") {
-            Item* rustyKey = new Item("rusty key", "An old rusted key that might open something.");
+            Item* rustyKey = getArena().create<Item>(ItemPrototype::Stock(StockItem::BLACKSMITH_KEY));
             addItem(rustyKey);
-            std::cout << "You found a rusty key on the Blacksmith!\n";
+            GameIO::Out() << "You found a rusty key on the Blacksmith!\n";
             makeSelfishChoice();
         }
         else if (npc->getName() == "Hermit") {
-            Item* fragment = new Item("sapphire", "Stolen fragment", true, 0, true);
+            Item* fragment = getArena().create<Item>(ItemPrototype::Stock(StockItem::HERMIT_FRAGMENT));
             addItem(fragment);
-            std::cout << "You found a sapphire fragment on the Hermit!\n";
+            GameIO::Out() << "You found a sapphire fragment on the Hermit!\n";
             makeSelfishChoice();
             betrayNPCs();
         }
 
-        location->removeEntity(npc);
-        delete npc;
+        getLocation()->removeEntity(npc);
+        getArena().destroy(npc);
         return true;
     }
     else {
-        std::cout << npc->getName() << " fights back!\n";
+        GameIO::Out() << npc->getName() << " fights back!\n";
         takeDamage(30);
         return false;
     }
 }
 
 bool Player::stealItem(const std::string& itemName) {
-    if (location == nullptr) return false;
+    if (getLocation() == nullptr) return false;
 
-    Entity* itemEntity = location->findEntity(itemName);
+    Entity* itemEntity = getLocation()->findEntity(itemName);
 
     if (!itemEntity) {
         if (itemName == "rusty key") {
-            Entity* blacksmith = location->findEntity("Blacksmith");
-            if (blacksmith && blacksmith->getType() == EntityType::NPC) {
+            if (getLocation()->findEntity("Blacksmith", EntityBucket::NPCS) != nullptr) {
                 if (rand() % 10 < 6) {
-                    std::cout << "You successfully steal the rusty key from the Blacksmith!\n";
-                    Item* rustyKey = new Item("rusty key", "An old rusted key that might open something.");
+                    GameIO::Out() << "You successfully steal the rusty key from the Blacksmith!\n";
+                    Item* rustyKey = getArena().create<Item>(ItemPrototype::Stock(StockItem::BLACKSMITH_KEY));
                     addItem(rustyKey);
                     makeSelfishChoice();
                     return true;
                 }
                 else {
-                    std::cout << "You got caught trying to steal from the Blacksmith!\n";
-                    std::cout << "The Blacksmith glares at you. \"I saw that! Keep your hands to yourself!\"\n";
+                    GameIO::Out() << "You got caught trying to steal from the Blacksmith!\n";
+                    GameIO::Out() << "The Blacksmith glares at you. \"I saw that! Keep your hands to yourself!\"\n";
                     return false;
                 }
             }
         }
         else if (itemName == "sapphire" || itemName == "sapphire fragment") {
-            Entity* hermit = location->findEntity("Hermit");
-            if (hermit && hermit->getType() == EntityType::NPC) {
+            if (getLocation()->findEntity("Hermit", EntityBucket::NPCS) != nullptr) {
                 if (rand() % 10 < 5) {
-                    std::cout << "You successfully steal the sapphire fragment from the Hermit!\n";
-                    Item* fragment = new Item("sapphire", "Stolen fragment", true, 0, true);
+                    GameIO::Out() << "You successfully steal the sapphire fragment from the Hermit!\n";
+                    Item* fragment = getArena().create<Item>(ItemPrototype::Stock(StockItem::HERMIT_FRAGMENT));
                     addItem(fragment);
                     makeSelfishChoice();
                     betrayNPCs();
                     return true;
                 }
                 else {
-                    std::cout << "The Hermit catches you trying to steal his precious fragment!\n";
-                    std::cout << "\"Thief! You are not worthy of this power!\"\n";
+                    GameIO::Out() << "The Hermit catches you trying to steal his precious fragment!\n";
+                    GameIO::Out() << "\"Thief! You are not worthy of this power!\"\n";
                     return false;
                 }
             }
@@ -711,25 +710,25 @@ bool Player::stealItem(const std::string& itemName) {
 
     if (itemEntity && itemEntity->getType() == EntityType::ITEM) {
         if (rand() % 10 < 6) {
-            std::cout << "You successfully steal the " << itemName << "!\n";
+            GameIO::Out() << "You successfully steal the " << itemName << "!\n";
             makeSelfishChoice();
             return takeItem(itemName);
         }
         else {
-            std::cout << "You got caught stealing!\n";
-            std::cout << "The villagers look at you disapprovingly.\n";
+            GameIO::Out() << "You got caught stealing!\n";
+            GameIO::Out() << "The villagers look at you disapprovingly.\n";
             return false;
         }
     }
 
-    std::cout << "You don't see a " << itemName << " that you can steal here.\n";
+    GameIO::Out() << "You don't see a " << itemName << " that you can steal here.\n";
     return false;
 }
 
 void Player::sacrificeNPC(const std::string& npcName) {
     bool atDarkShrine = false;
-    if (location->getName() == "Abandoned Mine") {
-        for (auto entity : location->getContains()) {
+    if (getLocation()->getName() == "Abandoned Mine") {
+        for (auto entity : getLocation()->getContains(EntityBucket::ITEMS)) {
             if (entity->getName() == "dark shrine") {
                 atDarkShrine = true;
                 break;
@@ -738,101 +737,101 @@ void Player::sacrificeNPC(const std::string& npcName) {
     }
 
     if (!atDarkShrine) {
-        std::cout << "The dark ritual can only be performed at the shrine in the mine.\n";
+        GameIO::Out() << "The dark ritual can only be performed at the shrine in the mine.\n";
         return;
     }
 
-    Entity* entity = location->findEntity(npcName);
-    if (!entity || entity->getType() != EntityType::NPC) {
-        std::cout << "There is no " << npcName << " here to sacrifice.\n";
+    Entity* entity = getLocation()->findEntity(npcName, EntityBucket::NPCS);
+    if (entity == nullptr) {
+        GameIO::Out() << "There is no " << npcName << " here to sacrifice.\n";
         return;
     }
 
-    std::cout << "You perform a dark ritual, sacrificing " << npcName << " at the shrine!\n";
-    std::cout << "Malevolent energy courses through you as " << npcName << "'s life force is consumed.\n";
+    GameIO::Out() << "You perform a dark ritual, sacrificing " << npcName << " at the shrine!\n";
+    GameIO::Out() << "Malevolent energy courses through you as " << npcName << "'s life force is consumed.\n";
 
     moralAlignment -= 10;
     hasSacrificed = true;
 
-    maxHealth += 20;
-    health = maxHealth;
-    std::cout << "Your maximum health increases to " << maxHealth << "!\n";
+    setMaxHealth(getMaxHealth() + 20);
+    setHealth(getMaxHealth());
+    GameIO::Out() << "Your maximum health increases to " << getMaxHealth() << "!\n";
 
-    location->removeEntity(entity);
-    delete entity;
+    getLocation()->removeEntity(entity);
+    getArena().destroy(entity);
 
     if (moralAlignment < -20) {
-        std::cout << "\nThe darkness has fully claimed your soul. There may be no redemption for you now.\n";
+        GameIO::Out() << "\nThe darkness has fully claimed your soul. There may be no redemption for you now.\n";
     }
 }
 
 void Player::forgiveEnemy(const std::string& enemyName) {
-    Entity* entity = location->findEntity(enemyName);
-    if (!entity || entity->getType() != EntityType::NPC) {
-        std::cout << "There is no " << enemyName << " here to forgive.\n";
+    NPC* npc = static_cast<NPC*>(getLocation()->findEntity(enemyName, EntityBucket::NPCS));
+    if (npc == nullptr) {
+        GameIO::Out() << "There is no " << enemyName << " here to forgive.\n";
         return;
     }
 
-    NPC* npc = dynamic_cast<NPC*>(entity);
     if (!npc->isEnemy) {
-        std::cout << enemyName << " has not wronged you. There is nothing to forgive.\n";
+        GameIO::Out() << enemyName << " has not wronged you. There is nothing to forgive.\n";
         return;
     }
 
-    std::cout << "You choose to forgive " << enemyName << " despite their actions.\n";
-    std::cout << "\"Your mercy is unexpected,\" " << enemyName << " says with genuine surprise.\n";
+    GameIO::Out() << "You choose to forgive " << enemyName << " despite their actions.\n";
+    GameIO::Out() << "\"Your mercy is unexpected,\" " << enemyName << " says with genuine surprise.\n";
 
     moralAlignment += 5;
     npc->setAsEnemy(false);
 
     if (moralAlignment > 15) {
-        std::cout << "\nYour compassion shines like a beacon in the darkness. The villagers whisper that you might be the one to break the curse.\n";
+        GameIO::Out() << "\nYour compassion shines like a beacon in the darkness. The villagers whisper that you might be the one to break the curse.\n";
     }
 }
 
 bool Player::makeMoralChoice(int choiceType) {
     switch (choiceType) {
     case 1: // Help a villager
-        std::cout << "\nYou stop to help a struggling villager with their task.\n";
-        std::cout << "They are grateful and spread word of your kindness.\n";
+        GameIO::Out() << "\nYou stop to help a struggling villager with their task.\n";
+        GameIO::Out() << "They are grateful and spread word of your kindness.\n";
         makeAltruisticChoice();
         return true;
 
     case 2: // Ignore someone in need
-        std::cout << "\nYou ignore the pleas for help, focusing only on your quest.\n";
-        std::cout << "The villagers whisper disapprovingly as you pass.\n";
+        GameIO::Out() << "\nYou ignore the pleas for help, focusing only on your quest.\n";
+        GameIO::Out() << "The villagers whisper disapprovingly as you pass.\n";
         makeSelfishChoice();
         return true;
 
     case 3: // Share your supplies
         if (inventory.size() > 1) {
-            std::cout << "\nYou share some of your supplies with the hungry refugees.\n";
-            std::cout << "Their grateful smiles warm your heart.\n";
+            GameIO::Out() << "\nYou share some of your supplies with the hungry refugees.\n";
+            GameIO::Out() << "Their grateful smiles warm your heart.\n";
             makeAltruisticChoice();
             makeAltruisticChoice();
             for (auto it = inventory.begin(); it != inventory.end(); ++it) {
                 if ((*it)->getName() != "Amulet of Eldoria") {
-                    std::cout << "You give away your " << (*it)->getName() << ".\n";
-                    delete* it;
-                    inventory.erase(it);
+                    GameIO::Out() << "You give away your " << (*it)->getName() << ".\n";
+                    Entity* item = *it;
+                    inventory.remove(item);
+                    getArena().destroy(item);
                     break;
                 }
             }
             return true;
         }
         else {
-            std::cout << "\nYou would share, but you have nothing to give.\n";
+            GameIO::Out() << "\nYou would share, but you have nothing to give.\n";
             return false;
         }
 
     case 4: {
-        std::cout << "\nYou demand 'donations' from the frightened villagers.\n";
-        std::cout << "They reluctantly comply, fearing your wrath.\n";
+        GameIO::Out() << "\nYou demand 'donations' from the frightened villagers.\n";
+        GameIO::Out() << "They reluctantly comply, fearing your wrath.\n";
         makeSelfishChoice();
         makeSelfishChoice();
-        Item* stolenItem = new Item("bread", "Stolen food from the villagers.");
+        Item* stolenItem = getArena().create<Item>(ItemPrototype::Stock(StockItem::VILLAGE_BREAD));
         addItem(stolenItem);
-        std::cout << "You acquired some bread.\n";
+        GameIO::Out() << "You acquired some bread.\n";
         return true;
     }
 
@@ -843,80 +842,75 @@ bool Player::makeMoralChoice(int choiceType) {
 
 bool Player::corruptArtifact(const std::string& artifactName) {
     if (!hasItem(artifactName)) {
-        std::cout << "You don't have " << artifactName << " to corrupt.\n";
+        GameIO::Out() << "You don't have " << artifactName << " to corrupt.\n";
         return false;
     }
 
-    std::cout << "\nYou channel dark energy into the " << artifactName << "...\n";
-    std::cout << "It twists and transforms in your hands, becoming something sinister.\n";
+    GameIO::Out() << "\nYou channel dark energy into the " << artifactName << "...\n";
+    GameIO::Out() << "It twists and transforms in your hands, becoming something sinister.\n";
 
     removeItem(artifactName);
 
     std::string corruptedName = "Corrupted " + artifactName;
-    Item* corruptedItem = new Item(corruptedName,
-        "A once-pure artifact, now pulsing with dark energy.");
+    Item* corruptedItem = getArena().create<Item>(ItemPrototype::Intern(corruptedName,
+        "A once-pure artifact, now pulsing with dark energy."));
     addItem(corruptedItem);
 
-    std::cout << "The " << corruptedName << " now grants you additional power!\n";
+    GameIO::Out() << "The " << corruptedName << " now grants you additional power!\n";
 
     makeSelfishChoice();
     makeSelfishChoice();
 
     setHealth(getHealth() + 20);
-    std::cout << "Your maximum health has increased. Health is now "
+    GameIO::Out() << "Your maximum health has increased. Health is now "
         << getHealth() << "/" << getMaxHealth() << ".\n";
 
     return true;
 }
 
 void Player::showAlignment() const {
-    std::cout << "\nYour moral compass points ";
+    GameIO::Out() << "\nYour moral compass points ";
 
     if (moralAlignment > 5) {
-        std::cout << "strongly toward selflessness and heroism.\n";
-        std::cout << "The villagers look to you with hope and admiration.\n";
+        GameIO::Out() << "strongly toward selflessness and heroism.\n";
+        GameIO::Out() << "The villagers look to you with hope and admiration.\n";
     }
     else if (moralAlignment > 2) {
-        std::cout << "toward good and kindness.\n";
-        std::cout << "People generally trust and respect you.\n";
+        GameIO::Out() << "toward good and kindness.\n";
+        GameIO::Out() << "People generally trust and respect you.\n";
     }
     else if (moralAlignment > -2) {
-        std::cout << "neither strongly toward good nor evil.\n";
-        std::cout << "People are uncertain of your true intentions.\n";
+        GameIO::Out() << "neither strongly toward good nor evil.\n";
+        GameIO::Out() << "People are uncertain of your true intentions.\n";
     }
     else if (moralAlignment > -5) {
-        std::cout << "toward selfishness and opportunism.\n";
-        std::cout << "People regard you with suspicion and fear.\n";
+        GameIO::Out() << "toward selfishness and opportunism.\n";
+        GameIO::Out() << "People regard you with suspicion and fear.\n";
     }
     else {
-        std::cout << "deeply into darkness and cruelty.\n";
-        std::cout << "Villagers flee at the sight of you, whispering warnings of your approach.\n";
+        GameIO::Out() << "deeply into darkness and cruelty.\n";
+        GameIO::Out() << "Villagers flee at the sight of you, whispering warnings of your approach.\n";
     }
 
     if (hasBetrayedNPCs) {
-        std::cout << "You have a reputation for betrayal that precedes you.\n";
+        GameIO::Out() << "You have a reputation for betrayal that precedes you.\n";
     }
 }
 
 // Utility Methods
 bool Player::hasActiveLantern() const {
-    for (auto item : inventory) {
-        if (item->getName() == "lantern" && dynamic_cast<Item*>(item)->getIsLit()) {
-            return lanternTurnsRemaining > 0;
-        }
-    }
-    return false;
+    return inventory.hasLitLantern() && lanternTurnsRemaining > 0;
 }
 
 void Player::takeDamage(int amount) {
     Creature::takeDamage(amount);
-    std::cout << "\n*** You took " << amount << " damage! Health: "
+    GameIO::Out() << "\n*** You took " << amount << " damage! Health: "
         << getHealth() << "/" << getMaxHealth() << " ***\n";
 
     if (getHealth() <= 25 && getHealth() > 10) {
-        std::cout << "You're badly wounded! Find healing quickly!\n";
+        GameIO::Out() << "You're badly wounded! Find healing quickly!\n";
     }
     else if (getHealth() <= 10) {
-        std::cout << "You're critically injured! One more hit could be fatal!\n";
+        GameIO::Out() << "You're critically injured! One more hit could be fatal!\n";
     }
 }
\ No newline at end of file
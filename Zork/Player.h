@@ -2,12 +2,15 @@
 #include "Creature.h"
 #include "Entity.h"
 #include "GameEnums.h"
+#include "Inventory.h"
 #include "Room.h"
 #include <vector>
 
+class NPC;
+
 class Player : public Creature {
 private:
-    vector<Entity*> inventory;
+    Inventory inventory;
     bool hasBackpack() const;
 
     int lanternTurnsRemaining;
@@ -16,24 +19,63 @@ private:
     bool hasBetrayedNPCs = false;
     bool hasSacrificed = false;
     int movesTaken;
+    Ending ending = Ending::NONE;
+
+    // Question waiting on the next input line, and the NPC that asked it
+    // (none for the player's own confirmations) with its dialogue node
+    Prompt prompt = Prompt::NONE;
+    EntityHandle promptFrom = EntityHandle::None();
+    uint32_t promptNode = 0;
+
+    void answerDropLantern(std::string response);
+    bool answerAmuletEnding(const std::string& choice);
 
 public:
-    Player(const string& name, const string& description, Room* room);
+    static constexpr EntityType TYPE = EntityType::PLAYER;
+
+    // Everything about the player but the location and inventory, for saving a session as a delta
+    struct State {
+        int health;
+        int maxHealth;
+        int lanternTurnsRemaining;
+        int moralAlignment;
+        bool hasBetrayedNPCs;
+        bool hasSacrificed;
+        int movesTaken;
+        Ending ending;
+        Prompt prompt;
+        uint32_t promptNpc;     // Record of the NPC that asked, Entity::NO_RECORD if none
+        uint32_t promptNode;    // Dialogue node that asked, for Prompt::DIALOGUE
+    };
+
+    Player(EntityArena& arena, const string& name, const string& description, Room* room);
+
+    State getState() const;
+    // Restores everything but who asked the pending question, see ask()
+    void setState(const State& state);
+
+    // Pending questions; answer() hands the next input line to whoever
+    // asked and returns true when that ends the game
+    void ask(Prompt question, NPC* asker = nullptr, uint32_t node = 0);
+    Prompt getPrompt() const { return prompt; }
+    // Answers the pending question accepts, separated by spaces
+    std::string getPromptAnswers() const;
+    bool answer(const std::string& response);
 
     // Movement commands
-    bool moveTo(Direction direction);
+    bool moveTo(Direction direction, bool describeArrival = true);
     bool moveTo(Room* room);
 
     // Inventory management
     bool takeItem(const string& itemName);
     bool dropItem(const string& itemName);
-    bool hasItem(const string& itemName) const;
+    bool hasItem(std::string_view itemName) const;
     void showInventory() const;
-    const vector<Entity*>& getInventory() const { return inventory; }
+    const ArenaVector<Entity*>& getInventory() const { return inventory.getItems(); }
 
     // NPC interaction
     void addItem(Entity* item);
-    bool removeItem(const std::string& itemName);
+    bool removeItem(std::string_view itemName);
 
     // Item interaction
     bool useItem(const string& itemName);
@@ -53,7 +95,7 @@ public:
     bool hasActiveLantern() const;
 
     // Combat system
-    void takeDamage(int amount) override;
+    void takeDamage(int amount);
     bool attackCreature(const string& creatureName);
 
     // Stealing and other negative actions
@@ -75,4 +117,8 @@ public:
 
     void incrementMoves() { movesTaken++; }
     int getMovesTaken() const { return movesTaken; }
+
+    // Game outcome
+    void setEnding(Ending newEnding) { ending = newEnding; }
+    Ending getEnding() const { return ending; }
 };
\ No newline at end of file
@@ -2,47 +2,33 @@
 #include "GameEnums.h"
 #include "Exit.h"
 #include "Entity.h"
-#include <iostream>
+#include "GameIO.h"
 
-void Room::setExit(Direction direction, Entity* exit) {
-    exits[direction] = exit;
-}
-
-Entity* Room::getExit(Direction direction) const {
-    auto it = exits.find(direction);
-    return it != exits.end() ? it->second : nullptr;
+void Room::setExit(Direction direction, Exit* exit) {
+    exits[static_cast<int>(direction)] = exit;
 }
 
 void Room::look() const {
-    std::cout << "\n";
+    GameIO::Out() << "\n";
     // First print room name and description
-    std::cout << name << std::endl;
-    std::cout << description << std::endl;
+    GameIO::Out() << name << std::endl;
+    GameIO::Out() << description << std::endl;
 
-    // Print contained items (excluding player)
+    // Print contained items and NPCs; players are in a bucket of their own
     bool hasItems = false;
-    for (auto entity : contains) {
-        if (entity->getType() != EntityType::PLAYER) {
-            if (!hasItems) {
-                std::cout << "Contains:" << std::endl;
-                hasItems = true;
-            }
-            std::cout << "- " << entity->getName() << std::endl;
+    for (auto entity : getContains(EntityBucket::ALL & ~EntityBucket::PLAYERS)) {
+        if (!hasItems) {
+            GameIO::Out() << "Contains:" << std::endl;
+            hasItems = true;
         }
+        GameIO::Out() << "- " << entity->getName() << std::endl;
     }
 
     // Print exits
-    std::cout << "Exits:" << std::endl;
+    GameIO::Out() << "Exits:" << std::endl;
     for (auto exit : exits) {
-        string direction;
-        switch (exit.first) {
-        case Direction::NORTH: direction = "north"; break;
-        case Direction::SOUTH: direction = "south"; break;
-        case Direction::EAST: direction = "east"; break;
-        case Direction::WEST: direction = "west"; break;
-        case Direction::UP: direction = "up"; break;
-        case Direction::DOWN: direction = "down"; break;
+        if (exit != nullptr) {
+            GameIO::Out() << "- " << directionToString(exit->getDirection()) << std::endl;
         }
-        std::cout << "- " << direction << std::endl;
     }
 }
\ No newline at end of file
@@ -1,27 +1,39 @@
 #pragma once
 #include "Entity.h"
 #include "GameEnums.h" 
-#include <map>
+#include <array>
 #include <string>
 #include <vector>
 
-using std::map;
+class Exit;
 
 class Room : public Entity {
+public:
+    static constexpr EntityType TYPE = EntityType::ROOM;
+    using ExitTable = std::array<Exit*, DIRECTION_COUNT>;
+
 private:
-    map<Direction, Entity*> exits;
+    ExitTable exits;        // Outgoing exits indexed by Direction
     bool isDark;
+    int graphIndex;         // Position in the world's room graph
 
 public:
-    Room(const string& name, const string& description, bool isDark = false)
-        : Entity(EntityType::ROOM, name, description), isDark(isDark) {
+    Room(EntityArena& arena, const string& name, const string& description, bool isDark = false)
+        : Entity(arena, EntityType::ROOM, name, description), exits{}, isDark(isDark), graphIndex(-1) {
     }
+    Room(EntityArena& arena, BorrowedText name, BorrowedText description, bool isDark = false)
+        : Entity(arena, EntityType::ROOM, name, description), exits{}, isDark(isDark), graphIndex(-1) {
+    }
+
+    void setExit(Direction direction, Exit* exit);
+    Exit* getExit(Direction direction) const { return exits[static_cast<int>(direction)]; }
+    void look() const;
 
-    void setExit(Direction direction, Entity* exit);
-    Entity* getExit(Direction direction) const;
-    void look() const override;
+    // Empty slots are nullptr, slots follow Direction order
+    const ExitTable& getExits() const { return exits; }
 
-    const map<Direction, Entity*>& getExits() const { return exits; }
+    void setGraphIndex(int index) { graphIndex = index; }
+    int getGraphIndex() const { return graphIndex; }
 
     void setDark(bool dark) { isDark = dark; }
     bool getIsDark() const { return isDark; }
@@ -0,0 +1,140 @@
+#include "RoutePlanner.h"
+#include <algorithm>
+
+RoutePlanner::RoutePlanner(GraphChanges& changes) :
+    changes(changes),
+    useCounter(0) {
+    changes.addListener(this);
+}
+
+RoutePlanner::~RoutePlanner() {
+    changes.removeListener(this);
+}
+
+// ========== Queries ==========
+
+int RoutePlanner::nextEdge(int from, int to, uint64_t keys, bool lit) {
+    if (from == to || from < 0 || to < 0) {
+        return NO_ROUTE;
+    }
+    return TableFor(to, keys, lit).next[from];
+}
+
+int RoutePlanner::distance(int from, int to, uint64_t keys, bool lit) {
+    if (from < 0 || to < 0) {
+        return NO_ROUTE;
+    }
+    return TableFor(to, keys, lit).steps[from];
+}
+
+RoutePlanner::Table& RoutePlanner::TableFor(int target, uint64_t keys, bool lit) {
+    useCounter++;
+
+    Table* oldest = nullptr;
+    for (Table& table : tables) {
+        if (table.target == target && table.keys == keys && table.lit == lit) {
+            table.lastUsed = useCounter;
+            return table;
+        }
+        if (oldest == nullptr || table.lastUsed < oldest->lastUsed) {
+            oldest = &table;
+        }
+    }
+
+    // Reuse the least recently used table's arrays once the cache is full
+    Table* table = oldest;
+    if (tables.size() < MAX_TABLES) {
+        tables.emplace_back();
+        table = &tables.back();
+    }
+
+    table->target = target;
+    table->keys = keys;
+    table->lit = lit;
+    table->lastUsed = useCounter;
+    Fill(*table);
+    return *table;
+}
+
+// ========== Searches ==========
+
+void RoutePlanner::Fill(Table& table) {
+    size_t roomCount = static_cast<size_t>(changes.getGraph().getRoomCount());
+    table.next.assign(roomCount, NO_ROUTE);
+    table.steps.assign(roomCount, NO_ROUTE);
+
+    table.steps[table.target] = 0;
+    Relax(table, table.target);
+}
+
+void RoutePlanner::Relax(Table& table, int start) {
+    // Backwards breadth-first search: a room's route is one edge into a room
+    // whose route is already known
+    const WorldGraph& graph = changes.getGraph();
+    queue.clear();
+    queue.push_back(start);
+
+    for (size_t head = 0; head < queue.size(); head++) {
+        int room = queue[head];
+        if (!Passes(table, room)) {
+            continue;
+        }
+        int steps = table.steps[room] + 1;
+
+        for (int edgeIndex : graph.edgesInto(room)) {
+            const WorldGraph::Edge& edge = graph.getEdge(edgeIndex);
+            if (!changes.isPassable(edgeIndex, table.keys)) {
+                continue;
+            }
+
+            int& known = table.steps[edge.source];
+            if (known == NO_ROUTE || steps < known) {
+                known = steps;
+                table.next[edge.source] = edgeIndex;
+                queue.push_back(edge.source);
+            }
+        }
+    }
+}
+
+// ========== Graph Changes ==========
+
+void RoutePlanner::onEdgeUnlocked(int edgeIndex) {
+    const WorldGraph::Edge& edge = changes.getGraph().getEdge(edgeIndex);
+
+    for (Table& table : tables) {
+        // Tables for holders of the key already used this edge
+        if ((edge.keyBit & table.keys) != 0) {
+            continue;
+        }
+
+        if (!Passes(table, edge.destination)) {
+            continue;
+        }
+
+        int after = table.steps[edge.destination];
+        int& before = table.steps[edge.source];
+        if (after == NO_ROUTE || (before != NO_ROUTE && before <= after + 1)) {
+            continue;
+        }
+
+        // The source room gets shorter; spread that to the rooms behind it
+        before = after + 1;
+        table.next[edge.source] = edgeIndex;
+        Relax(table, edge.source);
+    }
+}
+
+void RoutePlanner::onGraphRebuilt() {
+    tables.clear();
+}
+
+void RoutePlanner::onDarknessChanged(int) {
+    // Walkers with a light never minded the dark
+    tables.erase(std::remove_if(tables.begin(), tables.end(),
+        [](const Table& table) { return !table.lit; }), tables.end());
+}
+
+bool RoutePlanner::Passes(const Table& table, int room) const {
+    return table.lit || room == table.target || !changes.isDark(room);
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "WorldGraph.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Shortest walking routes over a WorldGraph as one session has changed it.
+ * A route table is built per destination room and set of carried keys with
+ * one backwards breadth-first search; it holds, for every room, the edge to
+ * take next and the number of steps left. Tables are cached (least recently
+ * used first out), so repeated trips to the same places cost one array read
+ * per step. Storing every pair of rooms would not fit generated worlds with
+ * 100k+ rooms, per-destination tables do.
+ *
+ * Without light a dark room can end a route but not lie on it, since
+ * nobody finds the way on through the dark; darkness is read when a table
+ * is filled, and a change of darkness drops the tables it affects.
+ *
+ * When an exit is unlocked only the rooms that now have a shorter way are
+ * updated, by a search starting from the unlocked exit.
+ */
+class RoutePlanner : public GraphChanges::Listener {
+public:
+    static constexpr int NO_ROUTE = -1;
+    static constexpr size_t MAX_TABLES = 16;
+
+    explicit RoutePlanner(GraphChanges& changes);
+    ~RoutePlanner() override;
+
+    RoutePlanner(const RoutePlanner&) = delete;
+    RoutePlanner& operator=(const RoutePlanner&) = delete;
+
+    // Edge to take from 'from' on a shortest way to 'to' for a walker with
+    // 'keys' and, if 'lit', a light; NO_ROUTE if there is none or the rooms
+    // are the same
+    int nextEdge(int from, int to, uint64_t keys, bool lit);
+
+    // Steps from 'from' to 'to', NO_ROUTE if unreachable
+    int distance(int from, int to, uint64_t keys, bool lit);
+
+    void onEdgeUnlocked(int edge) override;
+    void onDarknessChanged(int room) override;
+    void onGraphRebuilt() override;
+
+private:
+    struct Table {
+        int target;
+        uint64_t keys;
+        bool lit;
+        unsigned long long lastUsed;
+        std::vector<int> next;      // Edge to take from each room
+        std::vector<int> steps;     // Steps left from each room, NO_ROUTE if unreachable
+    };
+
+    GraphChanges& changes;
+    std::vector<Table> tables;
+    unsigned long long useCounter;
+    std::vector<int> queue;         // Reused by every search
+
+    Table& TableFor(int target, uint64_t keys, bool lit);
+    void Fill(Table& table);
+    void Relax(Table& table, int start);
+
+    // Whether routes of 'table' may go on through a room
+    bool Passes(const Table& table, int room) const;
+};
@@ -11,7 +11,7 @@ public:
         std::cout << "\n\n";
 
         // Create the status bar string
-        std::string status = "| " + player.getLocation()->getName() + " | " +
+        std::string status = "| " + std::string(player.getLocation()->getName()) + " | " +
             "Health: " + std::to_string(player.getHealth()) + "/" +
             std::to_string(player.getMaxHealth()) + " | " +
             "Alignment: " + GetAlignmentString(player.getAlignment()) + " | " +
@@ -27,7 +27,6 @@ public:
         std::cout << "+" << std::string(terminalWidth - 2, '-') << "+\n\n";
     }
 
-private:
     static std::string GetAlignmentString(int alignment) {
         if (alignment < -5) return "Evil";
         if (alignment < -2) return "Selfish";
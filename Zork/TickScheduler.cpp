@@ -0,0 +1,61 @@
+#include "TickScheduler.h"
+
+void TickScheduler::reset(uint32_t turn) {
+    for (std::vector<Entry>& slot : slots) {
+        slot.clear();
+    }
+    overflow.clear();
+    current = turn;
+    size = 0;
+}
+
+void TickScheduler::release() {
+    reset(0);
+    std::vector<std::vector<Entry>>().swap(slots);
+    std::vector<Entry>().swap(overflow);
+    std::vector<Entry>().swap(firing);
+}
+
+void TickScheduler::schedule(EntityHandle entity, uint32_t turn) {
+    if (slots.empty()) {
+        slots.resize(WHEELS * SLOTS);
+    }
+    place(Entry{ entity, turn });
+    size++;
+}
+
+void TickScheduler::place(const Entry& entry) {
+    // The highest group of bits in which the turn differs from the current one picks the wheel
+    uint32_t differing = entry.turn ^ current;
+    for (unsigned wheel = 0; wheel < WHEELS; wheel++) {
+        if ((differing >> (SLOT_BITS * (wheel + 1))) == 0) {
+            slots[wheel * SLOTS + ((entry.turn >> (SLOT_BITS * wheel)) & SLOT_MASK)].push_back(entry);
+            return;
+        }
+    }
+    overflow.push_back(entry);
+}
+
+void TickScheduler::step() {
+    current++;
+
+    // Coarsest first, entries brought down may belong to a finer slot that is due now too
+    if ((current >> (SLOT_BITS * WHEELS)) << (SLOT_BITS * WHEELS) == current) {
+        firing.swap(overflow);
+        for (const Entry& entry : firing) {
+            place(entry);
+        }
+        firing.clear();
+    }
+    for (unsigned wheel = WHEELS - 1; wheel > 0; wheel--) {
+        unsigned shift = SLOT_BITS * wheel;
+        if ((current >> shift) << shift != current) {
+            continue;
+        }
+        firing.swap(slots[wheel * SLOTS + ((current >> shift) & SLOT_MASK)]);
+        for (const Entry& entry : firing) {
+            place(entry);
+        }
+        firing.clear();
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include "EntityHandle.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Turns at which entities want their next update(), as a hierarchical
+ * timer wheel. Four wheels of 64 slots cover 64, 4096, 262144 and 16777216
+ * turns ahead; later entries wait in an overflow list. An entry sits in the
+ * wheel of the highest 6-bit group in which its turn differs from the
+ * current one and drops to a finer wheel when the clock reaches that group,
+ * so scheduling is constant time and advancing a turn costs the entries due
+ * plus the few moved down, however many entities are scheduled further out.
+ *
+ * Entries are not cancelled: whoever schedules keeps the turn it expects
+ * and ignores entries that no longer match it, and entries of destroyed
+ * entities stop resolving by themselves. The wheels are allocated by the
+ * first schedule(), so a world where nothing is scheduled pays nothing.
+ */
+class TickScheduler {
+public:
+    // Forgets every entry and sets the current turn
+    void reset(uint32_t turn);
+
+    // reset() and frees the wheels as well
+    void release();
+
+    // 'turn' must lie after the current turn, and advance() must not go back
+    void schedule(EntityHandle entity, uint32_t turn);
+
+    // Advances one turn at a time up to 'turn', calling due(entity, turn)
+    // for every entry due on the way; due() may schedule further entries.
+    // Entries due on the same turn come in slot order rather than the order
+    // scheduled, so a scheduler rebuilt from saved turns behaves the same
+    template <typename Due>
+    void advance(uint32_t turn, Due due) {
+        while (current != turn) {
+            if (size == 0) {
+                current = turn;     // Nothing can be due on the way
+                return;
+            }
+            step();
+            firing.swap(slots[current & SLOT_MASK]);
+            std::sort(firing.begin(), firing.end(), [](const Entry& a, const Entry& b) {
+                return a.entity.getIndex() < b.entity.getIndex();
+            });
+            for (const Entry& entry : firing) {
+                due(entry.entity, entry.turn);
+            }
+            size -= firing.size();
+            firing.clear();
+        }
+    }
+
+    uint32_t getTurn() const { return current; }
+    size_t getSize() const { return size; }
+
+private:
+    static constexpr unsigned SLOT_BITS = 6;
+    static constexpr unsigned SLOTS = 1u << SLOT_BITS;
+    static constexpr uint32_t SLOT_MASK = SLOTS - 1;
+    static constexpr unsigned WHEELS = 4;
+
+    struct Entry {
+        EntityHandle entity;
+        uint32_t turn;
+    };
+
+    std::vector<std::vector<Entry>> slots;  // WHEELS * SLOTS, finest wheel first
+    std::vector<Entry> overflow;    // Beyond the last wheel
+    std::vector<Entry> firing;      // Scratch list reused by advance()
+    uint32_t current = 0;
+    size_t size = 0;
+
+    void place(const Entry& entry);
+
+    // Moves the clock one turn on, bringing entries down to the finer
+    // wheels as it crosses their group
+    void step();
+};
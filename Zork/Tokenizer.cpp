@@ -0,0 +1,160 @@
+#include "Tokenizer.h"
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define TOKENIZER_AVX2 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TOKENIZER_SSE2 1
+#endif
+
+namespace {
+
+    // Same characters as isspace() in the "C" locale
+    inline bool IsSpace(char c) {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    inline char ToLower(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    inline unsigned CountTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    /**
+     * Copies the run of ordinary characters (no whitespace, no quote) at the
+     * start of 'in' to 'out' in lowercase and returns its length.
+     * Whole blocks are stored even when the run ends inside one; the caller
+     * guarantees 'out' has as much room as 'in' has characters left.
+     */
+    size_t CopyWord(const char* in, size_t size, char* out) {
+        size_t count = 0;
+
+#if TOKENIZER_AVX2
+        {
+            // Signed-compare range checks: x + (128 - low) < -128 + width
+            const __m256i spaceBias = _mm256_set1_epi8(static_cast<char>(128 - '\t'));
+            const __m256i spaceLimit = _mm256_set1_epi8(static_cast<char>(-128 + ('\r' - '\t' + 1)));
+            const __m256i upperBias = _mm256_set1_epi8(static_cast<char>(128 - 'A'));
+            const __m256i upperLimit = _mm256_set1_epi8(static_cast<char>(-128 + 26));
+            const __m256i space = _mm256_set1_epi8(' ');
+            const __m256i quote = _mm256_set1_epi8('"');
+            const __m256i caseBit = _mm256_set1_epi8(0x20);
+
+            while (size - count >= 32) {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + count));
+                __m256i upper = _mm256_cmpgt_epi8(upperLimit, _mm256_add_epi8(block, upperBias));
+                __m256i lower = _mm256_or_si256(block, _mm256_and_si256(upper, caseBit));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + count), lower);
+
+                __m256i stop = _mm256_or_si256(
+                    _mm256_cmpgt_epi8(spaceLimit, _mm256_add_epi8(block, spaceBias)),
+                    _mm256_or_si256(_mm256_cmpeq_epi8(block, space), _mm256_cmpeq_epi8(block, quote)));
+                uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(stop));
+                if (mask != 0) {
+                    return count + CountTrailingZeros(mask);
+                }
+                count += 32;
+            }
+        }
+#endif
+
+#if TOKENIZER_SSE2
+        {
+            const __m128i spaceBias = _mm_set1_epi8(static_cast<char>(128 - '\t'));
+            const __m128i spaceLimit = _mm_set1_epi8(static_cast<char>(-128 + ('\r' - '\t' + 1)));
+            const __m128i upperBias = _mm_set1_epi8(static_cast<char>(128 - 'A'));
+            const __m128i upperLimit = _mm_set1_epi8(static_cast<char>(-128 + 26));
+            const __m128i space = _mm_set1_epi8(' ');
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i caseBit = _mm_set1_epi8(0x20);
+
+            while (size - count >= 16) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + count));
+                __m128i upper = _mm_cmplt_epi8(_mm_add_epi8(block, upperBias), upperLimit);
+                __m128i lower = _mm_or_si128(block, _mm_and_si128(upper, caseBit));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + count), lower);
+
+                __m128i stop = _mm_or_si128(
+                    _mm_cmplt_epi8(_mm_add_epi8(block, spaceBias), spaceLimit),
+                    _mm_or_si128(_mm_cmpeq_epi8(block, space), _mm_cmpeq_epi8(block, quote)));
+                uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(stop));
+                if (mask != 0) {
+                    return count + CountTrailingZeros(mask);
+                }
+                count += 16;
+            }
+        }
+#endif
+
+        // Scalar tail (and the whole line without SIMD support)
+        while (count < size) {
+            char c = in[count];
+            if (c == '"' || IsSpace(c)) {
+                break;
+            }
+            out[count] = ToLower(c);
+            count++;
+        }
+        return count;
+    }
+}
+
+const std::vector<std::string_view>& Tokenizer::tokenize(std::string_view line) {
+    tokens.clear();
+
+    // The output never outgrows the input, quotes are only ever removed
+    if (text.size() < line.size()) {
+        text.resize(line.size());
+    }
+
+    char* out = &text[0];
+    size_t written = 0;
+    size_t tokenStart = 0;
+    bool inQuotes = false;
+
+    size_t i = 0;
+    while (i < line.size()) {
+        size_t run = CopyWord(line.data() + i, line.size() - i, out + written);
+        written += run;
+        i += run;
+        if (i == line.size()) {
+            break;
+        }
+
+        char c = line[i++];
+        if (c == '"') {
+            inQuotes = !inQuotes;
+        }
+        else if (inQuotes) {
+            out[written++] = c; // Whitespace inside a quoted phrase
+        }
+        else {
+            if (written > tokenStart) {
+                tokens.emplace_back(out + tokenStart, written - tokenStart);
+            }
+            tokenStart = written;
+        }
+    }
+
+    if (written > tokenStart) {
+        tokens.emplace_back(out + tokenStart, written - tokenStart);
+    }
+
+    return tokens;
+}
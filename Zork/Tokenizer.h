@@ -0,0 +1,24 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Command line tokenizer.
+ * Lowercases and splits a line in a single pass. Whitespace separates words
+ * and double quotes group a phrase ("old lantern") into one word; the quotes
+ * themselves are dropped. Tokens view the tokenizer's own text buffer, which
+ * is reused from line to line, so a line no longer than the longest one seen
+ * so far is tokenized without touching the heap.
+ */
+class Tokenizer {
+public:
+    // Tokens stay valid until the next call
+    const std::vector<std::string_view>& tokenize(std::string_view line);
+
+    const std::vector<std::string_view>& getTokens() const { return tokens; }
+
+private:
+    std::string text;                       // Lowercased line without quotes
+    std::vector<std::string_view> tokens;   // Views into text
+};
@@ -2,116 +2,175 @@
 #include "Room.h"
 #include "Exit.h"
 #include "Item.h"
+#include "ItemPrototype.h"
 #include "NPC.h"
+#include "DialogueGraph.h"
+#include "EntityCast.h"
+#include "NameTable.h"
+#include "Player.h"
+#include "WorldImage.h"
+#include "WorldImageWriter.h"
+#include "WorldTemplate.h"
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
-// Static room pointers
-static Room* village = nullptr;
-static Room* forest = nullptr;
-static Room* mine = nullptr;
-static Room* temple = nullptr;
-static Room* tower = nullptr;
+namespace {
+
+    // Placeholder slots of a world built from an image: rooms, then NPCs,
+    // then items, each in record order
+    uint32_t NpcSlot(const WorldImage& image, uint32_t record) {
+        return static_cast<uint32_t>(image.getRoomCount()) + record;
+    }
+
+    uint32_t ItemSlot(const WorldImage& image, uint32_t record) {
+        return static_cast<uint32_t>(image.getRoomCount() + image.getNpcCount()) + record;
+    }
+
+    uint32_t SlotCount(const WorldImage& image) {
+        return static_cast<uint32_t>(image.getRoomCount() + image.getNpcCount() + image.getItemCount());
+    }
+
+    // WorldFormat::ITEM_* flags describing an item
+    uint32_t ItemFlags(const Item* item) {
+        using namespace WorldFormat;
+        return (item->getIsContainer() ? ITEM_CONTAINER : 0)
+            | (item->getIsFragment() ? ITEM_FRAGMENT : 0)
+            | (item->getIsFixedInPlace() ? ITEM_FIXED : 0);
+    }
+}
+
+World::World() :
+    startRoom(nullptr), player(nullptr), routes(graphChanges), observed(nullptr) {
+}
+
+World::~World() {
+    Release();
+}
+
+void World::Clear() {
+    // The rooms and exits end with the arena, nothing is visited
+    graphChanges.attach(nullptr);
+    arena.clear();
+    rooms.clear();
+    startRoom = nullptr;
+    player = nullptr;
+    dialogue.reset();
+    source.reset();
+    scheduler.reset(0);
+    observed = nullptr;
+
+    base = WorldDelta();
+    baseContents.clear();
+    baseStates.clear();
+    baseNpcRooms.clear();
+    baseLit.clear();
+    builtCreated.clear();
+    builtRooms.clear();
+}
+
+void World::Release() {
+    Clear();
+    arena.release();
+    scheduler.release();
+}
 
 void World::InitializeWorld() {
     // Clean up any previous initialization
-    if (village != nullptr) {
-        delete village;
-        delete forest;
-        delete mine;
-        delete temple;
-        delete tower;
-    }
+    Clear();
 
     // ===== CREATE ROOMS =====
-    village = new Room("Village of Eldoria",
+    Room* village = arena.create<Room>("Village of Eldoria",
         "The peaceful starting village. Wooden cottages with smoking chimneys line the dirt paths. "
         "The villagers glance at you nervously, whispering about the curse. To the north, a path leads "
         "to the Enchanted Forest. A locked hatch in the town square descends into darkness.");
 
-    forest = new Room("Enchanted Forest",
+    Room* forest = arena.create<Room>("Enchanted Forest",
         "Ancient trees tower above you, their leaves glowing faintly with bioluminescent fungi. "
         "Strange whispers dance on the wind. A shadowy figure (the hermit?) watches from between "
         "the trees. The path back south leads to the village, while an overgrown trail winds east.");
 
-    mine = new Room("Abandoned Mine",
+    Room* mine = arena.create<Room>("Abandoned Mine",
         "Pitch-black darkness swallows everything. You hear skittering noises...", true);
 
-    temple = new Room("Ruined Temple",
+    Room* temple = arena.create<Room>("Ruined Temple",
         "Crumbling stone pillars surround a central altar carved with three gem-shaped depressions. "
         "Faded murals depict the amulet's destruction. A ghostly priestess drifts near the staircase, "
         "which is barred by an ethereal lock. The forest lies west.");
 
-    tower = new Room("Sorcerer's Tower",
+    Room* tower = arena.create<Room>("Sorcerer's Tower",
         "The air hums with dark energy. A cracked obsidian altar dominates the room, pulsing with "
         "malevolent light. The restored amulet could break the curse... if placed here. The staircase "
         "descends back to the temple.");
 
     // ===== CREATE EXITS =====
     // Village exits
-    new Exit(Direction::NORTH, village, forest, "forest path", "A well-trodden path leading into the forest");
-    new Exit(Direction::DOWN, village, mine, "mine entrance", "A wooden hatch leading down to the mines", true, "rusty key");
+    arena.create<Exit>(Direction::NORTH, village, forest, "forest path", "A well-trodden path leading into the forest");
+    arena.create<Exit>(Direction::DOWN, village, mine, "mine entrance", "A wooden hatch leading down to the mines", true, "rusty key");
 
     // Forest exits
-    new Exit(Direction::SOUTH, forest, village, "village path", "The path back to the village");
-    new Exit(Direction::EAST, forest, temple, "overgrown trail", "A barely visible trail through thick bushes");
+    arena.create<Exit>(Direction::SOUTH, forest, village, "village path", "The path back to the village");
+    arena.create<Exit>(Direction::EAST, forest, temple, "overgrown trail", "A barely visible trail through thick bushes");
 
     // Temple exits
-    new Exit(Direction::WEST, temple, forest, "forest trail", "The trail back to the forest");
-    new Exit(Direction::UP, temple, tower, "spiral staircase", "An ancient stone staircase winding upward", true, "golden key");
+    arena.create<Exit>(Direction::WEST, temple, forest, "forest trail", "The trail back to the forest");
+    arena.create<Exit>(Direction::UP, temple, tower, "spiral staircase", "An ancient stone staircase winding upward", true, "golden key");
 
     // Mine exits
-    new Exit(Direction::UP, mine, village, "mine exit", "The way back up to the village");
+    arena.create<Exit>(Direction::UP, mine, village, "mine exit", "The way back up to the village");
 
     // Tower exits
-    new Exit(Direction::DOWN, tower, temple, "stone steps", "The steps leading back down to the temple");
+    arena.create<Exit>(Direction::DOWN, tower, temple, "stone steps", "The steps leading back down to the temple");
 
     // ===== ADD ITEMS =====
     // Village items
-    village->addEntity(new Item("bread", "A loaf of stale bread", false, 0, false));
-    village->addEntity(new Item("map", "A map of Eldoria", false, 0, false));
+    village->addEntity(arena.create<Item>("bread", "A loaf of stale bread", false, 0, false));
+    village->addEntity(arena.create<Item>("map", "A map of Eldoria", false, 0, false));
 
     // Special container item
-    Item* backpack = new Item("backpack", "A weathered leather pack with a note tucked inside. It can hold 5 items.", true, 5, false);
+    Item* backpack = arena.create<Item>("backpack", "A weathered leather pack with a note tucked inside. It can hold 5 items.", true, 5, false);
     village->addEntity(backpack);
-    backpack->addEntity(new Item("note", "A note: 'Find the hermit in the forest'", false, 0, false));
+    backpack->addEntity(arena.create<Item>("note", "A note: 'Find the hermit in the forest'", false, 0, false));
 
     // Forest items
-    forest->addEntity(new Item("lantern", "A brass lantern with ever-burning oil. Its light repels shadow creatures.", false, 0, false));
-    forest->addEntity(new Item("potion", "A crimson elixir that smells of elderberries. The hermit covets this.", false, 0, false));
-    forest->addEntity(new Item("herbs", "Medicinal forest herbs", false, 0, false));
+    forest->addEntity(arena.create<Item>("lantern", "A brass lantern with ever-burning oil. Its light repels shadow creatures.", false, 0, false));
+    forest->addEntity(arena.create<Item>("potion", "A crimson elixir that smells of elderberries. The hermit covets this.", false, 0, false));
+    forest->addEntity(arena.create<Item>("herbs", "Medicinal forest herbs", false, 0, false));
 
     // Mine items (dark room)
     mine->setDark(true);
-    mine->addEntity(new Item("pickaxe", "A rusty but usable pickaxe", false, 0, false));
-    mine->addEntity(new Item("amethyst", "A jagged purple shard humming with arcane energy. It feels warm to the touch.",
+    mine->addEntity(arena.create<Item>("pickaxe", "A rusty but usable pickaxe", false, 0, false));
+    mine->addEntity(arena.create<Item>("amethyst", "A jagged purple shard humming with arcane energy. It feels warm to the touch.",
         false, 0, true)); // Amulet fragment 1/3
-    mine->addEntity(new Item("dark shrine",
+    mine->addEntity(arena.create<Item>("dark shrine",
         "A sinister obsidian structure pulsing with malevolent energy. Blood stains its base.",
         false, 0, false, true)); // Added 'true' to mark as fixed
 
     // Temple items
-    temple->addEntity(new Item("golden key", "Ornate and cold to the touch. The priestess might know its purpose.", false, 0, false));
-    //temple->addEntity(new Item("sapphire", "A smooth blue fragment encased in ice that never melts. It whispers when held.",
+    temple->addEntity(arena.create<Item>("golden key", "Ornate and cold to the touch. The priestess might know its purpose.", false, 0, false));
+    //temple->addEntity(arena.create<Item>("sapphire", "A smooth blue fragment encased in ice that never melts. It whispers when held.",
     //    false, 0, true)); // Amulet fragment 2/3
-    temple->addEntity(new Item("forge",
+    temple->addEntity(arena.create<Item>("forge",
         "An ancient stone forge with mystical engravings. It has three depressions shaped like gems.",
         false, 0, false, true)); // Added 'true' to mark as fixed
 
     // Tower items
-    tower->addEntity(new Item("ruby", "A blood-red sliver that burns like embers. The curse's power resonates within it.",
+    tower->addEntity(arena.create<Item>("ruby", "A blood-red sliver that burns like embers. The curse's power resonates within it.",
         false, 0, true)); // Amulet fragment 3/3
-    tower->addEntity(new Item("altar",
+    tower->addEntity(arena.create<Item>("altar",
         "The cursed altar that started it all. A perfect amulet-shaped depression "
         "glows faintly in its center, waiting for the restored artifact.",
         false, 0, false, true)); // Added 'true' to mark as fixed
-    tower->addEntity(new Item("ancient relic",
+    tower->addEntity(arena.create<Item>("ancient relic",
         "A mysterious artifact vibrating with untapped power. It could be used for good or evil.",
         false, 0, true));
 
     // ===== ADD NPCs =====
     // Village NPC - Blacksmith
-    NPC* blacksmith = new NPC("Blacksmith", "A burly man with soot-covered arms", village);
+    NPC* blacksmith = arena.create<NPC>("Blacksmith", "A burly man with soot-covered arms", village);
     blacksmith->addDialogue("Welcome to Eldoria, traveler. The curse grows stronger each day.");
     blacksmith->addDialogue("That mine's been locked since the shadows appeared. No one who enters returns unchanged.");
     blacksmith->addDialogue("If you're set on going down there, you'll need my rusty key.");
@@ -120,11 +179,12 @@ void World::InitializeWorld() {
     blacksmith->addDialogue("2. Steal it when I'm not looking (dishonorable)");
     blacksmith->addDialogue("3. Threaten me for it (evil)");
     blacksmith->setInteraction("bread", "rusty key");
+    blacksmith->setRewardDescription("An old iron key that opens the mine entrance");
     blacksmith->addResponse("steal", "You try to steal the key while the blacksmith's back is turned...");
     blacksmith->addResponse("threaten", "You threaten the blacksmith with violence if he doesn't hand over the key...");
 
     // Village NPC - Elder
-    NPC* elderVillager = new NPC("Elder", "A frail old man with wisdom in his eyes", village);
+    NPC* elderVillager = arena.create<NPC>("Elder", "A frail old man with wisdom in his eyes", village);
     elderVillager->addDialogue("*coughs weakly* Our village suffers greatly under this curse.");
     elderVillager->addDialogue("Children go hungry, the sick grow worse, and shadows take more of us each night.");
     elderVillager->addDialogue("You seem capable. Will you aid us in our time of need?");
@@ -136,7 +196,7 @@ void World::InitializeWorld() {
     elderVillager->addResponse("payment", "Even in these desperate times, there are those who would profit from suffering. Here, take these few coins - it's all we can spare.");
 
     // Forest NPC - Hermit
-    NPC* hermit = new NPC("Hermit", "An old man with wild hair and knowing eyes", forest);
+    NPC* hermit = arena.create<NPC>("Hermit", "An old man with wild hair and knowing eyes", forest);
     hermit->addDialogue("*coughs weakly* A new seeker of the amulet, are you?");
     hermit->addDialogue("The amulet was shattered into three fragments to prevent its power from being misused:");
     hermit->addDialogue("- The amethyst fragment lies deep in the abandoned mine, guarded by darkness.");
@@ -147,12 +207,25 @@ void World::InitializeWorld() {
     hermit->addDialogue("2. Attack me and take what knowledge I have (choose violence)");
     hermit->addDialogue("3. Leave me to my fate (miss vital information)");
     hermit->setInteraction("potion", "scroll");
+    hermit->setRewardDescription("Ancient Scroll from the Hermit "
+        "                                The parchment is yellowed with age, covered in delicate script and strange symbols.It reads : "
+        "                                'To the Seeker of the Amulet : "
+        "                                The three fragments must be reunited at the temple forge to restore the amulet's power. Each fragment resonates with a unique energy: "
+        "                                - The amethyst controls shadows and can part the darkness "
+        "                                - The sapphire holds protective magic against curses "
+        "                                - The ruby contains the power to break or strengthen magical bonds "
+        "                                BEWARE : The corrupted altar in the tower will try to tempt you.The restored amulet must be placed there to break the curse, but approach with a pure heart. "
+        "                                The curse grows stronger in darkness.Keep your lantern lit in the mine, for shadow creatures feed on fear and flesh alike. "
+        "                                The fragments can be combined only at the temple forge.All three must be placed simultaneously for the ritual to succeed. "
+        "                                Choose your path wisely.The amulet reveals the true nature of its bearer. "
+        "                                - Eldric, Last of the Keepers' "
+        "                                At the bottom of the scroll is a hastily drawn map showing the relationship between the village, forest, mine, temple, and tower, with small notes about dangers in each location.");
     hermit->setHasImportantInfo(true);
     hermit->addResponse("attack", "You raise your weapon against the frail hermit...");
     hermit->addResponse("help", "Thank you for your kindness. The lantern you found will protect you in the darkness.");
 
     // Forest NPC - Bandit
-    NPC* bandit = new NPC("Bandit", "A rough-looking man with a knife", forest);
+    NPC* bandit = arena.create<NPC>("Bandit", "A rough-looking man with a knife", forest);
     bandit->addDialogue("*points knife* Stay back! This is my territory now!");
     bandit->addDialogue("*lowers knife slightly* The curse... it's driven us all to desperation.");
     bandit->addDialogue("My family is starving in the village. I never wanted to become a thief.");
@@ -165,7 +238,7 @@ void World::InitializeWorld() {
     bandit->addResponse("rob", "P-please! Don't take everything! My children will starve!");
 
     // Mine NPC - Corrupted Villager
-    NPC* corruptedVillager = new NPC("Corrupted Villager", "A villager whose mind has been twisted by the curse", mine);
+    NPC* corruptedVillager = arena.create<NPC>("Corrupted Villager", "A villager whose mind has been twisted by the curse", mine);
     corruptedVillager->addDialogue("*growls and mutters incoherently while stumbling toward you*");
     corruptedVillager->addDialogue("The d-darkness... it speaks to me... must... obey... *reaches toward you with blackened hands*");
     corruptedVillager->addDialogue("H-help... me... or... end... this...");
@@ -178,18 +251,19 @@ void World::InitializeWorld() {
     corruptedVillager->addResponse("sacrifice", "As you perform the dark ritual, the villager's corrupted essence flows into you, granting forbidden power...");
 
     // Temple NPC - Ghostly Priestess
-    NPC* priestess = new NPC("Ghostly Priestess", "A translucent figure in ancient robes", temple);
+    NPC* priestess = arena.create<NPC>("Ghostly Priestess", "A translucent figure in ancient robes", temple);
     priestess->addDialogue("*her voice echoes eerily* The living do not belong here.");
     priestess->addDialogue("My spirit is bound to this place by pain and regret.");
     priestess->addDialogue("Only those who offer healing herbs may earn my trust and aid.");
     priestess->addDialogue("The sapphire fragment you seek is within my keeping. Bring herbs to ease my eternal suffering.");
     priestess->addDialogue("Once you have all three fragments, return here to combine them at the altar.");
     priestess->setInteraction("herbs", "sapphire");
+    priestess->setRewardDescription("A smooth blue fragment encased in ice that never melts. It whispers when held.");
     priestess->addResponse("help", "You have shown compassion to the dead. Remember this path when darkness tempts you.");
     priestess->addResponse("attack", "Your weapon passes through my spectral form. How foolish to attack what cannot be harmed by mortal means.");
 
     // Tower NPC - Dark Spirit
-    NPC* darkSpirit = new NPC("Dark Spirit", "A shadowy figure that whispers temptations", tower);
+    NPC* darkSpirit = arena.create<NPC>("Dark Spirit", "A shadowy figure that whispers temptations", tower);
     darkSpirit->addDialogue("*a voice like smoke in your mind* I sense great potential in you...");
     darkSpirit->addDialogue("Why save these ungrateful villagers? The power of the amulet could be yours alone.");
     darkSpirit->addDialogue("I can show you how to corrupt the amulet fragments. Direct their power for your own desires.");
@@ -201,12 +275,778 @@ void World::InitializeWorld() {
     darkSpirit->addResponse("listen", "Yes... consider the possibilities. The fragments themselves can be corrupted, their power twisted to serve only you.");
     darkSpirit->addResponse("embrace", "Excellent. The corruption begins with your heart and extends to the amulet. Sacrifice at the dark shrine to seal your path.");
     darkSpirit->setPreventReinteraction(true);
+
+    // ===== DIALOGUE =====
+    // One graph holds every conversation; each NPC numbers its nodes from
+    // where they start, and edges may lead to nodes added further down
+    std::shared_ptr<DialogueGraph> conversations = std::make_shared<DialogueGraph>();
+    DialogueGraph& talk = *conversations;
+
+    // Blacksmith - bread for the rusty key, when the trade above did not happen
+    enum { SMITH_START, SMITH_OFFER, SMITH_ASK, SMITH_TRADE, SMITH_DEAL, SMITH_KEEP, SMITH_NO_BREAD, SMITH_TALK };
+    uint32_t smith = static_cast<uint32_t>(talk.getNodeCount());
+    talk.addNode();
+    talk.addBranch(DialogueCondition::REWARD_PENDING, smith + SMITH_OFFER);
+    talk.addGoto(smith + SMITH_TALK);
+    talk.addNode();
+    talk.addBranch(DialogueCondition::HAS_ITEM, smith + SMITH_ASK, "bread");
+    talk.addGoto(smith + SMITH_NO_BREAD);
+    talk.addNode(true);
+    talk.say("{npc} eyes the bread hungrily. \"I'll trade my rusty key for that loaf.\" (yes/no)");
+    talk.addAnswer("yes", smith + SMITH_TRADE);
+    talk.addAnswer("y", smith + SMITH_TRADE);
+    talk.addGoto(smith + SMITH_KEEP);
+    talk.addNode();
+    talk.addBranch(DialogueCondition::HAS_ITEM, smith + SMITH_DEAL, "bread");
+    talk.addGoto(smith + SMITH_TALK);
+    talk.addNode();
+    talk.addItemEffect(DialogueAction::TAKE_ITEM, "bread");
+    talk.say("You trade the bread for the rusty key.");
+    talk.say("The blacksmith tears into the loaf. \"This mine key is yours now. Be careful down there.\"");
+    talk.addItemEffect(DialogueAction::GIVE_ITEM, "rusty key", "An old iron key that opens the mine entrance");
+    talk.addEffect(DialogueAction::ALIGNMENT, 1);
+    talk.addEffect(DialogueAction::REWARD_GIVEN);
+    talk.addNode();
+    talk.say("You decide to keep your bread for now.");
+    talk.addNode();
+    talk.say("\"Bring me some bread if you want the mine key. A man's got to eat.\"");
+    talk.addNode();
+    talk.addEffect(DialogueAction::TALK);
+    blacksmith->setDialogue(conversations.get(), smith);
+
+    // Elder - asks for help with the village
+    enum { ELDER_START, ELDER_SHARE, ELDER_IGNORE, ELDER_DEMAND };
+    uint32_t elder = static_cast<uint32_t>(talk.getNodeCount());
+    talk.addNode(true, "Choose (1-3): ");
+    talk.say("The village elder looks at you with hopeful eyes.");
+    talk.say("1. Share some of your supplies");
+    talk.say("2. Ignore the elder's request");
+    talk.say("3. Demand payment for your help");
+    talk.addAnswer("1", elder + ELDER_SHARE);
+    talk.addAnswer("2", elder + ELDER_IGNORE);
+    talk.addAnswer("3", elder + ELDER_DEMAND);
+    talk.addNode();
+    talk.say("You offer some of your supplies to help the villagers.");
+    talk.say("\"Bless you, traveler. Your kindness brings light to our darkest hour.\"");
+    talk.addEffect(DialogueAction::ALIGNMENT, 2);
+    talk.addEffect(DialogueAction::END_INTERACTIONS);
+    talk.addNode();
+    talk.say("You tell the elder you need to focus on your quest first.");
+    talk.say("\"I see. Another who cares only for themselves. May you find what you seek, though it brings you no joy.\"");
+    talk.addEffect(DialogueAction::END_INTERACTIONS);
+    talk.addNode();
+    talk.say("You demand payment for your services despite their desperate situation.");
+    talk.say("\"Even in these desperate times, there are those who would profit from suffering.\"");
+    talk.say("The elder reluctantly hands you a few coins. \"It's all we can spare.\"");
+    talk.addEffect(DialogueAction::ALIGNMENT, -1);
+    talk.addEffect(DialogueAction::END_INTERACTIONS);
+    elderVillager->setDialogue(conversations.get(), elder);
+
+    // Hermit - the potion for the scroll, once the rumor has been shared
+    enum { HERMIT_START, HERMIT_OFFER, HERMIT_ASK, HERMIT_SHARE, HERMIT_DEAL, HERMIT_TALK };
+    uint32_t hermitStart = static_cast<uint32_t>(talk.getNodeCount());
+    talk.addNode();
+    talk.addBranch(DialogueCondition::REWARD_PENDING, hermitStart + HERMIT_OFFER);
+    talk.addGoto(hermitStart + HERMIT_TALK);
+    talk.addNode();
+    talk.addBranch(DialogueCondition::HAS_ITEM, hermitStart + HERMIT_ASK, "potion");
+    talk.addGoto(hermitStart + HERMIT_TALK);
+    talk.addNode(true);
+    talk.say("The hermit looks at your potion with desperate eyes.");
+    talk.say("\"That elixir would ease my suffering greatly. Will you share it?\" (yes/no)");
+    talk.addAnswer("yes", hermitStart + HERMIT_SHARE);
+    talk.addAnswer("y", hermitStart + HERMIT_SHARE);
+    talk.addGoto(hermitStart + HERMIT_TALK);
+    talk.addNode();
+    talk.addBranch(DialogueCondition::HAS_ITEM, hermitStart + HERMIT_DEAL, "potion");
+    talk.addGoto(hermitStart + HERMIT_TALK);
+    talk.addNode();
+    talk.addItemEffect(DialogueAction::TAKE_ITEM, "potion");
+    talk.say("You give the potion to the hermit.");
+    talk.say("He drinks it and his breathing eases. \"Thank you, kind soul.\"");
+    talk.say("\"The lantern you found will protect you in the mine's darkness. The shadows flee from its light.\"");
+    talk.say("\"But beware - its oil won't last forever. Make haste when in dark places.\"");
+    talk.addItemEffect(DialogueAction::GIVE_ITEM, "scroll", "Ancient parchment with instructions for combining the amulet fragments");
+    talk.addEffect(DialogueAction::ALIGNMENT, 1);
+    talk.addEffect(DialogueAction::REWARD_GIVEN);
+    talk.addNode();
+    talk.addEffect(DialogueAction::TALK);
+    hermit->setDialogue(conversations.get(), hermitStart);
+
+    // Bandit - fight, forgive or rob
+    enum { BANDIT_START, BANDIT_ATTACK, BANDIT_FORGIVE, BANDIT_ROB };
+    uint32_t banditStart = static_cast<uint32_t>(talk.getNodeCount());
+    talk.addNode(true, "Choose (1-3): ");
+    talk.say("The desperate bandit stands before you, knife trembling in his hand.");
+    talk.say("1. Attack the bandit");
+    talk.say("2. Forgive and help him");
+    talk.say("3. Threaten and rob him instead");
+    talk.addAnswer("1", banditStart + BANDIT_ATTACK);
+    talk.addAnswer("2", banditStart + BANDIT_FORGIVE);
+    talk.addAnswer("3", banditStart + BANDIT_ROB);
+    talk.addNode();
+    talk.say("You draw your weapon as the bandit readies for combat!");
+    talk.say("\"I won't go down without a fight!\"");
+    talk.addEffect(DialogueAction::ALIGNMENT, -1);
+    talk.addEffect(DialogueAction::END_INTERACTIONS);
+    talk.addNode();
+    talk.say("You lower your guard and offer to help the bandit and his family.");
+    talk.say("\"You... would help me? After I threatened you?\" Tears form in his eyes.");
+    talk.say("\"I won't forget this mercy. Take this - I found it in the forest.\"");
+    talk.addItemEffect(DialogueAction::GIVE_ITEM, "herbal mix", "A potent mixture of medicinal herbs");
+    talk.addEffect(DialogueAction::ALIGNMENT, 2);
+    talk.addEffect(DialogueAction::END_INTERACTIONS);
+    talk.addNode();
+    talk.say("You turn the tables and threaten the bandit with your superior weapons.");
+    talk.say("\"P-please! Don't take everything! My children will starve!\"");
+    talk.say("You take his meager belongings anyway.");
+    talk.addItemEffect(DialogueAction::GIVE_ITEM, "small pouch", "A pouch containing a few coins");
+    talk.addEffect(DialogueAction::ALIGNMENT, -2);
+    talk.addEffect(DialogueAction::END_INTERACTIONS);
+    bandit->setDialogue(conversations.get(), banditStart);
+
+    // Corrupted Villager - save with herbs, end their suffering, or sacrifice them
+    enum { VILLAGER_START, VILLAGER_SAVE, VILLAGER_MIX, VILLAGER_HERBS, VILLAGER_SAVED, VILLAGER_NO_HERBS,
+        VILLAGER_MERCY, VILLAGER_SACRIFICE };
+    uint32_t villager = static_cast<uint32_t>(talk.getNodeCount());
+    talk.addNode(true, "Choose (1-3): ");
+    talk.say("The corrupted villager stumbles toward you, twisted by the curse.");
+    talk.say("Their humanity seems to be fighting against the corruption.");
+    talk.say("1. Try to save them with herbs");
+    talk.say("2. End their suffering mercifully");
+    talk.say("3. Sacrifice their corrupted essence for power");
+    talk.addAnswer("1", villager + VILLAGER_SAVE);
+    talk.addAnswer("2", villager + VILLAGER_MERCY);
+    talk.addAnswer("3", villager + VILLAGER_SACRIFICE);
+    talk.addNode();
+    talk.addBranch(DialogueCondition::HAS_ITEM, villager + VILLAGER_MIX, "herbal mix");
+    talk.addBranch(DialogueCondition::HAS_ITEM, villager + VILLAGER_HERBS, "herbs");
+    talk.addGoto(villager + VILLAGER_NO_HERBS);
+    talk.addNode();
+    talk.say("You attempt to administer herbal mix to calm the corrupted villager...");
+    talk.addItemEffect(DialogueAction::TAKE_ITEM, "herbal mix");
+    talk.addGoto(villager + VILLAGER_SAVED);
+    talk.addNode();
+    talk.say("You attempt to administer herbs to calm the corrupted villager...");
+    talk.addItemEffect(DialogueAction::TAKE_ITEM, "herbs");
+    talk.addGoto(villager + VILLAGER_SAVED);
+    talk.addNode();
+    talk.say("The herbs take effect, and the darkness begins to recede from their eyes.");
+    talk.say("\"T-thank you,\" they stammer. \"I was lost... but you brought me back.\"");
+    talk.say("They hand you a small trinket. \"This may help you on your journey.\"");
+    talk.addItemEffect(DialogueAction::GIVE_ITEM, "amulet shard", "A tiny fragment that seems to resonate with the larger amulet pieces");
+    talk.addEffect(DialogueAction::ALIGNMENT, 2);
+    talk.addEffect(DialogueAction::END_INTERACTIONS);
+    talk.addNode();
+    talk.say("You try to help, but without herbs, there's little you can do.");
+    talk.say("The villager lunges at you, fully consumed by the darkness!");
+    talk.addEffect(DialogueAction::END_INTERACTIONS);
+    talk.addNode();
+    talk.say("With a heavy heart, you end the villager's suffering quickly and painlessly.");
+    talk.say("It was the only humane choice. Their twisted features relax in final peace.");
+    talk.addEffect(DialogueAction::END_INTERACTIONS);
+    talk.addNode();
+    talk.say("You begin a dark ritual, drawing the corrupted essence from the villager...");
+    talk.say("You have made your choice, complete the ritual by typing 'Sacrifice villager'");
+    talk.addEffect(DialogueAction::ALIGNMENT, -3);
+    talk.addEffect(DialogueAction::END_INTERACTIONS);
+    corruptedVillager->setDialogue(conversations.get(), villager);
+
+    // Dark Spirit - reject, listen or embrace the darkness
+    enum { SPIRIT_START, SPIRIT_REJECT, SPIRIT_LISTEN, SPIRIT_EMBRACE };
+    uint32_t spirit = static_cast<uint32_t>(talk.getNodeCount());
+    talk.addNode(true);
+    talk.say("The dark spirit's voice slithers into your mind. What do you do?");
+    talk.say("1. Reject its offer");
+    talk.say("2. Listen to learn more");
+    talk.say("3. Embrace the darkness");
+    talk.addAnswer("1", spirit + SPIRIT_REJECT);
+    talk.addAnswer("2", spirit + SPIRIT_LISTEN);
+    talk.addAnswer("3", spirit + SPIRIT_EMBRACE);
+    talk.addNode();
+    talk.say("You steel your mind against the spirit's temptations.");
+    talk.say("\"You will regret spurning such power!\" it hisses as it fades back into the shadows.");
+    talk.addEffect(DialogueAction::ALIGNMENT, 1);
+    talk.addEffect(DialogueAction::END_INTERACTIONS);
+    talk.addNode();
+    talk.say("You cautiously allow the spirit to continue...");
+    talk.say("\"The fragments themselves can be corrupted at the shrine,\" it purrs.");
+    talk.say("\"Their power twisted to serve only you. Think of the possibilities...\"");
+    talk.addEffect(DialogueAction::ALIGNMENT, -1);
+    talk.addEffect(DialogueAction::END_INTERACTIONS);
+    talk.addNode();
+    talk.say("You open yourself to the darkness, feeling it seep into your very being.");
+    talk.say("\"Excellent,\" the spirit whispers. \"The first step is taken.\"");
+    talk.say("\"Sacrifice at the dark shrine to seal your path to power.\"");
+    talk.addEffect(DialogueAction::ALIGNMENT, -2);
+    talk.addEffect(DialogueAction::END_INTERACTIONS);
+    darkSpirit->setDialogue(conversations.get(), spirit);
+
+    dialogue = std::move(conversations);
+
+    // ===== NUMBER ROOMS =====
+    rooms = { village, forest, mine, temple, tower };
+    for (size_t i = 0; i < rooms.size(); i++) {
+        rooms[i]->setGraphIndex(static_cast<int>(i));
+    }
+    startRoom = village;
+}
+
+void World::LoadWorld(const WorldImage& image, std::shared_ptr<const DialogueGraph> conversations) {
+    using namespace WorldFormat;
+
+    Clear();
+    arena.getNames().reserve(image.getNameCount());
+
+    if (conversations == nullptr) {
+        std::shared_ptr<DialogueGraph> loaded = std::make_shared<DialogueGraph>();
+        loaded->Load(image);
+        conversations = std::move(loaded);
+    }
+    dialogue = std::move(conversations);
+
+    // Room for every entity up front, so the world fills one block
+    arena.reserve(image.getRoomCount() * sizeof(Room) + image.getExitCount() * sizeof(Exit)
+        + image.getItemCount() * sizeof(Item) + image.getNpcCount() * sizeof(NPC),
+        image.getRoomCount() + image.getExitCount() + image.getItemCount() + image.getNpcCount());
+
+    // ===== ROOMS AND EXITS =====
+    // Rooms, NPCs and items take the first slots, so exits can name rooms not created yet
+    arena.addPlaceholders(SlotCount(image), nullptr);
+    rooms.reserve(image.getRoomCount());
+    for (size_t i = 0; i < image.getRoomCount(); i++) {
+        rooms.push_back(LoadRoom(image, static_cast<uint32_t>(i)));
+    }
+
+    // ===== ITEMS =====
+    // Containers precede their contents, so every parent already exists
+    std::vector<Item*> items(image.getItemCount());
+    for (size_t i = 0; i < items.size(); i++) {
+        const ItemRecord& record = image.getItem(i);
+        items[i] = LoadItem(image, static_cast<uint32_t>(i));
+
+        Entity* parent = record.room != NONE ? static_cast<Entity*>(rooms[record.room]) : items[record.container];
+        parent->addEntity(items[i]);
+    }
+
+    // ===== NPCs =====
+    for (size_t i = 0; i < image.getNpcCount(); i++) {
+        LoadNpc(image, static_cast<uint32_t>(i), rooms[image.getNpc(i).room]);
+    }
+
+    startRoom = rooms[image.getStartRoom()];
+}
+
+Room* World::LoadRoom(const WorldImage& image, uint32_t index) {
+    using namespace WorldFormat;
+
+    const RoomRecord& record = image.getRoom(index);
+    Room* room = arena.createAt<Room>(index, BorrowedText(image.getString(record.name)),
+        BorrowedText(image.getString(record.description)), (record.flags & ROOM_DARK) != 0);
+    room->setRecord(index);
+    room->setGraphIndex(static_cast<int>(index));
+
+    for (uint32_t e = record.firstExit; e < record.firstExit + record.exitCount; e++) {
+        const ExitRecord& exitRecord = image.getExit(e);
+        Exit* exit = arena.create<Exit>(static_cast<Direction>(exitRecord.direction), room, arena.placeholder(exitRecord.destination),
+            BorrowedText(image.getString(exitRecord.name)), BorrowedText(image.getString(exitRecord.description)),
+            (exitRecord.flags & EXIT_LOCKED) != 0, BorrowedText(image.getString(exitRecord.key)));
+        exit->setRecord(e);
+    }
+    return room;
+}
+
+Item* World::LoadItem(const WorldImage& image, uint32_t index) {
+    using namespace WorldFormat;
+
+    const ItemRecord& record = image.getItem(index);
+    Item* item = arena.createAt<Item>(ItemSlot(image, index), BorrowedText(image.getString(record.name)),
+        BorrowedText(image.getString(record.description)),
+        (record.flags & ITEM_CONTAINER) != 0, record.capacity,
+        (record.flags & ITEM_FRAGMENT) != 0, (record.flags & ITEM_FIXED) != 0);
+    item->setRecord(index);
+    return item;
+}
+
+NPC* World::LoadNpc(const WorldImage& image, uint32_t index, Room* room) {
+    using namespace WorldFormat;
+
+    // NPCs due on the same turn act in slot order, which is record order
+    // however many rooms were built before
+    const NpcRecord& record = image.getNpc(index);
+    NPC* npc = arena.createAt<NPC>(NpcSlot(image, index), BorrowedText(image.getString(record.name)),
+        BorrowedText(image.getString(record.description)), room);
+    npc->setRecord(index);
+
+    for (uint32_t d = record.firstDialogue; d < record.firstDialogue + record.dialogueCount; d++) {
+        npc->addDialogue(BorrowedText(image.getString(image.getDialogue(d))));
+    }
+    for (uint32_t r = record.firstResponse; r < record.firstResponse + record.responseCount; r++) {
+        const ResponseRecord& response = image.getResponse(r);
+        npc->addResponse(BorrowedText(image.getString(response.input)),
+            BorrowedText(image.getString(response.response)));
+    }
+    npc->setBehavior(static_cast<NpcBehavior>(record.behavior), record.period);
+    npc->setAnnouncement(BorrowedText(image.getString(record.announcement)));
+    for (uint32_t s = record.firstPatrolStop; s < record.firstPatrolStop + record.patrolStopCount; s++) {
+        npc->addPatrolStop(arena.placeholder(image.getPatrolStop(s)));
+    }
+
+    npc->setInteraction(BorrowedText(image.getString(record.requiredItem)), BorrowedText(image.getString(record.rewardItem)));
+    npc->setRewardDescription(BorrowedText(image.getString(record.rewardDescription)));
+    npc->setDialogue(dialogue.get(), record.dialogueRoot);
+    npc->setAsEnemy((record.flags & NPC_ENEMY) != 0);
+    npc->setHasImportantInfo((record.flags & NPC_IMPORTANT_INFO) != 0);
+    npc->setPreventReinteraction((record.flags & NPC_PREVENT_REINTERACTION) != 0);
+    return npc;
+}
+
+void World::Instantiate(std::shared_ptr<const WorldTemplate> worldTemplate) {
+    Clear();
+    source = std::move(worldTemplate);
+    dialogue = source->getDialogue();
+    arena.getNames().share(&source->getNames());
+
+    // A room is built the first time its handle is resolved; the slots of
+    // the NPCs and items follow, filled as their rooms are built
+    arena.addPlaceholders(SlotCount(source->getImage()), this);
+    graphChanges.attach(&source->getGraph());
+}
+
+void World::SaveWorld(WorldImageWriter& writer) const {
+    using namespace WorldFormat;
+
+    // Room records follow graph order, so graph indexes double as record indexes
+    for (const Room* room : rooms) {
+        writer.addRoom(room->getName(), room->getDescription(), room->getIsDark());
+    }
+    if (startRoom != nullptr) {
+        writer.setStartRoom(static_cast<uint32_t>(startRoom->getGraphIndex()));
+    }
+
+    for (const Room* room : rooms) {
+        for (const Exit* exit : room->getExits()) {
+            if (exit != nullptr) {
+                writer.addExit(static_cast<uint32_t>(room->getGraphIndex()),
+                    static_cast<uint32_t>(exit->getDestination()->getGraphIndex()), exit->getDirection(),
+                    exit->getName(), exit->getDescription(), exit->isLocked() ? exit->getKeyName() : "");
+            }
+        }
+    }
+
+    // Dialogue nodes keep their numbers, so the NPCs' first nodes stay valid
+    if (dialogue != nullptr) {
+        dialogue->Save(writer);
+    }
+
+    // Items (with their contents) are loaded before the NPCs of the same room
+    std::function<void(const Entity*, uint32_t, uint32_t)> addItems =
+        [&](const Entity* parent, uint32_t room, uint32_t container) {
+        for (const Entity* entity : parent->getContains(EntityBucket::ITEMS)) {
+            const Item* item = static_cast<const Item*>(entity);
+            uint32_t index = writer.addItem(item->getName(), item->getDescription(),
+                room, container, ItemFlags(item), item->getCapacity());
+            addItems(item, NONE, index);
+        }
+    };
+
+    for (const Room* room : rooms) {
+        addItems(room, static_cast<uint32_t>(room->getGraphIndex()), NONE);
+    }
+
+    for (const Room* room : rooms) {
+        for (const Entity* entity : room->getContains(EntityBucket::NPCS)) {
+            const NPC* npc = static_cast<const NPC*>(entity);
+            uint32_t flags = (npc->getIsEnemy() ? NPC_ENEMY : 0)
+                | (npc->getHasImportantInfo() ? NPC_IMPORTANT_INFO : 0)
+                | (npc->preventReinteraction ? NPC_PREVENT_REINTERACTION : 0);
+            uint32_t index = writer.addNpc(npc->getName(), npc->getDescription(),
+                static_cast<uint32_t>(room->getGraphIndex()), flags);
+
+            writer.setInteraction(index, npc->getRequiredItem(), npc->getRewardItem(), npc->getRewardDescription());
+            writer.setDialogueRoot(index, npc->getDialogueRoot());
+            for (std::string_view line : npc->getDialogues()) {
+                writer.addDialogue(index, line);
+            }
+            for (const auto& response : npc->getResponses()) {
+                writer.addResponse(index, response.input, response.reply);
+            }
+            writer.setBehavior(index, npc->getBehavior(), npc->getPeriod(), npc->getAnnouncement());
+            for (EntityHandle stop : npc->getPatrolStops()) {
+                writer.addPatrolStop(index, static_cast<uint32_t>(arena.find<Room>(stop)->getGraphIndex()));
+            }
+        }
+    }
+}
+
+Player* World::CreatePlayer(const string& name, const string& description) {
+    player = arena.create<Player>(name, description, GetStartingRoom());
+    return player;
 }
 
 Room* World::GetStartingRoom() {
-    return village;
+    if (startRoom == nullptr && source != nullptr) {
+        return GetRoom(static_cast<int>(source->getImage().getStartRoom()));
+    }
+    return startRoom;
+}
+
+Room* World::GetRoom(int index) {
+    return rooms.empty() ? arena.get<Room>(arena.placeholder(static_cast<uint32_t>(index))) : rooms[index];
+}
+
+void World::SetDark(Room* room, bool dark) {
+    room->setDark(dark);
+    if (graphChanges.isAttached()) {
+        graphChanges.onDarknessChanged(room->getGraphIndex(), dark);
+    }
+}
+
+// ========== Building Sessions ==========
+
+Entity* World::build(uint32_t index) {
+    const WorldImage& image = source->getImage();
+    if (index >= image.getRoomCount()) {
+        return nullptr;     // NPCs and items are only built with their rooms
+    }
+
+    Room* room = LoadRoom(image, index);
+    builtRooms.push_back(index);
+    if (graphChanges.isDark(static_cast<int>(index)) != room->getIsDark()) {
+        room->setDark(!room->getIsDark());
+    }
+
+    // Exits are edges by record; unlock those play has opened before
+    // attaching, so the graph hears only of new unlocks
+    for (Exit* exit : room->getExits()) {
+        if (exit == nullptr) {
+            continue;
+        }
+        if (graphChanges.isUnlocked(static_cast<int>(exit->getRecord()))) {
+            exit->unlock(exit->getKeyName());
+        }
+        exit->attachToGraph(&graphChanges, static_cast<int>(exit->getRecord()));
+    }
+
+    BuildContents(room, WorldDelta::ROOM | index);
+    return room;
+}
+
+Item* World::BuildItem(uint32_t reference) {
+    uint32_t index = reference & WorldDelta::INDEX_MASK;
+    Item* item;
+    if ((reference & WorldDelta::KIND_MASK) == WorldDelta::CREATED) {
+        const WorldDelta::CreatedItem& record = base.created[index];
+        item = arena.create<Item>(ItemPrototype::Get(record.prototype));
+        item->setLit(record.lit);
+        builtCreated[index] = true;
+    }
+    else {
+        item = LoadItem(source->getImage(), index);
+        if (baseLit.count(index) != 0) {
+            item->setLit(true);
+        }
+    }
+
+    BuildContents(item, reference);
+    return item;
+}
+
+void World::BuildContents(Entity* container, uint32_t reference) {
+    // What the delta lists for the container, else what the template put there
+    auto changed = baseContents.find(reference);
+    const std::vector<uint32_t>& entities = changed != baseContents.end() ? *changed->second
+        : source->getContents(reference);
+
+    for (uint32_t entity : entities) {
+        uint32_t index = entity & WorldDelta::INDEX_MASK;
+        switch (entity & WorldDelta::KIND_MASK) {
+        case WorldDelta::PLAYER:
+            // The resumed player, in their place among the room's entities
+            if (player != nullptr && player->getLocation() == nullptr) {
+                player->setLocation(static_cast<Room*>(container));
+            }
+            break;
+        case WorldDelta::NPC: {
+            NPC* npc = LoadNpc(source->getImage(), index, static_cast<Room*>(container));
+            auto state = baseStates.find(index);
+            if (state != baseStates.end()) {
+                npc->setState(*state->second);
+            }
+            break;
+        }
+        default:
+            container->addEntity(BuildItem(entity));
+            break;
+        }
+    }
+}
+
+NPC* World::NpcByRecord(uint32_t record) {
+    const WorldImage& image = source->getImage();
+    uint32_t slot = NpcSlot(image, record);
+    if (!arena.wasBuilt(slot)) {
+        auto moved = baseNpcRooms.find(record);
+        GetRoom(static_cast<int>(moved != baseNpcRooms.end() ? moved->second : image.getNpc(record).room));
+    }
+    return arena.get<NPC>(arena.placeholder(slot));
+}
+
+// ========== Scheduled Behavior ==========
+
+void World::UpdateEntities(uint32_t turn, const Player& player) {
+    const Room* center = player.getLocation();
+    if (center != observed) {
+        observed = center;
+        WakeAround(center, turn);
+    }
+
+    scheduler.advance(turn, [&](EntityHandle handle, uint32_t due) {
+        // Destroyed, or asleep since and woken for another turn
+        NPC* npc = arena.get<NPC>(handle);
+        if (npc == nullptr || npc->getNextUpdate() != due) {
+            return;
+        }
+        if (!IsNear(npc->getLocation(), center)) {
+            npc->setNextUpdate(0);
+            return;
+        }
+
+        uint32_t delay = npc->update(due, player);
+        npc->setNextUpdate(delay != 0 ? due + delay : 0);
+        if (delay != 0) {
+            scheduler.schedule(handle, due + delay);
+        }
+    });
+}
+
+void World::WakeAround(const Room* center, uint32_t turn) {
+    auto wake = [&](const Room* room) {
+        for (Entity* entity : room->getContains(EntityBucket::NPCS)) {
+            NPC* npc = static_cast<NPC*>(entity);
+            if (npc->getPeriod() != 0 && npc->getNextUpdate() == 0) {
+                npc->setNextUpdate(turn + npc->getPeriod());
+                scheduler.schedule(npc->getHandle(), turn + npc->getPeriod());
+            }
+        }
+    };
+
+    wake(center);
+    for (const Exit* exit : center->getExits()) {
+        if (exit != nullptr && exit->getDestination() != center) {
+            wake(exit->getDestination());
+        }
+    }
+}
+
+bool World::IsNear(const Room* room, const Room* center) {
+    if (room == center) {
+        return true;
+    }
+    for (const Exit* exit : center->getExits()) {
+        if (exit != nullptr && exit->getDestination() == room) {
+            return true;
+        }
+    }
+    return false;
+}
+// ========== Session Deltas ==========
+
+namespace {
+
+    // Walks containers depth first, turning their entities into delta references
+    struct ContentsWalker {
+        std::unordered_map<const Entity*, uint32_t> createdIds;
+        std::vector<WorldDelta::CreatedItem> created;   // Items made in play, by created index
+        std::vector<const NPC*> npcs;                   // Template NPCs met
+        std::vector<WorldDelta::Contents> contents;     // Every container visited, empty ones too
+
+        uint32_t ReferenceOf(const Entity* entity) {
+            switch (entity->getType()) {
+            case EntityType::PLAYER:
+                return WorldDelta::PLAYER;
+            case EntityType::NPC:
+                return WorldDelta::NPC | entity->getRecord();
+            default:
+                break;
+            }
+            if (entity->getRecord() != Entity::NO_RECORD) {
+                return WorldDelta::ITEM | entity->getRecord();
+            }
+            auto inserted = createdIds.emplace(entity, static_cast<uint32_t>(created.size()));
+            if (inserted.second) {
+                const Item* item = static_cast<const Item*>(entity);
+                uint32_t prototype = item->getPrototype() != ItemPrototype::NONE ? item->getPrototype()
+                    : ItemPrototype::Intern(item->getName(), item->getDescription(), ItemFlags(item), item->getCapacity()).number;
+                created.push_back(WorldDelta::CreatedItem{ prototype, item->getIsLit() });
+            }
+            return WorldDelta::CREATED | inserted.first->second;
+        }
+
+        template <typename Entities>
+        void Visit(uint32_t container, const Entities& entities) {
+            std::vector<uint32_t> references;
+            for (const Entity* entity : entities) {
+                uint32_t reference = ReferenceOf(entity);
+                references.push_back(reference);
+
+                if (entity->getType() == EntityType::ITEM) {
+                    Visit(reference, entity->getContains());
+                }
+                else if (entity->getType() == EntityType::NPC) {
+                    npcs.push_back(static_cast<const NPC*>(entity));
+                }
+            }
+            contents.push_back(WorldDelta::Contents{ container, std::move(references) });
+        }
+
+        // A container never built keeps its entry of the earlier delta;
+        // items created back then are numbered anew
+        uint32_t Carry(uint32_t reference, const WorldDelta& earlier, std::unordered_map<uint32_t, uint32_t>& carried) {
+            if ((reference & WorldDelta::KIND_MASK) != WorldDelta::CREATED) {
+                return reference;
+            }
+            auto inserted = carried.emplace(reference, static_cast<uint32_t>(created.size()));
+            if (inserted.second) {
+                created.push_back(earlier.created[reference & WorldDelta::INDEX_MASK]);
+            }
+            return WorldDelta::CREATED | inserted.first->second;
+        }
+    };
+}
+
+void World::CaptureDelta(const Player& player, WorldDelta& delta) const {
+    delta = WorldDelta();
+    delta.turn = scheduler.getTurn();
+    delta.playerRoom = player.getLocation()->getRecord();
+    delta.player = player.getState();
+    delta.unlockedExits = graphChanges.getUnlockedEdges();
+    delta.toggledRooms = graphChanges.getToggledRooms();
+
+    // What play reached, rooms in record order
+    std::vector<uint32_t> reachedRooms(builtRooms);
+    std::sort(reachedRooms.begin(), reachedRooms.end());
+    ContentsWalker walker;
+    for (uint32_t room : reachedRooms) {
+        walker.Visit(WorldDelta::ROOM | room, arena.find<Room>(arena.placeholder(room))->getContains());
+    }
+    walker.Visit(WorldDelta::PLAYER, player.getInventory());
+
+    arena.getItems().forEachWith(ItemTable::LIT, [&](const Item* item) {
+        if (item->getRecord() != Entity::NO_RECORD) {
+            delta.litItems.push_back(item->getRecord());
+        }
+    });
+    for (const NPC* npc : walker.npcs) {
+        NPC::State state = npc->getState();
+        if (state != source->getNpcState(npc->getRecord())) {
+            delta.npcs.push_back(WorldDelta::NpcChange{ npc->getRecord(), state });
+        }
+    }
+
+    // Containers whose entities differ from the template, emptied ones included
+    for (WorldDelta::Contents& entry : walker.contents) {
+        if (entry.entities != source->getContents(entry.container)) {
+            delta.contents.push_back(std::move(entry));
+        }
+    }
+
+    // The rest is as the delta this session resumed from left it
+    const WorldImage& image = source->getImage();
+    auto reached = [&](uint32_t container) {
+        uint32_t index = container & WorldDelta::INDEX_MASK;
+        switch (container & WorldDelta::KIND_MASK) {
+        case WorldDelta::ROOM:
+            return arena.wasBuilt(index);
+        case WorldDelta::ITEM:
+            return arena.wasBuilt(ItemSlot(image, index));
+        case WorldDelta::CREATED:
+            return static_cast<bool>(builtCreated[index]);
+        default:
+            return true;    // The inventory was built with the player
+        }
+    };
+
+    std::unordered_map<uint32_t, uint32_t> carried;
+    for (const WorldDelta::Contents& entry : base.contents) {
+        if (reached(entry.container)) {
+            continue;
+        }
+
+        WorldDelta::Contents kept{ walker.Carry(entry.container, base, carried), {} };
+        kept.entities.reserve(entry.entities.size());
+        for (uint32_t entity : entry.entities) {
+            kept.entities.push_back(walker.Carry(entity, base, carried));
+        }
+        delta.contents.push_back(std::move(kept));
+    }
+    for (uint32_t item : base.litItems) {
+        if (!arena.wasBuilt(ItemSlot(image, item))) {
+            delta.litItems.push_back(item);
+        }
+    }
+    for (const WorldDelta::NpcChange& change : base.npcs) {
+        if (!arena.wasBuilt(NpcSlot(image, change.npc))) {
+            delta.npcs.push_back(change);
+        }
+    }
+    delta.created = std::move(walker.created);
 }
 
-Room* World::CreateRoomsAndExits() {
-    return village;
-}
\ No newline at end of file
+Player* World::ApplyDelta(WorldDelta delta, const string& name, const string& description) {
+    base = std::move(delta);
+
+    // Indexed for the rooms built from now on
+    for (const WorldDelta::Contents& entry : base.contents) {
+        baseContents.emplace(entry.container, &entry.entities);
+        if ((entry.container & WorldDelta::KIND_MASK) != WorldDelta::ROOM) {
+            continue;
+        }
+        for (uint32_t entity : entry.entities) {
+            if ((entity & WorldDelta::KIND_MASK) == WorldDelta::NPC) {
+                baseNpcRooms.emplace(entity & WorldDelta::INDEX_MASK, entry.container & WorldDelta::INDEX_MASK);
+            }
+        }
+    }
+    for (const WorldDelta::NpcChange& change : base.npcs) {
+        baseStates.emplace(change.npc, &change.state);
+    }
+    baseLit.insert(base.litItems.begin(), base.litItems.end());
+    builtCreated.assign(base.created.size(), false);
+    for (uint32_t exit : base.unlockedExits) {
+        graphChanges.onUnlocked(static_cast<int>(exit));
+    }
+    for (uint32_t room : base.toggledRooms) {
+        graphChanges.onDarknessChanged(static_cast<int>(room), !source->getGraph().startsDark(static_cast<int>(room)));
+    }
+    scheduler.reset(base.turn);
+
+    // The player's room places the player among its entities as it is built
+    player = arena.create<Player>(name, description, nullptr);
+    player->setState(base.player);
+    Room* room = GetRoom(static_cast<int>(base.playerRoom));
+    if (player->getLocation() == nullptr) {
+        player->setLocation(room);
+    }
+    auto inventory = baseContents.find(WorldDelta::PLAYER);
+    if (inventory != baseContents.end()) {
+        for (uint32_t item : *inventory->second) {
+            player->addItem(BuildItem(item));
+        }
+    }
+    if (base.player.promptNpc != Entity::NO_RECORD) {
+        player->ask(base.player.prompt, NpcByRecord(base.player.promptNpc), base.player.promptNode);
+    }
+
+    // NPCs due to act are scheduled again, which builds their rooms
+    for (const WorldDelta::NpcChange& change : base.npcs) {
+        if (change.state.nextUpdate == 0) {
+            continue;
+        }
+        NPC* npc = NpcByRecord(change.npc);
+        if (npc != nullptr) {
+            scheduler.schedule(npc->getHandle(), change.state.nextUpdate);
+        }
+    }
+    return player;
+}
@@ -1,14 +1,142 @@
 #pragma once
+#include "DialogueGraph.h"
+#include "EntityArena.h"
 #include "Room.h"
+#include "RoutePlanner.h"
+#include "TickScheduler.h"
+#include "WorldDelta.h"
+#include "WorldGraph.h"
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
-class World {
+class Item;
+class NPC;
+class Player;
+class WorldImage;
+class WorldImageWriter;
+class WorldTemplate;
+
+/**
+ * The rooms, exits, items and NPCs of one game, all in the world's arena.
+ * InitializeWorld() and LoadWorld() build every entity at once, for
+ * exporting a world. A session's world is Instantiate()d from a shared
+ * WorldTemplate instead and built as play reaches it: every room record
+ * has a placeholder slot from the start, and the first time a room's
+ * handle is resolved (the player walks in, an exit or patrol leads there)
+ * the room is built from its record together with its exits, items and
+ * NPCs. Rooms nobody reached stay in the template, so starting or resuming
+ * a session costs the rooms around the player, not the size of the world.
+ * NPCs and template items have placeholder slots too, filled as their
+ * rooms are built, so each keeps the slot of its record.
+ */
+class World : private EntityArena::Builder {
 public:
+    World();
+    ~World();
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
     // Initializes all game locations and connections
-    static void InitializeWorld();
+    void InitializeWorld();
+
+    // Builds the world from a compiled image instead; descriptions and
+    // dialogue are borrowed from the image, which must outlive the world.
+    // The dialogue graph is read from the image unless one already read
+    // from it is given to share
+    void LoadWorld(const WorldImage& image, std::shared_ptr<const DialogueGraph> conversations = nullptr);
+
+    // Starts a session world on a shared template, building nothing yet;
+    // rooms borrow the template's text, and the world keeps the template
+    // alive and measures deltas against it
+    void Instantiate(std::shared_ptr<const WorldTemplate> source);
+
+    // Records the rooms, exits, items and NPCs of a world built whole as
+    // image records
+    void SaveWorld(WorldImageWriter& writer) const;
+
+    // Records what play has changed since Instantiate(), player included;
+    // rooms never built keep what the delta they were resumed from said
+    void CaptureDelta(const Player& player, WorldDelta& delta) const;
+
+    // Resumes a freshly instantiated world from a captured delta: creates
+    // the player where the delta left them and builds the rooms it needs
+    // at once (the player's, and those of NPCs due to act). Every other room
+    // takes its part of the delta when it is built
+    Player* ApplyDelta(WorldDelta delta, const string& name, const string& description);
+
+    // Ends every room, exit, item and NPC at once; the arena keeps its memory
+    // for the next world built here
+    void Clear();
+
+    // Clear() and frees the arena's memory as well
+    void Release();
+
+    // Creates the player in the starting room; the world owns it like any other entity
+    Player* CreatePlayer(const string& name, const string& description);
 
     // Gets the player's starting location
-    static Room* GetStartingRoom();
+    Room* GetStartingRoom();
+
+    // Room by graph index (its record), built if play had not reached it
+    Room* GetRoom(int index);
+
+    // Room graph of the template a session plays
+    const WorldGraph& GetGraph() const { return graphChanges.getGraph(); }
+
+    // Cached shortest routes over that graph
+    RoutePlanner& GetRoutes() { return routes; }
+
+    // Turns a room dark or light, keeping the routes in step
+    void SetDark(Room* room, bool dark);
+
+    // Runs the updates due up to 'turn'. Only NPCs in the player's room
+    // and the rooms next to it act; one due anywhere else falls asleep, and
+    // the NPCs around a room are woken when the player comes into it, so a
+    // turn costs what is scheduled near the player, not the size of the world
+    void UpdateEntities(uint32_t turn, const Player& player);
 
 private:
-    static Room* CreateRoomsAndExits();
-};
\ No newline at end of file
+    std::shared_ptr<const WorldTemplate> source;    // Template this world was instantiated from
+    std::shared_ptr<const DialogueGraph> dialogue;  // Conversations the NPCs point into
+    EntityArena arena;  // Owns every room, exit, item and NPC
+    Room* startRoom;            // nullptr in a session until it is built
+    std::vector<Room*> rooms;   // Every room of a world built whole, in graph order
+    Player* player;
+    GraphChanges graphChanges;  // Exits and darkness play changed on the template's graph
+    RoutePlanner routes;
+    TickScheduler scheduler;    // Next update of every awake NPC
+    const Room* observed;       // Player's room at the last update, nullptr before the first
+
+    // What a session resumed from, handed to rooms as they are built
+    WorldDelta base;
+    std::unordered_map<uint32_t, const std::vector<uint32_t>*> baseContents;  // By container reference
+    std::unordered_map<uint32_t, const NPC::State*> baseStates;              // By NPC record
+    std::unordered_map<uint32_t, uint32_t> baseNpcRooms;  // Room of each NPC the delta moved, by record
+    std::unordered_set<uint32_t> baseLit;                 // Template items lit, by record
+
+    std::vector<bool> builtCreated;     // Items of base.created built so far
+    std::vector<uint32_t> builtRooms;   // Records, in the order they were built
+
+    // Schedules the sleeping NPCs that have a behavior in 'center' and the rooms next to it
+    void WakeAround(const Room* center, uint32_t turn);
+    static bool IsNear(const Room* room, const Room* center);
+
+    // Entities of the image records, rooms going into their placeholder slots
+    Room* LoadRoom(const WorldImage& image, uint32_t record);
+    Item* LoadItem(const WorldImage& image, uint32_t record);
+    NPC* LoadNpc(const WorldImage& image, uint32_t record, Room* room);
+
+    // Builds a session room with its exits and contents (EntityArena::Builder)
+    Entity* build(uint32_t room) override;
+
+    // Builds a session item with its contents, or puts what a room or item
+    // holds into it, by delta reference
+    Item* BuildItem(uint32_t reference);
+    void BuildContents(Entity* container, uint32_t reference);
+
+    // A template NPC of a session, building its room; nullptr if destroyed
+    NPC* NpcByRecord(uint32_t record);
+};
@@ -0,0 +1,14 @@
+#include "WorldDelta.h"
+
+size_t WorldDelta::getByteSize() const {
+    size_t bytes = sizeof(WorldDelta)
+        + (unlockedExits.capacity() + toggledRooms.capacity() + litItems.capacity()) * sizeof(uint32_t)
+        + npcs.capacity() * sizeof(NpcChange)
+        + created.capacity() * sizeof(CreatedItem)
+        + contents.capacity() * sizeof(Contents);
+
+    for (const Contents& entry : contents) {
+        bytes += entry.entities.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "NPC.h"
+#include "Player.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * What one session has changed in the world template it plays.
+ * Everything else (room and item text, dialogue, exits, the starting
+ * placement of every item and NPC) stays in the shared template, so the
+ * delta for a session of the stock world is a few hundred bytes.
+ *
+ * Entities and containers are referred to by a kind in the top three bits
+ * and an index below: the template record for rooms, items and NPCs, the
+ * position in 'created' for items made during play. A template item or NPC
+ * that is in none of the listed contents and not left where the template
+ * put it has been destroyed.
+ */
+struct WorldDelta {
+    static constexpr uint32_t ROOM = 0u << 29;
+    static constexpr uint32_t ITEM = 1u << 29;
+    static constexpr uint32_t NPC = 2u << 29;
+    static constexpr uint32_t CREATED = 3u << 29;
+    static constexpr uint32_t PLAYER = 4u << 29;   // The player, or as a container its inventory
+    static constexpr uint32_t KIND_MASK = 7u << 29;
+    static constexpr uint32_t INDEX_MASK = ~KIND_MASK;
+
+    // A container whose entities differ from the template, in their order
+    struct Contents {
+        uint32_t container;
+        std::vector<uint32_t> entities;
+    };
+
+    struct NpcChange {
+        uint32_t npc;
+        ::NPC::State state;
+    };
+
+    // An item that did not exist in the template (rewards, loot, corrupted
+    // artifacts): the ItemPrototype it was made from, which holds its text
+    struct CreatedItem {
+        uint32_t prototype;
+        bool lit;
+    };
+
+    uint32_t turn = 0;          // Last turn the NPCs were updated for; NPC states hold their next turns
+    uint32_t playerRoom = 0;
+    Player::State player{};
+    std::vector<uint32_t> unlockedExits;    // Exit records unlocked in play
+    std::vector<uint32_t> toggledRooms;     // Rooms whose darkness flipped
+    std::vector<uint32_t> litItems;         // Template items that are lit
+    std::vector<NpcChange> npcs;
+    std::vector<CreatedItem> created;
+    std::vector<Contents> contents;
+
+    // Memory held by the delta, including its heap blocks
+    size_t getByteSize() const;
+};
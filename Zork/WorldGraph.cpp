@@ -0,0 +1,155 @@
+#include "WorldGraph.h"
+#include "WorldImage.h"
+#include <algorithm>
+
+void WorldGraph::Build(const WorldImage& image, NameTable& nameTable) {
+    using namespace WorldFormat;
+
+    size_t roomCount = image.getRoomCount();
+    darkRooms.resize(roomCount);
+    offsets.reserve(roomCount + 1);
+    edges.reserve(image.getExitCount());
+    names = &nameTable;
+
+    for (size_t r = 0; r < roomCount; r++) {
+        const RoomRecord& room = image.getRoom(r);
+        darkRooms[r] = (room.flags & ROOM_DARK) != 0;
+        roomsByName.emplace(nameTable.intern(image.getString(room.name)), static_cast<int>(r));
+    }
+
+    // The image keeps each room's exits together in Direction order, which
+    // it checks on loading, so exit records are edge indices
+    for (size_t r = 0; r < roomCount; r++) {
+        const RoomRecord& room = image.getRoom(r);
+        offsets.push_back(static_cast<int>(edges.size()));
+        for (uint32_t e = room.firstExit; e < room.firstExit + room.exitCount; e++) {
+            const ExitRecord& exit = image.getExit(e);
+            std::string_view key = image.getString(exit.key);
+
+            Edge edge;
+            edge.source = static_cast<int>(r);
+            edge.destination = static_cast<int>(exit.destination);
+            edge.direction = static_cast<Direction>(exit.direction);
+            edge.locked = (exit.flags & EXIT_LOCKED) != 0;
+            edge.key = key.empty() ? std::string_view() : nameTable.intern(key);
+            edge.keyBit = AssignKeyBit(edge.key);
+            edges.push_back(edge);
+        }
+    }
+    offsets.push_back(static_cast<int>(edges.size()));
+
+    incomingOffsets.resize(roomCount + 1);
+    incoming.resize(edges.size());
+    int next = 0;
+    for (size_t r = 0; r < roomCount; r++) {
+        const RoomRecord& record = image.getRoom(r);
+        incomingOffsets[r] = next;
+        for (uint32_t i = record.firstIncoming; i < record.firstIncoming + record.incomingCount; i++) {
+            incoming[next++] = static_cast<int>(image.getIncoming(i));
+        }
+    }
+    incomingOffsets[roomCount] = next;
+}
+
+uint64_t WorldGraph::AssignKeyBit(std::string_view key) {
+    if (key.empty()) {
+        return 0;
+    }
+
+    auto existing = keyBits.find(key);
+    if (existing != keyBits.end()) {
+        return existing->second;
+    }
+
+    // Keys past the 64th stay unknown, their exits count as plainly locked
+    uint64_t bit = keyBits.size() < 64 ? uint64_t(1) << keyBits.size() : 0;
+    keyBits.emplace(key, bit);
+    return bit;
+}
+
+// ========== Queries ==========
+
+int WorldGraph::findRoom(std::string_view name) const {
+    if (name.empty()) {
+        return -1;
+    }
+
+    thread_local std::string buffer;
+    std::string_view lowerName = NameTable::Lowercase(name, buffer);
+    auto exact = roomsByName.find(lowerName);
+    if (exact != roomsByName.end()) {
+        return exact->second;
+    }
+
+    // Names come shortest first and in room order on ties; other names are skipped
+    thread_local std::vector<std::string_view> candidates;
+    names->findNamesContaining(lowerName, candidates);
+    for (std::string_view candidate : candidates) {
+        auto room = roomsByName.find(candidate);
+        if (room != roomsByName.end()) {
+            return room->second;
+        }
+    }
+    return -1;
+}
+
+uint64_t WorldGraph::keyBitFor(std::string_view lowerKey) const {
+    auto bit = keyBits.find(lowerKey);
+    return bit != keyBits.end() ? bit->second : 0;
+}
+
+// ========== Session Changes ==========
+
+void GraphChanges::attach(const WorldGraph* worldGraph) {
+    graph = worldGraph;
+    unlocked.clear();
+    toggledRooms.clear();
+    for (Listener* listener : listeners) {
+        listener->onGraphRebuilt();
+    }
+}
+
+void GraphChanges::onUnlocked(int edge) {
+    if (!isLocked(edge)) {
+        return;
+    }
+
+    unlocked.insert(edge);
+    for (Listener* listener : listeners) {
+        listener->onEdgeUnlocked(edge);
+    }
+}
+
+void GraphChanges::onDarknessChanged(int room, bool dark) {
+    if (dark != graph->startsDark(room)) {
+        toggledRooms.insert(room);
+    }
+    else {
+        toggledRooms.erase(room);
+    }
+    for (Listener* listener : listeners) {
+        listener->onDarknessChanged(room);
+    }
+}
+
+std::vector<uint32_t> GraphChanges::getUnlockedEdges() const {
+    std::vector<uint32_t> edges(unlocked.begin(), unlocked.end());
+    std::sort(edges.begin(), edges.end());
+    return edges;
+}
+
+std::vector<uint32_t> GraphChanges::getToggledRooms() const {
+    std::vector<uint32_t> rooms(toggledRooms.begin(), toggledRooms.end());
+    std::sort(rooms.begin(), rooms.end());
+    return rooms;
+}
+
+// ========== Listeners ==========
+
+void GraphChanges::addListener(Listener* listener) {
+    listeners.push_back(listener);
+}
+
+void GraphChanges::removeListener(Listener* listener) {
+    listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+}
@@ -0,0 +1,157 @@
+#pragma once
+#include "GameEnums.h"
+#include "NameTable.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class WorldImage;
+
+/**
+ * Room graph of a world image, compiled once per WorldTemplate and shared
+ * by every session playing it; nothing in it changes afterwards.
+ * Rooms are numbered by their record and the exits of room r are stored
+ * contiguously (compressed sparse rows): edges [offsets[r], offsets[r + 1])
+ * in Direction order, so an edge's index is its exit record. Walking the
+ * graph touches two flat arrays and never allocates. The same edges are
+ * also listed by destination room, for searches that walk exits backwards.
+ *
+ * Up to 64 distinct lock keys get a bit each, so a set of keys is a mask.
+ * What a session has unlocked or darkened is kept by its GraphChanges.
+ */
+class WorldGraph {
+public:
+    struct Edge {
+        int source;             // Room index
+        int destination;        // Room index
+        Direction direction;
+        bool locked;            // Locked when the world starts
+        std::string_view key;   // Lowercase key name, empty if none
+        uint64_t keyBit;        // Bit of that key, 0 if none or past the 64th key
+    };
+
+    struct EdgeIndexRange {
+        const int* first;
+        const int* last;
+        const int* begin() const { return first; }
+        const int* end() const { return last; }
+    };
+
+    struct EdgeRange {
+        const Edge* first;
+        const Edge* last;
+        const Edge* begin() const { return first; }
+        const Edge* end() const { return last; }
+    };
+
+    WorldGraph() = default;
+
+    WorldGraph(const WorldGraph&) = delete;
+    WorldGraph& operator=(const WorldGraph&) = delete;
+
+    // Compiles the rooms and exits of 'image', taking the exits-by-destination
+    // lists precomputed by the world compiler; room names and keys are
+    // interned in 'names', which must outlive the graph
+    void Build(const WorldImage& image, NameTable& names);
+
+    int getRoomCount() const { return static_cast<int>(darkRooms.size()); }
+    int getEdgeCount() const { return static_cast<int>(edges.size()); }
+    const Edge& getEdge(int index) const { return edges[index]; }
+
+    // Whether a room is dark when the world starts
+    bool startsDark(int room) const { return darkRooms[room]; }
+
+    // Exits leaving a room, in Direction order
+    EdgeRange edgesFrom(int room) const {
+        return { edges.data() + offsets[room], edges.data() + offsets[room + 1] };
+    }
+    int firstEdge(int room) const { return offsets[room]; }
+
+    // Indices of the edges arriving at a room
+    EdgeIndexRange edgesInto(int room) const {
+        return { incoming.data() + incomingOffsets[room], incoming.data() + incomingOffsets[room + 1] };
+    }
+
+    // Room by exact or partial name (case-insensitive) as NameIndex::find()
+    // resolves it, -1 if none
+    int findRoom(std::string_view name) const;
+
+    // Bit of a lock key (lowercase name), 0 if no exit uses it
+    uint64_t keyBitFor(std::string_view lowerKey) const;
+
+private:
+    std::vector<int> offsets;   // Room count + 1 entries
+    std::vector<Edge> edges;
+    std::vector<int> incomingOffsets;   // Room count + 1 entries
+    std::vector<int> incoming;          // Edge indices grouped by destination
+    std::vector<bool> darkRooms;
+
+    const NameTable* names = nullptr;   // Holding the room names and lock keys
+    std::unordered_map<std::string_view, int> roomsByName;   // First room with each name
+    std::unordered_map<std::string_view, uint64_t> keyBits;
+
+    uint64_t AssignKeyBit(std::string_view key);
+};
+
+/**
+ * What one session has changed on the shared WorldGraph: the locked exits
+ * it opened and the rooms whose darkness differs from the start. Both are
+ * sets of the few edges and rooms play touched, so a session starts
+ * without copying the graph. Exits built by the session report their
+ * unlocks here and the World reports darkness; listeners hear of both.
+ */
+class GraphChanges {
+public:
+    // Told when the graph changes shape
+    class Listener {
+    public:
+        virtual ~Listener() = default;
+        virtual void onEdgeUnlocked(int edge) = 0;
+        virtual void onDarknessChanged(int room) = 0;
+        virtual void onGraphRebuilt() = 0;
+    };
+
+    GraphChanges() = default;
+
+    GraphChanges(const GraphChanges&) = delete;
+    GraphChanges& operator=(const GraphChanges&) = delete;
+
+    // Starts over on 'graph' with nothing changed (nullptr for none)
+    void attach(const WorldGraph* worldGraph);
+
+    const WorldGraph& getGraph() const { return *graph; }
+    bool isAttached() const { return graph != nullptr; }
+
+    bool isUnlocked(int edge) const { return unlocked.count(edge) != 0; }
+    bool isLocked(int edge) const { return graph->getEdge(edge).locked && !isUnlocked(edge); }
+
+    // Whether a holder of 'keys' can go along an edge
+    bool isPassable(int edge, uint64_t keys) const {
+        const WorldGraph::Edge& compiled = graph->getEdge(edge);
+        return !compiled.locked || (compiled.keyBit & keys) != 0 || isUnlocked(edge);
+    }
+
+    bool isDark(int room) const { return graph->startsDark(room) != (toggledRooms.count(room) != 0); }
+
+    // Called by an attached Exit when it is unlocked
+    void onUnlocked(int edge);
+
+    // A room turned dark or light
+    void onDarknessChanged(int room, bool dark);
+
+    // Unlocked edges and rooms of changed darkness, ascending
+    std::vector<uint32_t> getUnlockedEdges() const;
+    std::vector<uint32_t> getToggledRooms() const;
+
+    void addListener(Listener* listener);
+    void removeListener(Listener* listener);
+
+private:
+    const WorldGraph* graph = nullptr;
+    std::unordered_set<int> unlocked;
+    std::unordered_set<int> toggledRooms;
+    std::vector<Listener*> listeners;
+};
@@ -0,0 +1,266 @@
+#include "WorldImage.h"
+#include "EntityHandle.h"
+#include "GameEnums.h"
+#include <cstring>
+
+using namespace WorldFormat;
+
+namespace {
+
+    // Every room, exit, item and NPC takes an entity handle; the rest are
+    // left for the player and the items made in play
+    constexpr uint64_t MAX_ENTITIES = EntityHandle::MAX_INDEX - (1u << 16);
+
+    bool SectionFits(const Section& section, size_t recordSize, size_t fileSize) {
+        if (section.offset % 8 != 0 || section.offset > fileSize) {
+            return false;
+        }
+        return section.count <= (fileSize - section.offset) / recordSize;
+    }
+
+    bool RangeFits(uint32_t first, uint32_t count, uint64_t total) {
+        return static_cast<uint64_t>(first) + count <= total;
+    }
+}
+
+WorldImage::WorldImage() :
+    data(nullptr),
+    size(0),
+    header(nullptr),
+    strings(nullptr) {
+}
+
+bool WorldImage::Open(const std::string& path, std::string& error) {
+    buffer.clear();
+    if (!file.Open(path)) {
+        header = nullptr;
+        strings = nullptr;
+        error = "cannot open " + path;
+        return false;
+    }
+    return Attach(file.getData(), file.getSize(), path, error);
+}
+
+bool WorldImage::Load(std::string_view bytes, const std::string& name, std::string& error) {
+    // Copied into 64-bit words so the records are aligned as in a mapping
+    buffer.assign((bytes.size() + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+    if (!bytes.empty()) {
+        std::memcpy(buffer.data(), bytes.data(), bytes.size());
+    }
+    return Attach(reinterpret_cast<const char*>(buffer.data()), bytes.size(), name, error);
+}
+
+bool WorldImage::Attach(const char* bytes, size_t byteCount, const std::string& name, std::string& error) {
+    header = nullptr;
+    strings = nullptr;
+    data = bytes;
+    size = byteCount;
+
+    if (size < sizeof(Header)) {
+        error = name + " is too small to be a world image";
+        return false;
+    }
+
+    const Header* candidate = reinterpret_cast<const Header*>(data);
+    if (std::memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) != 0) {
+        error = name + " is not a world image";
+        return false;
+    }
+    if (candidate->version != VERSION) {
+        error = name + " has world format version " + std::to_string(candidate->version)
+            + ", expected " + std::to_string(VERSION);
+        return false;
+    }
+
+    header = candidate;
+    strings = data + header->strings.offset;
+    if (!Validate(error)) {
+        error = name + ": " + error;
+        header = nullptr;
+        strings = nullptr;
+        return false;
+    }
+    return true;
+}
+
+// ========== Validation ==========
+
+bool WorldImage::Validate(std::string& error) const {
+    // Every section must lie inside the file before any record is read
+    if (!SectionFits(header->strings, 1, size) ||
+        !SectionFits(header->rooms, sizeof(RoomRecord), size) ||
+        !SectionFits(header->exits, sizeof(ExitRecord), size) ||
+        !SectionFits(header->items, sizeof(ItemRecord), size) ||
+        !SectionFits(header->npcs, sizeof(NpcRecord), size) ||
+        !SectionFits(header->dialogues, sizeof(StringRef), size) ||
+        !SectionFits(header->responses, sizeof(ResponseRecord), size) ||
+        !SectionFits(header->incoming, sizeof(uint32_t), size) ||
+        !SectionFits(header->dialogueNodes, sizeof(DialogueNodeRecord), size) ||
+        !SectionFits(header->dialogueEffects, sizeof(DialogueEffectRecord), size) ||
+        !SectionFits(header->dialogueEdges, sizeof(DialogueEdgeRecord), size) ||
+        !SectionFits(header->patrolStops, sizeof(uint32_t), size)) {
+        error = "section outside the file";
+        return false;
+    }
+
+    uint64_t stringBytes = header->strings.count;
+    auto validString = [stringBytes](StringRef text) {
+        return RangeFits(text.offset, text.length, stringBytes);
+    };
+
+    uint64_t roomCount = header->rooms.count;
+    if (roomCount == 0 || header->startRoom >= roomCount) {
+        error = "missing starting room";
+        return false;
+    }
+    if (roomCount + header->exits.count + header->items.count + header->npcs.count > MAX_ENTITIES) {
+        error = "too many rooms, exits, items and NPCs for one world";
+        return false;
+    }
+
+    // Rooms list their exits back to back, so exit indices are graph edge indices
+    uint64_t nextExit = 0;
+    for (uint64_t i = 0; i < roomCount; i++) {
+        const RoomRecord& room = getRoom(static_cast<size_t>(i));
+        if (!validString(room.name) || !validString(room.description)) {
+            error = "room " + std::to_string(i) + " has text outside the string table";
+            return false;
+        }
+        if (!RangeFits(room.firstExit, room.exitCount, header->exits.count) ||
+            !RangeFits(room.firstIncoming, room.incomingCount, header->incoming.count) ||
+            (room.exitCount > 0 && room.firstExit != nextExit)) {
+            error = "room " + std::to_string(i) + " has exits outside the exit table";
+            return false;
+        }
+        nextExit += room.exitCount;
+
+        // One exit per direction in Direction order, as Room and WorldGraph keep them
+        int lastDirection = -1;
+        for (uint32_t e = room.firstExit; e < room.firstExit + room.exitCount; e++) {
+            const ExitRecord& exit = getExit(e);
+            if (exit.direction >= static_cast<uint32_t>(DIRECTION_COUNT) || static_cast<int>(exit.direction) <= lastDirection) {
+                error = "room " + std::to_string(i) + " has a bad or repeated exit direction";
+                return false;
+            }
+            lastDirection = static_cast<int>(exit.direction);
+        }
+    }
+
+    if (nextExit != header->exits.count || header->incoming.count != header->exits.count) {
+        error = "exit lists do not cover every exit";
+        return false;
+    }
+
+    for (uint64_t i = 0; i < header->exits.count; i++) {
+        const ExitRecord& exit = getExit(static_cast<size_t>(i));
+        if (!validString(exit.name) || !validString(exit.description) || !validString(exit.key)) {
+            error = "exit " + std::to_string(i) + " has text outside the string table";
+            return false;
+        }
+        if (exit.destination >= roomCount) {
+            error = "exit " + std::to_string(i) + " leads to a missing room";
+            return false;
+        }
+    }
+
+    // Incoming lists are used as stored, each entry must arrive at its room
+    for (uint64_t i = 0; i < roomCount; i++) {
+        const RoomRecord& room = getRoom(static_cast<size_t>(i));
+        for (uint32_t n = room.firstIncoming; n < room.firstIncoming + room.incomingCount; n++) {
+            uint32_t exit = getIncoming(n);
+            if (exit >= header->exits.count || getExit(exit).destination != i) {
+                error = "room " + std::to_string(i) + " has a wrong incoming exit list";
+                return false;
+            }
+        }
+    }
+
+    for (uint64_t i = 0; i < header->items.count; i++) {
+        const ItemRecord& item = getItem(static_cast<size_t>(i));
+        if (!validString(item.name) || !validString(item.description)) {
+            error = "item " + std::to_string(i) + " has text outside the string table";
+            return false;
+        }
+
+        // Exactly one place to start in; containers come first so they exist when loading
+        bool inRoom = item.room != NONE;
+        bool inContainer = item.container != NONE;
+        if (inRoom == inContainer ||
+            (inRoom && item.room >= roomCount) ||
+            (inContainer && item.container >= i)) {
+            error = "item " + std::to_string(i) + " has no valid location";
+            return false;
+        }
+    }
+
+    for (uint64_t i = 0; i < header->dialogues.count; i++) {
+        if (!validString(getDialogue(static_cast<size_t>(i)))) {
+            error = "dialogue line " + std::to_string(i) + " is outside the string table";
+            return false;
+        }
+    }
+
+    for (uint64_t i = 0; i < header->responses.count; i++) {
+        const ResponseRecord& response = getResponse(static_cast<size_t>(i));
+        if (!validString(response.input) || !validString(response.response)) {
+            error = "response " + std::to_string(i) + " is outside the string table";
+            return false;
+        }
+    }
+
+    for (uint64_t i = 0; i < header->patrolStops.count; i++) {
+        if (getPatrolStop(static_cast<size_t>(i)) >= roomCount) {
+            error = "patrol stop " + std::to_string(i) + " refers to a missing room";
+            return false;
+        }
+    }
+
+    uint64_t nodeCount = header->dialogueNodes.count;
+    for (uint64_t i = 0; i < nodeCount; i++) {
+        const DialogueNodeRecord& node = getDialogueNode(static_cast<size_t>(i));
+        if (!validString(node.question) ||
+            !RangeFits(node.firstEffect, node.effectCount, header->dialogueEffects.count) ||
+            !RangeFits(node.firstEdge, node.edgeCount, header->dialogueEdges.count)) {
+            error = "dialogue node " + std::to_string(i) + " refers to missing records";
+            return false;
+        }
+    }
+
+    for (uint64_t i = 0; i < header->dialogueEffects.count; i++) {
+        const DialogueEffectRecord& effect = getDialogueEffect(static_cast<size_t>(i));
+        if (effect.action >= static_cast<uint32_t>(DIALOGUE_ACTION_COUNT) ||
+            !validString(effect.subject) || !validString(effect.text)) {
+            error = "dialogue effect " + std::to_string(i) + " is not valid";
+            return false;
+        }
+    }
+
+    for (uint64_t i = 0; i < header->dialogueEdges.count; i++) {
+        const DialogueEdgeRecord& edge = getDialogueEdge(static_cast<size_t>(i));
+        if (edge.condition >= static_cast<uint32_t>(DIALOGUE_CONDITION_COUNT) || edge.target >= nodeCount ||
+            !validString(edge.answer) || !validString(edge.subject)) {
+            error = "dialogue edge " + std::to_string(i) + " is not valid";
+            return false;
+        }
+    }
+
+    for (uint64_t i = 0; i < header->npcs.count; i++) {
+        const NpcRecord& npc = getNpc(static_cast<size_t>(i));
+        if (!validString(npc.name) || !validString(npc.description) ||
+            !validString(npc.requiredItem) || !validString(npc.rewardItem) ||
+            !validString(npc.rewardDescription) || !validString(npc.announcement)) {
+            error = "NPC " + std::to_string(i) + " has text outside the string table";
+            return false;
+        }
+        if (npc.room >= roomCount || (npc.dialogueRoot != NONE && npc.dialogueRoot >= nodeCount) ||
+            !RangeFits(npc.firstDialogue, npc.dialogueCount, header->dialogues.count) ||
+            !RangeFits(npc.firstResponse, npc.responseCount, header->responses.count) ||
+            !RangeFits(npc.firstPatrolStop, npc.patrolStopCount, header->patrolStops.count) ||
+            npc.behavior >= static_cast<uint32_t>(NPC_BEHAVIOR_COUNT)) {
+            error = "NPC " + std::to_string(i) + " refers to missing records";
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,240 @@
+#pragma once
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * On-disk layout of a compiled world.
+ * A header is followed by fixed-size record arrays and one string table.
+ * Records refer to text by (offset, length) into the string table and to
+ * each other by array index, so the file is used exactly as it lies in
+ * memory. Exits are stored grouped by source room in Direction order (the
+ * edge order of WorldGraph), items after the container they start in.
+ * Indexes the game would otherwise compute at startup are stored too: the
+ * exits arriving at each room and the number of distinct names.
+ * NPC conversations are one graph of dialogue nodes with their effects and
+ * edges; an NPC refers to the node it starts at, so NPCs may share nodes.
+ * NPCs own runs of dialogue lines, responses and patrol stops.
+ * Integers are little-endian; every section starts on an 8-byte boundary.
+ */
+namespace WorldFormat {
+    constexpr char MAGIC[4] = { 'Z', 'W', 'L', 'D' };
+    constexpr uint32_t VERSION = 6;
+    constexpr uint32_t NONE = 0xFFFFFFFFu;    // Missing record index
+
+    struct StringRef {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    // RoomRecord::flags
+    constexpr uint32_t ROOM_DARK = 1u << 0;
+
+    // ExitRecord::flags
+    constexpr uint32_t EXIT_LOCKED = 1u << 0;
+
+    // ItemRecord::flags
+    constexpr uint32_t ITEM_CONTAINER = 1u << 0;
+    constexpr uint32_t ITEM_FRAGMENT = 1u << 1;
+    constexpr uint32_t ITEM_FIXED = 1u << 2;
+
+    // NpcRecord::flags
+    constexpr uint32_t NPC_ENEMY = 1u << 0;
+    constexpr uint32_t NPC_IMPORTANT_INFO = 1u << 1;
+    constexpr uint32_t NPC_PREVENT_REINTERACTION = 1u << 2;
+
+    // DialogueNodeRecord::flags
+    constexpr uint32_t NODE_ASKS = 1u << 0;
+
+    struct Section {
+        uint64_t offset;    // From the start of the file
+        uint64_t count;     // Records (bytes for the string table)
+    };
+
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t startRoom;
+        uint32_t nameCount;     // Distinct lowercase entity names
+        Section strings;
+        Section rooms;
+        Section exits;
+        Section items;
+        Section npcs;
+        Section dialogues;  // StringRef per line, NPCs own consecutive runs
+        Section responses;
+        Section incoming;   // Exit indices grouped by destination room
+        Section dialogueNodes;
+        Section dialogueEffects;    // Nodes own consecutive runs, as do their edges
+        Section dialogueEdges;
+        Section patrolStops;    // Room indices
+    };
+
+    struct RoomRecord {
+        StringRef name;
+        StringRef description;
+        uint32_t firstExit;     // Exits [firstExit, firstExit + exitCount) leave this room
+        uint32_t exitCount;
+        uint32_t firstIncoming; // Entries [firstIncoming, firstIncoming + incomingCount) of the incoming section
+        uint32_t incomingCount;
+        uint32_t flags;
+    };
+
+    struct ExitRecord {
+        StringRef name;
+        StringRef description;
+        StringRef key;          // Empty unless locked
+        uint32_t destination;
+        uint32_t direction;     // Direction value
+        uint32_t flags;
+    };
+
+    struct ItemRecord {
+        StringRef name;
+        StringRef description;
+        uint32_t room;          // Room the item lies in, NONE when inside a container
+        uint32_t container;     // Earlier item holding this one, NONE when in a room
+        int32_t capacity;
+        uint32_t flags;
+    };
+
+    struct NpcRecord {
+        StringRef name;
+        StringRef description;
+        StringRef requiredItem;
+        StringRef rewardItem;
+        uint32_t room;
+        uint32_t firstDialogue;
+        uint32_t dialogueCount;
+        uint32_t firstResponse;
+        uint32_t responseCount;
+        uint32_t flags;
+        StringRef rewardDescription;    // Empty for the generic one
+        uint32_t dialogueRoot;  // First node of the NPC's conversation, NONE to just talk
+        uint32_t behavior;      // NpcBehavior value
+        uint32_t period;        // Turns between updates, 0 for none
+        uint32_t firstPatrolStop;
+        uint32_t patrolStopCount;
+        StringRef announcement;
+    };
+
+    struct ResponseRecord {
+        StringRef input;
+        StringRef response;
+    };
+
+    // A step of a conversation: its effects run in order, then it either asks
+    // (its edges are the answers) or follows the first edge whose condition holds
+    struct DialogueNodeRecord {
+        StringRef question;     // Printed without a line break before an asking node waits
+        uint32_t firstEffect;
+        uint32_t effectCount;
+        uint32_t firstEdge;
+        uint32_t edgeCount;
+        uint32_t flags;
+    };
+
+    struct DialogueEffectRecord {
+        uint32_t action;        // DialogueAction value
+        int32_t value;
+        StringRef subject;      // Item given or taken
+        StringRef text;         // Line said, or the description of an item given
+    };
+
+    struct DialogueEdgeRecord {
+        StringRef answer;       // Answer that takes the edge, empty for any
+        StringRef subject;      // Item the condition looks for
+        uint32_t condition;     // DialogueCondition value
+        int32_t value;          // Alignment the condition compares with
+        uint32_t target;        // Node index
+    };
+}
+
+/**
+ * Read-only view of a compiled world image.
+ * The file is memory-mapped and checked once on Open(); afterwards records
+ * and strings are read straight out of the mapping, so any number of worlds
+ * (and processes) built from the same image share one copy of its text.
+ * Text returned by getString() lives as long as the image.
+ */
+class WorldImage {
+private:
+    MappedFile file;
+    std::vector<uint64_t> buffer;   // Image bytes when loaded from memory
+    const char* data;
+    size_t size;
+    const WorldFormat::Header* header;
+    const char* strings;
+
+    template <typename Record>
+    const Record* SectionData(const WorldFormat::Section& section) const {
+        return reinterpret_cast<const Record*>(data + section.offset);
+    }
+
+    bool Attach(const char* bytes, size_t byteCount, const std::string& name, std::string& error);
+    bool Validate(std::string& error) const;
+
+public:
+    WorldImage();
+
+    WorldImage(const WorldImage&) = delete;
+    WorldImage& operator=(const WorldImage&) = delete;
+
+    // Maps and validates an image, 'error' says why when it returns false
+    bool Open(const std::string& path, std::string& error);
+
+    // Validates an image held in memory, keeping a private copy of it;
+    // 'name' stands in for the path in error messages
+    bool Load(std::string_view bytes, const std::string& name, std::string& error);
+
+    bool isOpen() const { return header != nullptr; }
+    uint32_t getStartRoom() const { return header->startRoom; }
+    uint32_t getNameCount() const { return header->nameCount; }
+
+    size_t getRoomCount() const { return static_cast<size_t>(header->rooms.count); }
+    size_t getExitCount() const { return static_cast<size_t>(header->exits.count); }
+    size_t getItemCount() const { return static_cast<size_t>(header->items.count); }
+    size_t getNpcCount() const { return static_cast<size_t>(header->npcs.count); }
+    size_t getDialogueNodeCount() const { return static_cast<size_t>(header->dialogueNodes.count); }
+
+    const WorldFormat::RoomRecord& getRoom(size_t index) const {
+        return SectionData<WorldFormat::RoomRecord>(header->rooms)[index];
+    }
+    const WorldFormat::ExitRecord& getExit(size_t index) const {
+        return SectionData<WorldFormat::ExitRecord>(header->exits)[index];
+    }
+    const WorldFormat::ItemRecord& getItem(size_t index) const {
+        return SectionData<WorldFormat::ItemRecord>(header->items)[index];
+    }
+    const WorldFormat::NpcRecord& getNpc(size_t index) const {
+        return SectionData<WorldFormat::NpcRecord>(header->npcs)[index];
+    }
+    WorldFormat::StringRef getDialogue(size_t index) const {
+        return SectionData<WorldFormat::StringRef>(header->dialogues)[index];
+    }
+    const WorldFormat::ResponseRecord& getResponse(size_t index) const {
+        return SectionData<WorldFormat::ResponseRecord>(header->responses)[index];
+    }
+    const WorldFormat::DialogueNodeRecord& getDialogueNode(size_t index) const {
+        return SectionData<WorldFormat::DialogueNodeRecord>(header->dialogueNodes)[index];
+    }
+    const WorldFormat::DialogueEffectRecord& getDialogueEffect(size_t index) const {
+        return SectionData<WorldFormat::DialogueEffectRecord>(header->dialogueEffects)[index];
+    }
+    const WorldFormat::DialogueEdgeRecord& getDialogueEdge(size_t index) const {
+        return SectionData<WorldFormat::DialogueEdgeRecord>(header->dialogueEdges)[index];
+    }
+    uint32_t getPatrolStop(size_t index) const {
+        return SectionData<uint32_t>(header->patrolStops)[index];
+    }
+    uint32_t getIncoming(size_t index) const {
+        return SectionData<uint32_t>(header->incoming)[index];
+    }
+
+    std::string_view getString(WorldFormat::StringRef text) const {
+        return std::string_view(strings + text.offset, text.length);
+    }
+};
@@ -0,0 +1,326 @@
+#include "WorldImageWriter.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+
+using namespace WorldFormat;
+
+namespace {
+
+    uint64_t AlignUp(uint64_t offset) {
+        return (offset + 7) & ~uint64_t(7);
+    }
+
+    template <typename Record>
+    void WriteRecords(std::ostream& out, uint64_t& position, Section& section, const std::vector<Record>& records) {
+        static const char padding[8] = {};
+        uint64_t aligned = AlignUp(position);
+        out.write(padding, static_cast<std::streamsize>(aligned - position));
+
+        section.offset = aligned;
+        section.count = records.size();
+        if (!records.empty()) {
+            out.write(reinterpret_cast<const char*>(records.data()),
+                static_cast<std::streamsize>(records.size() * sizeof(Record)));
+        }
+        position = aligned + records.size() * sizeof(Record);
+    }
+}
+
+WorldImageWriter::WorldImageWriter() :
+    stringBytesAdded(0),
+    startRoom(0) {
+}
+
+StringRef WorldImageWriter::AddString(std::string_view text) {
+    stringBytesAdded += text.size();
+
+    std::string key(text);
+    auto found = stringRefs.find(key);
+    if (found != stringRefs.end()) {
+        return found->second;
+    }
+
+    StringRef ref{ static_cast<uint32_t>(stringTable.size()), static_cast<uint32_t>(text.size()) };
+    stringTable.append(text.data(), text.size());
+    stringRefs.emplace(std::move(key), ref);
+    return ref;
+}
+
+StringRef WorldImageWriter::AddName(std::string_view name) {
+    std::string lower(name);
+    for (char& c : lower) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c + ('a' - 'A'));
+        }
+    }
+    lowerNames.insert(std::move(lower));
+    return AddString(name);
+}
+
+// ========== Records ==========
+
+uint32_t WorldImageWriter::addRoom(std::string_view name, std::string_view description, bool isDark) {
+    RoomRecord room{};
+    room.name = AddName(name);
+    room.description = AddString(description);
+    room.flags = isDark ? ROOM_DARK : 0;
+    rooms.push_back(room);
+    return static_cast<uint32_t>(rooms.size() - 1);
+}
+
+uint32_t WorldImageWriter::addExit(uint32_t source, uint32_t destination, Direction direction,
+    std::string_view name, std::string_view description, std::string_view keyName) {
+    PendingExit exit{};
+    exit.source = source;
+    exit.record.name = AddName(name);
+    exit.record.description = AddString(description);
+    exit.record.key = AddString(keyName);
+    exit.record.destination = destination;
+    exit.record.direction = static_cast<uint32_t>(direction);
+    exit.record.flags = keyName.empty() ? 0 : EXIT_LOCKED;
+    exits.push_back(exit);
+    return static_cast<uint32_t>(exits.size() - 1);
+}
+
+uint32_t WorldImageWriter::addItem(std::string_view name, std::string_view description,
+    uint32_t room, uint32_t container, uint32_t flags, int capacity) {
+    ItemRecord item{};
+    item.name = AddName(name);
+    item.description = AddString(description);
+    item.room = room;
+    item.container = container;
+    item.capacity = capacity;
+    item.flags = flags;
+    items.push_back(item);
+    return static_cast<uint32_t>(items.size() - 1);
+}
+
+uint32_t WorldImageWriter::addNpc(std::string_view name, std::string_view description, uint32_t room, uint32_t flags) {
+    PendingNpc npc{};
+    npc.record.name = AddName(name);
+    npc.record.description = AddString(description);
+    npc.record.requiredItem = AddString("");
+    npc.record.rewardItem = npc.record.requiredItem;
+    npc.record.rewardDescription = npc.record.requiredItem;
+    npc.record.room = room;
+    npc.record.flags = flags;
+    npc.record.dialogueRoot = NONE;
+    npc.record.behavior = static_cast<uint32_t>(NpcBehavior::STILL);
+    npc.record.announcement = npc.record.requiredItem;
+    npcs.push_back(std::move(npc));
+    return static_cast<uint32_t>(npcs.size() - 1);
+}
+
+void WorldImageWriter::setInteraction(uint32_t npc, std::string_view requiredItem, std::string_view rewardItem,
+    std::string_view rewardDescription) {
+    npcs[npc].record.requiredItem = AddString(requiredItem);
+    npcs[npc].record.rewardItem = AddString(rewardItem);
+    npcs[npc].record.rewardDescription = AddString(rewardDescription);
+}
+
+void WorldImageWriter::addDialogue(uint32_t npc, std::string_view line) {
+    npcs[npc].dialogues.push_back(AddString(line));
+}
+
+void WorldImageWriter::addResponse(uint32_t npc, std::string_view playerInput, std::string_view npcResponse) {
+    npcs[npc].responses.push_back(ResponseRecord{ AddString(playerInput), AddString(npcResponse) });
+}
+
+void WorldImageWriter::setDialogueRoot(uint32_t npc, uint32_t node) {
+    npcs[npc].record.dialogueRoot = node;
+}
+
+void WorldImageWriter::setBehavior(uint32_t npc, NpcBehavior behavior, uint32_t period, std::string_view announcement) {
+    npcs[npc].record.behavior = static_cast<uint32_t>(behavior);
+    npcs[npc].record.period = period;
+    npcs[npc].record.announcement = AddString(announcement);
+}
+
+void WorldImageWriter::addPatrolStop(uint32_t npc, uint32_t room) {
+    npcs[npc].patrolStops.push_back(room);
+}
+
+uint32_t WorldImageWriter::addDialogueNode(std::string_view question, uint32_t flags) {
+    PendingNode node{};
+    node.record.question = AddString(question);
+    node.record.flags = flags;
+    nodes.push_back(std::move(node));
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+void WorldImageWriter::addDialogueEffect(uint32_t node, DialogueAction action, std::string_view subject,
+    std::string_view text, int value) {
+    DialogueEffectRecord effect{};
+    effect.action = static_cast<uint32_t>(action);
+    effect.value = value;
+    effect.subject = AddString(subject);
+    effect.text = AddString(text);
+    nodes[node].effects.push_back(effect);
+}
+
+void WorldImageWriter::addDialogueEdge(uint32_t node, std::string_view answer, DialogueCondition condition,
+    std::string_view subject, int value, uint32_t target) {
+    DialogueEdgeRecord edge{};
+    edge.answer = AddString(answer);
+    edge.subject = AddString(subject);
+    edge.condition = static_cast<uint32_t>(condition);
+    edge.value = value;
+    edge.target = target;
+    nodes[node].edges.push_back(edge);
+}
+
+// ========== Output ==========
+
+bool WorldImageWriter::Write(const std::string& path, std::string& error) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        error = "cannot create " + path;
+        return false;
+    }
+    if (!Write(out, error)) {
+        return false;
+    }
+    if (!out.flush()) {
+        error = "failed writing " + path;
+        return false;
+    }
+    return true;
+}
+
+bool WorldImageWriter::Write(std::ostream& out, std::string& error) const {
+    if (rooms.empty() || startRoom >= rooms.size()) {
+        error = "a world needs at least one room and a starting room";
+        return false;
+    }
+
+    // Exits in graph order: by source room, then Direction
+    std::vector<PendingExit> sortedExits(exits);
+    std::stable_sort(sortedExits.begin(), sortedExits.end(),
+        [](const PendingExit& a, const PendingExit& b) {
+            return a.source != b.source ? a.source < b.source : a.record.direction < b.record.direction;
+        });
+
+    std::vector<RoomRecord> roomRecords(rooms);
+    std::vector<ExitRecord> exitRecords;
+    exitRecords.reserve(sortedExits.size());
+    for (const PendingExit& exit : sortedExits) {
+        if (exit.source >= rooms.size() || exit.record.destination >= rooms.size()) {
+            error = "exit leads from or to a missing room";
+            return false;
+        }
+        RoomRecord& room = roomRecords[exit.source];
+        if (room.exitCount == 0) {
+            room.firstExit = static_cast<uint32_t>(exitRecords.size());
+        }
+        else if (exitRecords.back().direction == exit.record.direction) {
+            error = "two exits leave a room in the same direction";
+            return false;
+        }
+        room.exitCount++;
+        exitRecords.push_back(exit.record);
+    }
+
+    // Exits arriving at each room (counting sort by destination)
+    for (const ExitRecord& exit : exitRecords) {
+        roomRecords[exit.destination].incomingCount++;
+    }
+    uint32_t nextIncoming = 0;
+    for (RoomRecord& room : roomRecords) {
+        room.firstIncoming = nextIncoming;
+        nextIncoming += room.incomingCount;
+    }
+    std::vector<uint32_t> incoming(exitRecords.size());
+    std::vector<uint32_t> nextSlot(roomRecords.size());
+    for (size_t i = 0; i < roomRecords.size(); i++) {
+        nextSlot[i] = roomRecords[i].firstIncoming;
+    }
+    for (size_t i = 0; i < exitRecords.size(); i++) {
+        incoming[nextSlot[exitRecords[i].destination]++] = static_cast<uint32_t>(i);
+    }
+
+    // Flatten dialogue lines, responses and patrol stops into shared arrays
+    std::vector<NpcRecord> npcRecords;
+    std::vector<StringRef> dialogues;
+    std::vector<ResponseRecord> responses;
+    std::vector<uint32_t> patrolStops;
+    npcRecords.reserve(npcs.size());
+    for (const PendingNpc& npc : npcs) {
+        NpcRecord record = npc.record;
+        record.firstDialogue = static_cast<uint32_t>(dialogues.size());
+        record.dialogueCount = static_cast<uint32_t>(npc.dialogues.size());
+        record.firstResponse = static_cast<uint32_t>(responses.size());
+        record.responseCount = static_cast<uint32_t>(npc.responses.size());
+        record.firstPatrolStop = static_cast<uint32_t>(patrolStops.size());
+        record.patrolStopCount = static_cast<uint32_t>(npc.patrolStops.size());
+        dialogues.insert(dialogues.end(), npc.dialogues.begin(), npc.dialogues.end());
+        responses.insert(responses.end(), npc.responses.begin(), npc.responses.end());
+        patrolStops.insert(patrolStops.end(), npc.patrolStops.begin(), npc.patrolStops.end());
+        for (uint32_t stop : npc.patrolStops) {
+            if (stop >= rooms.size()) {
+                error = "NPC patrols through a missing room";
+                return false;
+            }
+        }
+        npcRecords.push_back(record);
+    }
+
+    // The same for the effects and edges of dialogue nodes
+    std::vector<DialogueNodeRecord> nodeRecords;
+    std::vector<DialogueEffectRecord> effects;
+    std::vector<DialogueEdgeRecord> edges;
+    nodeRecords.reserve(nodes.size());
+    for (const PendingNode& node : nodes) {
+        DialogueNodeRecord record = node.record;
+        record.firstEffect = static_cast<uint32_t>(effects.size());
+        record.effectCount = static_cast<uint32_t>(node.effects.size());
+        record.firstEdge = static_cast<uint32_t>(edges.size());
+        record.edgeCount = static_cast<uint32_t>(node.edges.size());
+        effects.insert(effects.end(), node.effects.begin(), node.effects.end());
+        edges.insert(edges.end(), node.edges.begin(), node.edges.end());
+        nodeRecords.push_back(record);
+    }
+    for (const DialogueEdgeRecord& edge : edges) {
+        if (edge.target >= nodes.size()) {
+            error = "dialogue edge leads to a missing node";
+            return false;
+        }
+    }
+    for (const NpcRecord& npc : npcRecords) {
+        if (npc.dialogueRoot != NONE && npc.dialogueRoot >= nodes.size()) {
+            error = "NPC starts its dialogue at a missing node";
+            return false;
+        }
+    }
+
+    // The header is rewritten once the section offsets are known
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.startRoom = startRoom;
+    header.nameCount = static_cast<uint32_t>(lowerNames.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    uint64_t position = sizeof(header);
+    WriteRecords(out, position, header.rooms, roomRecords);
+    WriteRecords(out, position, header.exits, exitRecords);
+    WriteRecords(out, position, header.items, items);
+    WriteRecords(out, position, header.npcs, npcRecords);
+    WriteRecords(out, position, header.dialogues, dialogues);
+    WriteRecords(out, position, header.responses, responses);
+    WriteRecords(out, position, header.incoming, incoming);
+    WriteRecords(out, position, header.dialogueNodes, nodeRecords);
+    WriteRecords(out, position, header.dialogueEffects, effects);
+    WriteRecords(out, position, header.dialogueEdges, edges);
+    WriteRecords(out, position, header.patrolStops, patrolStops);
+    WriteRecords(out, position, header.strings, std::vector<char>(stringTable.begin(), stringTable.end()));
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!out) {
+        error = "failed writing the image";
+        return false;
+    }
+    return true;
+}
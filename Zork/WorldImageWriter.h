@@ -0,0 +1,97 @@
+#pragma once
+#include "GameEnums.h"
+#include "WorldImage.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Builds a world image record by record and writes it to disk.
+ * Identical strings are stored once. Records may be added in any order as
+ * long as a container is added before the items inside it. When the file is
+ * written, exits are sorted into graph order and the per-room lists of
+ * arriving exits are computed, so the game does not have to.
+ */
+class WorldImageWriter {
+private:
+    struct PendingExit {
+        uint32_t source;
+        WorldFormat::ExitRecord record;
+    };
+
+    struct PendingNpc {
+        WorldFormat::NpcRecord record;
+        std::vector<WorldFormat::StringRef> dialogues;
+        std::vector<WorldFormat::ResponseRecord> responses;
+        std::vector<uint32_t> patrolStops;
+    };
+
+    struct PendingNode {
+        WorldFormat::DialogueNodeRecord record;
+        std::vector<WorldFormat::DialogueEffectRecord> effects;
+        std::vector<WorldFormat::DialogueEdgeRecord> edges;
+    };
+
+    std::string stringTable;
+    std::unordered_map<std::string, WorldFormat::StringRef> stringRefs;
+    std::unordered_set<std::string> lowerNames;    // Distinct entity names
+    size_t stringBytesAdded;                       // Before deduplication
+
+    std::vector<WorldFormat::RoomRecord> rooms;
+    std::vector<PendingExit> exits;
+    std::vector<WorldFormat::ItemRecord> items;
+    std::vector<PendingNpc> npcs;
+    std::vector<PendingNode> nodes;
+    uint32_t startRoom;
+
+    WorldFormat::StringRef AddString(std::string_view text);
+    WorldFormat::StringRef AddName(std::string_view name);
+
+public:
+    WorldImageWriter();
+
+    uint32_t addRoom(std::string_view name, std::string_view description, bool isDark);
+    void setStartRoom(uint32_t room) { startRoom = room; }
+
+    // An empty key name leaves the exit unlocked
+    uint32_t addExit(uint32_t source, uint32_t destination, Direction direction,
+        std::string_view name, std::string_view description, std::string_view keyName);
+
+    // Pass WorldFormat::NONE for whichever of room/container does not apply
+    uint32_t addItem(std::string_view name, std::string_view description,
+        uint32_t room, uint32_t container, uint32_t flags, int capacity);
+
+    uint32_t addNpc(std::string_view name, std::string_view description, uint32_t room, uint32_t flags);
+    // An empty reward description leaves the generic one
+    void setInteraction(uint32_t npc, std::string_view requiredItem, std::string_view rewardItem,
+        std::string_view rewardDescription = std::string_view());
+    void addDialogue(uint32_t npc, std::string_view line);
+    void addResponse(uint32_t npc, std::string_view playerInput, std::string_view npcResponse);
+    void setDialogueRoot(uint32_t npc, uint32_t node);
+    // An empty announcement says nothing
+    void setBehavior(uint32_t npc, NpcBehavior behavior, uint32_t period, std::string_view announcement);
+    void addPatrolStop(uint32_t npc, uint32_t room);
+
+    // Dialogue nodes are numbered in the order added; edges may lead to
+    // nodes added later, as long as they exist when the image is written
+    uint32_t addDialogueNode(std::string_view question, uint32_t flags);
+    void addDialogueEffect(uint32_t node, DialogueAction action, std::string_view subject,
+        std::string_view text, int value);
+    void addDialogueEdge(uint32_t node, std::string_view answer, DialogueCondition condition,
+        std::string_view subject, int value, uint32_t target);
+
+    size_t getRoomCount() const { return rooms.size(); }
+    size_t getItemCount() const { return items.size(); }
+    size_t getNpcCount() const { return npcs.size(); }
+    size_t getExitCount() const { return exits.size(); }
+    size_t getDialogueNodeCount() const { return nodes.size(); }
+    size_t getStringBytes() const { return stringTable.size(); }
+    size_t getStringBytesAdded() const { return stringBytesAdded; }
+
+    bool Write(const std::string& path, std::string& error) const;
+    bool Write(std::ostream& out, std::string& error) const;
+};
@@ -0,0 +1,124 @@
+#include "WorldTemplate.h"
+#include "World.h"
+#include "WorldImageWriter.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+    bool ByContainer(const WorldDelta::Contents& entry, uint32_t container) {
+        return entry.container < container;
+    }
+}
+
+std::shared_ptr<const WorldTemplate> WorldTemplate::Stock() {
+    static const std::shared_ptr<const WorldTemplate> stock = []() {
+        World world;
+        world.InitializeWorld();
+        WorldImageWriter writer;
+        world.SaveWorld(writer);
+
+        std::shared_ptr<WorldTemplate> result(new WorldTemplate());
+        std::ostringstream bytes(std::ios::binary);
+        std::string error;
+        if (!writer.Write(bytes, error) ||
+            !result->image.Load(bytes.str(), "the built-in world", error)) {
+            // The built-in world is part of the program, so this is a bug
+            std::cerr << "error: " << error << "\n";
+            std::abort();
+        }
+        result->Prepare();
+        return std::shared_ptr<const WorldTemplate>(std::move(result));
+    }();
+    return stock;
+}
+
+std::shared_ptr<const WorldTemplate> WorldTemplate::Open(const std::string& path, std::string& error) {
+    std::shared_ptr<WorldTemplate> result(new WorldTemplate());
+    if (!result->image.Open(path, error)) {
+        return nullptr;
+    }
+    result->Prepare();
+    return result;
+}
+
+void WorldTemplate::Prepare() {
+    using namespace WorldFormat;
+
+    std::shared_ptr<DialogueGraph> conversations = std::make_shared<DialogueGraph>();
+    conversations->Load(image);
+    dialogue = std::move(conversations);
+
+    // Rooms first, so the graph finds rooms of the same length by record
+    names.reserve(image.getNameCount());
+    graph.Build(image, names);
+    for (size_t i = 0; i < image.getExitCount(); i++) {
+        names.intern(image.getString(image.getExit(i).name));
+    }
+    for (size_t i = 0; i < image.getItemCount(); i++) {
+        names.intern(image.getString(image.getItem(i).name));
+    }
+    for (size_t i = 0; i < image.getNpcCount(); i++) {
+        names.intern(image.getString(image.getNpc(i).name));
+    }
+
+    // Where everything starts, read off the records without building the
+    // world: a World puts items in record order into their room or
+    // container, then each NPC into its room, and Open() has already
+    // checked that every record points at one that exists
+    std::vector<uint32_t> roomCounts(image.getRoomCount());
+    std::vector<uint32_t> containerCounts(image.getItemCount());
+    for (size_t i = 0; i < image.getItemCount(); i++) {
+        const ItemRecord& record = image.getItem(i);
+        if (record.room != NONE) {
+            roomCounts[record.room]++;
+        }
+        else {
+            containerCounts[record.container]++;
+        }
+    }
+    for (size_t i = 0; i < image.getNpcCount(); i++) {
+        roomCounts[image.getNpc(i).room]++;
+    }
+
+    // Sorted by container reference: rooms, then items
+    std::vector<uint32_t> roomEntries(roomCounts.size());
+    std::vector<uint32_t> containerEntries(containerCounts.size());
+    contents.clear();
+    for (size_t room = 0; room < roomCounts.size(); room++) {
+        if (roomCounts[room] != 0) {
+            roomEntries[room] = static_cast<uint32_t>(contents.size());
+            contents.push_back(WorldDelta::Contents{ WorldDelta::ROOM | static_cast<uint32_t>(room), {} });
+            contents.back().entities.reserve(roomCounts[room]);
+        }
+    }
+    for (size_t item = 0; item < containerCounts.size(); item++) {
+        if (containerCounts[item] != 0) {
+            containerEntries[item] = static_cast<uint32_t>(contents.size());
+            contents.push_back(WorldDelta::Contents{ WorldDelta::ITEM | static_cast<uint32_t>(item), {} });
+            contents.back().entities.reserve(containerCounts[item]);
+        }
+    }
+
+    for (size_t i = 0; i < image.getItemCount(); i++) {
+        const ItemRecord& record = image.getItem(i);
+        uint32_t entry = record.room != NONE ? roomEntries[record.room] : containerEntries[record.container];
+        contents[entry].entities.push_back(WorldDelta::ITEM | static_cast<uint32_t>(i));
+    }
+
+    npcStates.resize(image.getNpcCount());
+    for (size_t i = 0; i < image.getNpcCount(); i++) {
+        const NpcRecord& record = image.getNpc(i);
+        contents[roomEntries[record.room]].entities.push_back(WorldDelta::NPC | static_cast<uint32_t>(i));
+        npcStates[i] = NPC::StartingState((record.flags & NPC_ENEMY) != 0,
+            (record.flags & NPC_IMPORTANT_INFO) != 0, (record.flags & NPC_PREVENT_REINTERACTION) != 0);
+    }
+}
+
+const std::vector<uint32_t>& WorldTemplate::getContents(uint32_t container) const {
+    static const std::vector<uint32_t> none;
+    auto it = std::lower_bound(contents.begin(), contents.end(), container, ByContainer);
+    return it != contents.end() && it->container == container ? it->entities : none;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "DialogueGraph.h"
+#include "NPC.h"
+#include "WorldDelta.h"
+#include "WorldGraph.h"
+#include "WorldImage.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * An immutable world shared by every session that plays it.
+ * Holds the compiled image whose records the sessions build their rooms,
+ * items and NPCs from (borrowing the text), the room graph they route over,
+ * and the starting placement and NPC states that each session's WorldDelta
+ * is measured against, read straight off the image records so opening a
+ * world builds no entities. Sessions keep the template alive through
+ * shared_ptr; nothing in it changes once Stock() or Open() has returned.
+ */
+class WorldTemplate {
+private:
+    WorldImage image;
+    std::shared_ptr<const DialogueGraph> dialogue;    // Read from the image once for every session
+    NameTable names;        // Lowercase names of every entity in the image
+    WorldGraph graph;
+    std::vector<WorldDelta::Contents> contents;   // Non-empty containers, by container reference
+    std::vector<NPC::State> npcStates;            // By NPC record
+
+    WorldTemplate() = default;
+
+    // Reads the dialogue, the names, the graph and the starting contents and
+    // NPC states off the image
+    void Prepare();
+
+public:
+    WorldTemplate(const WorldTemplate&) = delete;
+    WorldTemplate& operator=(const WorldTemplate&) = delete;
+
+    // The world of World::InitializeWorld, compiled into an image once per process
+    static std::shared_ptr<const WorldTemplate> Stock();
+
+    // A compiled world image file; nullptr with 'error' set when it does not load
+    static std::shared_ptr<const WorldTemplate> Open(const std::string& path, std::string& error);
+
+    const WorldImage& getImage() const { return image; }
+    const std::shared_ptr<const DialogueGraph>& getDialogue() const { return dialogue; }
+    const NameTable& getNames() const { return names; }
+    const WorldGraph& getGraph() const { return graph; }
+
+    // Entities a container starts with, empty for none
+    const std::vector<uint32_t>& getContents(uint32_t container) const;
+    const std::vector<WorldDelta::Contents>& getAllContents() const { return contents; }
+
+    const NPC::State& getNpcState(uint32_t npc) const { return npcStates[npc]; }
+};